@@ -14,8 +14,8 @@ DESCRIPTION = """Fast Downward driver script.
 
 Input files can be either a PDDL problem file (with an optional PDDL domain
 file), in which case the driver runs both planner components (translate and
-search), or a SAS+ translator output file, in which case the driver runs just
-the search component. You can override this default behaviour by selecting
+search), or a SAS+ translator output file in text or binary format, in which
+case the driver runs just the search component. You can override this default behaviour by selecting
 components manually with the flags below. The first component to be run
 determines the required input files:
 
@@ -90,6 +90,8 @@ Examples:
 
 COMPONENTS_PLUS_OVERALL = ["translate", "search", "validate", "overall"]
 DEFAULT_SAS_FILE = "output.sas"
+# First bytes of binary task files (see --binary-task).
+BINARY_TASK_MAGIC = b"\x7fFDTASK\n"
 
 
 """
@@ -185,6 +187,10 @@ def _check_mutex_args(parser, args, required=False):
 
 
 def _looks_like_search_input(filename):
+    with open(filename, "rb") as input_file:
+        first_bytes = input_file.read(len(BINARY_TASK_MAGIC))
+    if first_bytes == BINARY_TASK_MAGIC:
+        return True
     with open(filename) as input_file:
         first_line = next(input_file, "").rstrip()
     return first_line == "begin_version"
@@ -277,6 +283,8 @@ def _set_translator_output_options(parser, args):
 
     args.search_input = args.sas_file
     args.translate_options += ["--sas-file", args.search_input]
+    if args.binary_task:
+        args.translate_options.append("--binary-task")
 
 
 def _get_time_limit_in_seconds(limit, parser):
@@ -412,6 +420,11 @@ def parse_args():
         "--keep-sas-file", action="store_true",
         help="keep translator output file (implied by --sas-file, default: "
             "delete file if translator and search component are active)")
+    driver_other.add_argument(
+        "--binary-task", action="store_true",
+        help="let the translator write its output file in the binary task "
+            "format, which the search component maps into memory instead "
+            "of parsing it")
 
     driver_other.add_argument(
         "--portfolio", metavar="FILE",
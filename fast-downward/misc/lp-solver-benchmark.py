@@ -0,0 +1,153 @@
+#! /usr/bin/env python
+# -*- coding: utf-8 -*-
+
+"""
+Compare the LP solve throughput of the embedded simplex solver and the
+solvers accessed through OSI on the LPs of the operator-counting
+heuristic.
+
+Every configuration is run with every solver on every task through the
+driver script. The script prints the number of LP solves, the total and
+average solve time, the number of solves per second of solve time and
+the number of expansions, which should agree between the solvers up to
+tie-breaking among optimal LP solutions.
+
+OSI solvers are only available in builds with LP support. The embedded
+solver is available in every build, so for example
+
+    misc/lp-solver-benchmark.py --solvers embedded clp -- task.pddl
+
+compares both solvers in the default release build.
+"""
+
+from __future__ import print_function
+
+import argparse
+import os
+import re
+import subprocess
+import sys
+
+REPO_ROOT_DIR = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+DRIVER = os.path.join(REPO_ROOT_DIR, "fast-downward.py")
+
+# With verbosity=verbose, the heuristic prints its LP statistics.
+CONFIGS = {
+    "seq": "[state_equation_constraints()]",
+    "lmcut": "[lmcut_constraints()]",
+    "seq-lmcut": "[state_equation_constraints(), lmcut_constraints()]",
+    "pho": "[pho_constraints(patterns=systematic(2))]",
+}
+
+PATTERNS = {
+    "solves": re.compile(r"^LP solves: (\d+)$", re.M),
+    "solve_time": re.compile(r"^LP solve time: (.+)s \(average", re.M),
+    "iterations": re.compile(r"^LP iterations: (\d+) ", re.M),
+    "expansions": re.compile(r"^Expanded (\d+) state\(s\)\.$", re.M),
+}
+
+
+def parse_args():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    parser.add_argument(
+        "tasks", nargs="+", metavar="TASK",
+        help="PDDL problem files or translator output files")
+    parser.add_argument(
+        "--build", default="release",
+        help="planner build passed to the driver (default: %(default)s)")
+    parser.add_argument(
+        "--solvers", nargs="+", default=["embedded", "clp"],
+        help="values of the lpsolver option to compare "
+             "(default: %(default)s)")
+    parser.add_argument(
+        "--configs", nargs="+", default=sorted(CONFIGS),
+        choices=sorted(CONFIGS),
+        help="operator-counting configurations (default: all)")
+    parser.add_argument(
+        "--time-limit", default="5m",
+        help="search time limit per run (default: %(default)s)")
+    return parser.parse_args()
+
+
+def parse_last(pattern, output, convert):
+    matches = pattern.findall(output)
+    if not matches:
+        return None
+    return convert(matches[-1])
+
+
+def run(args, task, config, solver):
+    search = "astar(operatorcounting({}, lpsolver={}, verbosity=verbose))".format(
+        CONFIGS[config], solver)
+    cmd = [sys.executable, DRIVER, "--build", args.build,
+           "--search-time-limit", args.time_limit,
+           task, "--search", search]
+    process = subprocess.Popen(
+        cmd, stdout=subprocess.PIPE, stderr=subprocess.STDOUT,
+        universal_newlines=True)
+    output, _ = process.communicate()
+    return {
+        "solves": parse_last(PATTERNS["solves"], output, int),
+        "solve_time": parse_last(PATTERNS["solve_time"], output, float),
+        "iterations": parse_last(PATTERNS["iterations"], output, int),
+        "expansions": parse_last(PATTERNS["expansions"], output, int),
+    }
+
+
+def format_value(value, spec="{}"):
+    if value is None:
+        return "-"
+    return spec.format(value)
+
+
+def main():
+    args = parse_args()
+    columns = ["task", "config", "solver", "solves", "time (s)",
+               "solves/s", "iterations/solve", "expansions"]
+    print("\t".join(columns))
+    totals = dict((solver, [0, 0.0]) for solver in args.solvers)
+    for task in args.tasks:
+        for config in args.configs:
+            results = dict(
+                (solver, run(args, task, config, solver))
+                for solver in args.solvers)
+            for solver in args.solvers:
+                result = results[solver]
+                solves = result["solves"]
+                time = result["solve_time"]
+                throughput = None
+                iterations = None
+                if solves and time:
+                    throughput = solves / time
+                if solves and result["iterations"] is not None:
+                    iterations = result["iterations"] / float(solves)
+                if solves and time is not None:
+                    totals[solver][0] += solves
+                    totals[solver][1] += time
+                print("\t".join([
+                    os.path.basename(task), config, solver,
+                    format_value(solves), format_value(time, "{:.3f}"),
+                    format_value(throughput, "{:.0f}"),
+                    format_value(iterations, "{:.1f}"),
+                    format_value(result["expansions"])]))
+            failed = [solver for solver in args.solvers
+                      if results[solver]["solves"] is None]
+            if failed:
+                print("# {} {}: no LP statistics for {}".format(
+                    task, config, ", ".join(failed)))
+            expansions = set(
+                results[solver]["expansions"] for solver in args.solvers
+                if solver not in failed)
+            if len(expansions) > 1:
+                print("# {} {}: expansions differ between solvers".format(
+                    task, config))
+    print()
+    for solver in args.solvers:
+        solves, time = totals[solver]
+        throughput = format_value(solves / time if time else None, "{:.0f}")
+        print("{}: {} solves in {:.3f}s, {} solves/s".format(
+            solver, solves, time, throughput))
+
+
+if __name__ == "__main__":
+    main()
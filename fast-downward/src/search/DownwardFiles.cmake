@@ -68,6 +68,7 @@ fast_downward_plugin(
         per_state_information
         per_task_information
         plan_manager
+        plan_stream
         plugin
         pruning_method
         search_engine
@@ -146,6 +147,7 @@ fast_downward_plugin(
     HELP "Open list that chooses an entry randomly with probability epsilon"
     SOURCES
         open_lists/epsilon_greedy_open_list
+    DEPENDS INDEXED_HEAP
 )
 
 fast_downward_plugin(
@@ -185,6 +187,14 @@ fast_downward_plugin(
     DEPENDENCY_ONLY
 )
 
+fast_downward_plugin(
+    NAME INDEXED_HEAP
+    HELP "4-ary min-heap with decrease-key and removal by ID"
+    SOURCES
+        algorithms/indexed_heap
+    DEPENDENCY_ONLY
+)
+
 fast_downward_plugin(
     NAME INT_HASH_SET
     HELP "Hash set storing non-negative integers"
@@ -337,6 +347,15 @@ fast_downward_plugin(
     DEPENDS STUBBORN_SETS TASK_PROPERTIES
 )
 
+fast_downward_plugin(
+    NAME STRUCTURAL_SYMMETRIES
+    HELP "Structural symmetries of the task for orbit search"
+    SOURCES
+        structural_symmetries/graph_automorphisms
+        structural_symmetries/structural_symmetries
+    DEPENDS TASK_PROPERTIES
+)
+
 fast_downward_plugin(
     NAME SEARCH_COMMON
     HELP "Basic classes used for all search engines"
@@ -351,7 +370,7 @@ fast_downward_plugin(
     HELP "Eager search algorithm"
     SOURCES
         search_engines/eager_search
-    DEPENDS NULL_PRUNING_METHOD ORDERED_SET SUCCESSOR_GENERATOR
+    DEPENDS NULL_PRUNING_METHOD ORDERED_SET STRUCTURAL_SYMMETRIES SUCCESSOR_GENERATOR
     DEPENDENCY_ONLY
 )
 
@@ -439,8 +458,11 @@ fast_downward_plugin(
     NAME LP_SOLVER
     HELP "Interface to an LP solver"
     SOURCES
+        lp/coin_solver_interface
         lp/lp_internals
         lp/lp_solver
+        lp/simplex_solver
+        lp/solver_interface
     DEPENDENCY_ONLY
 )
 
@@ -501,6 +523,14 @@ fast_downward_plugin(
     DEPENDS ADDITIVE_HEURISTIC TASK_PROPERTIES
 )
 
+fast_downward_plugin(
+    NAME LAYERED_FF_HEURISTIC
+    HELP "The FF heuristic computed on a layered relaxed planning graph"
+    SOURCES
+        heuristics/layered_ff_heuristic
+    DEPENDS RELAXATION_HEURISTIC TASK_PROPERTIES
+)
+
 fast_downward_plugin(
     NAME GOAL_COUNT_HEURISTIC
     HELP "The goal-counting heuristic"
@@ -537,8 +567,10 @@ fast_downward_plugin(
     NAME CORE_TASKS
     HELP "Core task transformations"
     SOURCES
+        tasks/binary_root_task
         tasks/cost_adapted_task
         tasks/delegating_task
+        tasks/frozen_task
         tasks/root_task
     CORE_PLUGIN
 )
@@ -607,11 +639,13 @@ fast_downward_plugin(
         cegar/abstract_search
         cegar/abstract_state
         cegar/additive_cartesian_heuristic
+        cegar/adjacency_lists
         cegar/cartesian_heuristic_function
         cegar/cartesian_set
         cegar/cegar
         cegar/cost_saturation
         cegar/refinement_hierarchy
+        cegar/shortest_paths
         cegar/split_selector
         cegar/subtask_generators
         cegar/transition
@@ -740,6 +774,7 @@ fast_downward_plugin(
         potentials/potential_heuristic
         potentials/potential_max_heuristic
         potentials/potential_optimizer
+        potentials/quantized_potentials
         potentials/sample_based_potential_heuristics
         potentials/single_potential_heuristics
         potentials/util
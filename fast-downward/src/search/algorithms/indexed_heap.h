@@ -0,0 +1,176 @@
+#ifndef ALGORITHMS_INDEXED_HEAP_H
+#define ALGORITHMS_INDEXED_HEAP_H
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+#include <vector>
+
+/*
+  Min-heap of values with priorities. Every value has a non-negative
+  integer ID, given by ValueIDs::get_id(value), and the heap can keep
+  track of the position of every ID. Then values can be moved to a
+  smaller priority ("decrease-key") and removed by ID, and each ID can
+  only be contained once.
+
+  The heap is 4-ary: the children of position i are at positions
+  4i+1, ..., 4i+4. This halves the height compared to a binary heap and
+  the children of a node usually share a cache line, which makes
+  pop() cheaper.
+
+  The index of positions is passed to the constructor and grows with the
+  largest ID, so IDs should be dense. Several heaps can share one index
+  if their IDs are disjoint. Without an index, IDs are ignored and
+  values can only be removed by position.
+*/
+namespace indexed_heap {
+const int ARITY = 4;
+const int NOT_CONTAINED = -1;
+
+template<typename Priority, typename Value, typename ValueIDs>
+class IndexedHeap {
+    struct Node {
+        Priority priority;
+        Value value;
+
+        Node(const Priority &priority, const Value &value)
+            : priority(priority), value(value) {
+        }
+    };
+
+    std::vector<Node> nodes;
+    std::vector<int> *positions;
+
+    void place(int pos, Node &&node) {
+        if (positions)
+            (*positions)[ValueIDs::get_id(node.value)] = pos;
+        nodes[pos] = std::move(node);
+    }
+
+    void sift_up(int pos) {
+        Node node = std::move(nodes[pos]);
+        while (pos > 0) {
+            int parent_pos = (pos - 1) / ARITY;
+            if (!(node.priority < nodes[parent_pos].priority))
+                break;
+            place(pos, std::move(nodes[parent_pos]));
+            pos = parent_pos;
+        }
+        place(pos, std::move(node));
+    }
+
+    void sift_down(int pos) {
+        int num_nodes = nodes.size();
+        Node node = std::move(nodes[pos]);
+        while (true) {
+            int first_child_pos = ARITY * pos + 1;
+            if (first_child_pos >= num_nodes)
+                break;
+            int last_child_pos = std::min(first_child_pos + ARITY, num_nodes);
+            int min_child_pos = first_child_pos;
+            for (int child_pos = first_child_pos + 1; child_pos < last_child_pos;
+                 ++child_pos) {
+                if (nodes[child_pos].priority < nodes[min_child_pos].priority)
+                    min_child_pos = child_pos;
+            }
+            if (!(nodes[min_child_pos].priority < node.priority))
+                break;
+            place(pos, std::move(nodes[min_child_pos]));
+            pos = min_child_pos;
+        }
+        place(pos, std::move(node));
+    }
+
+public:
+    explicit IndexedHeap(std::vector<int> *positions = nullptr)
+        : positions(positions) {
+    }
+
+    bool empty() const {
+        return nodes.empty();
+    }
+
+    int size() const {
+        return nodes.size();
+    }
+
+    void clear() {
+        if (positions) {
+            for (const Node &node : nodes)
+                (*positions)[ValueIDs::get_id(node.value)] = NOT_CONTAINED;
+        }
+        nodes.clear();
+    }
+
+    bool contains(int id) const {
+        assert(positions && id >= 0);
+        return id < static_cast<int>(positions->size()) &&
+               (*positions)[id] != NOT_CONTAINED;
+    }
+
+    void push(const Priority &priority, const Value &value) {
+        if (positions) {
+            int id = ValueIDs::get_id(value);
+            assert(!contains(id));
+            if (id >= static_cast<int>(positions->size()))
+                positions->resize(id + 1, NOT_CONTAINED);
+        }
+        int pos = nodes.size();
+        nodes.emplace_back(priority, value);
+        sift_up(pos);
+    }
+
+    /*
+      Push the value if its ID is not contained. Otherwise, replace the
+      contained value and its priority if the given priority is smaller.
+      Return true if the heap changed.
+    */
+    bool push_or_decrease(const Priority &priority, const Value &value) {
+        int id = ValueIDs::get_id(value);
+        if (!contains(id)) {
+            push(priority, value);
+            return true;
+        }
+        int pos = (*positions)[id];
+        if (!(priority < nodes[pos].priority))
+            return false;
+        nodes[pos].priority = priority;
+        nodes[pos].value = value;
+        sift_up(pos);
+        return true;
+    }
+
+    // Remove the value at the given position and return it.
+    Value remove_at(int pos) {
+        assert(pos >= 0 && pos < size());
+        Value result = std::move(nodes[pos].value);
+        if (positions)
+            (*positions)[ValueIDs::get_id(result)] = NOT_CONTAINED;
+        int last_pos = nodes.size() - 1;
+        if (pos != last_pos) {
+            bool moves_up = nodes[last_pos].priority < nodes[pos].priority;
+            place(pos, std::move(nodes[last_pos]));
+            nodes.pop_back();
+            if (moves_up)
+                sift_up(pos);
+            else
+                sift_down(pos);
+        } else {
+            nodes.pop_back();
+        }
+        return result;
+    }
+
+    Value pop() {
+        assert(!empty());
+        return remove_at(0);
+    }
+
+    Value remove(int id) {
+        assert(contains(id));
+        return remove_at((*positions)[id]);
+    }
+};
+}
+
+#endif
@@ -73,14 +73,14 @@ public:
     std::unique_ptr<Solution> extract_solution(int init_id, int goal_id) const;
     void update_goal_distances(const Solution &solution);
     int astar_search(
-        const std::vector<Transitions> &transitions,
+        const TransitionLists &transitions,
         const Goals &goals);
 
 public:
     explicit AbstractSearch(const std::vector<int> &operator_costs);
 
     std::unique_ptr<Solution> find_solution(
-        const std::vector<Transitions> &transitions,
+        const TransitionLists &transitions,
         int init_id,
         const Goals &goal_ids);
     int get_h_value(int state_id) const;
@@ -88,7 +88,7 @@ public:
 };
 
 std::vector<int> compute_distances(
-    const std::vector<Transitions> &transitions,
+    const TransitionLists &transitions,
     const std::vector<int> &costs,
     const std::unordered_set<int> &start_ids);
 }
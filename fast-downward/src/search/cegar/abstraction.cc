@@ -19,8 +19,11 @@
 using namespace std;
 
 namespace cegar {
-Abstraction::Abstraction(const shared_ptr<AbstractTask> &task, bool debug)
-    : transition_system(utils::make_unique_ptr<TransitionSystem>(TaskProxy(*task).get_operators())),
+Abstraction::Abstraction(
+    const shared_ptr<AbstractTask> &task,
+    const tasks::FrozenTask &frozen_task,
+    bool debug)
+    : transition_system(utils::make_unique_ptr<TransitionSystem>(frozen_task)),
       concrete_initial_state(TaskProxy(*task).get_initial_state()),
       goal_facts(task_properties::get_fact_pairs(TaskProxy(*task).get_goals())),
       refinement_hierarchy(utils::make_unique_ptr<RefinementHierarchy>(task)),
@@ -10,6 +10,10 @@
 #include <memory>
 #include <vector>
 
+namespace tasks {
+class FrozenTask;
+}
+
 namespace cegar {
 class AbstractState;
 class RefinementHierarchy;
@@ -42,7 +46,11 @@ class Abstraction {
     void initialize_trivial_abstraction(const std::vector<int> &domain_sizes);
 
 public:
-    Abstraction(const std::shared_ptr<AbstractTask> &task, bool debug);
+    // The transition system is built from frozen_task, a frozen copy of task.
+    Abstraction(
+        const std::shared_ptr<AbstractTask> &task,
+        const tasks::FrozenTask &frozen_task,
+        bool debug);
     ~Abstraction();
 
     Abstraction(const Abstraction &) = delete;
@@ -32,7 +32,9 @@ static vector<CartesianHeuristicFunction> generate_heuristic_functions(
         opts.get<double>("max_time"),
         opts.get<bool>("use_general_costs"),
         static_cast<PickSplit>(opts.get<int>("pick")),
+        static_cast<SearchStrategy>(opts.get<int>("search_strategy")),
         *rng,
+        opts.get<int>("threads"),
         opts.get<bool>("debug"));
     return cost_saturation.generate_heuristic_functions(
         opts.get<shared_ptr<AbstractTask>>("transform"));
@@ -50,9 +52,10 @@ int AdditiveCartesianHeuristic::compute_heuristic(const GlobalState &global_stat
 }
 
 int AdditiveCartesianHeuristic::compute_heuristic(const State &state) {
+    const vector<int> &values = state.get_values();
     int sum_h = 0;
     for (const CartesianHeuristicFunction &function : heuristic_functions) {
-        int value = function.get_value(state);
+        int value = function.get_value(values);
         assert(value >= 0);
         if (value == INF)
             return DEAD_END;
@@ -135,10 +138,35 @@ static shared_ptr<Heuristic> _parse(OptionParser &parser) {
     pick_strategies.push_back("MAX_HADD");
     parser.add_enum_option(
         "pick", pick_strategies, "split-selection strategy", "MAX_REFINED");
+    vector<string> search_strategies;
+    vector<string> search_strategies_docs;
+    search_strategies.push_back("ASTAR");
+    search_strategies_docs.push_back(
+        "run A* from scratch to find each abstract solution");
+    search_strategies.push_back("INCREMENTAL");
+    search_strategies_docs.push_back(
+        "maintain goal distances and shortest paths across refinements, "
+        "repair them locally after each split and follow the shortest "
+        "paths to obtain abstract solutions");
+    parser.add_enum_option(
+        "search_strategy",
+        search_strategies,
+        "strategy for finding abstract solutions during refinement",
+        "ASTAR",
+        search_strategies_docs);
     parser.add_option<bool>(
         "use_general_costs",
         "allow negative costs in cost partitioning",
         "true");
+    parser.add_option<int>(
+        "threads",
+        "number of threads for building abstractions. With more than one "
+        "thread, the abstractions for all subtasks are refined independently "
+        "and in parallel for the original operator costs, each using an equal "
+        "share of max_states and max_transitions. Afterwards, they are "
+        "combined by saturated cost partitioning in the order of the subtasks.",
+        "1",
+        Bounds("1", "infinity"));
     parser.add_option<bool>(
         "debug",
         "print debugging output",
@@ -0,0 +1,232 @@
+#ifndef CEGAR_ADJACENCY_LISTS_H
+#define CEGAR_ADJACENCY_LISTS_H
+
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+namespace cegar {
+/*
+  Store one list of values per abstract state.
+
+  Each list occupies a block of memory. Blocks with up to
+  MAX_SMALL_CAPACITY values have a power-of-two capacity and are carved
+  from slabs of SLAB_CAPACITY values. Released small blocks are kept in
+  one free list per capacity and reused for later lists of the same
+  capacity, so most abstract states need no allocation of their own.
+  Larger blocks are allocated individually. A list that outgrows its
+  block moves to a block 1.5 times as large, and a list that shrinks to
+  a quarter of its capacity moves to a smaller block. Compared to a
+  vector of vectors, this saves a vector header and an allocation per
+  list, bounds the unused capacity and never copies more than one list
+  at a time.
+
+  Adding values to a list can move it, which invalidates all ranges and
+  references into this list, but not into other lists.
+*/
+template<typename Value>
+class AdjacencyLists {
+    static_assert(std::is_trivially_copyable<Value>::value &&
+                  std::is_trivially_destructible<Value>::value,
+                  "AdjacencyLists only stores trivially copyable values.");
+
+    static const int MAX_SMALL_CAPACITY = 64;
+    static const int SLAB_CAPACITY = 4096;
+
+    struct Block {
+        Value *data;
+        int size;
+        int capacity;
+
+        Block()
+            : data(nullptr), size(0), capacity(0) {
+        }
+    };
+
+    std::allocator<Value> allocator;
+    std::vector<Block> blocks;
+    std::vector<Value *> slabs;
+    // Number of values at the end of the last slab that are still unused.
+    int slab_remaining;
+    // Released small blocks, indexed by the logarithm of the capacity.
+    std::vector<std::vector<Value *>> free_blocks;
+    std::size_t num_large_block_values;
+
+    static int get_capacity_class(int capacity) {
+        int capacity_class = 0;
+        while ((1 << capacity_class) < capacity)
+            ++capacity_class;
+        return capacity_class;
+    }
+
+    static int get_block_capacity(int min_capacity) {
+        if (min_capacity <= MAX_SMALL_CAPACITY)
+            return 1 << get_capacity_class(min_capacity);
+        return min_capacity;
+    }
+
+    void add_free_block(Value *data, int capacity) {
+        int capacity_class = get_capacity_class(capacity);
+        assert((1 << capacity_class) == capacity);
+        free_blocks[capacity_class].push_back(data);
+    }
+
+    Value *allocate_small_block(int capacity) {
+        std::vector<Value *> &free = free_blocks[get_capacity_class(capacity)];
+        if (!free.empty()) {
+            Value *data = free.back();
+            free.pop_back();
+            return data;
+        }
+        if (slab_remaining < capacity) {
+            // Split the rest of the last slab into free blocks.
+            Value *rest = slabs.empty() ? nullptr : slabs.back() + SLAB_CAPACITY - slab_remaining;
+            while (slab_remaining > 0) {
+                int piece = 1 << (get_capacity_class(slab_remaining + 1) - 1);
+                add_free_block(rest, piece);
+                rest += piece;
+                slab_remaining -= piece;
+            }
+            slabs.push_back(allocator.allocate(SLAB_CAPACITY));
+            slab_remaining = SLAB_CAPACITY;
+        }
+        Value *data = slabs.back() + SLAB_CAPACITY - slab_remaining;
+        slab_remaining -= capacity;
+        return data;
+    }
+
+    Value *allocate_block(int capacity) {
+        if (capacity <= MAX_SMALL_CAPACITY)
+            return allocate_small_block(capacity);
+        num_large_block_values += capacity;
+        return allocator.allocate(capacity);
+    }
+
+    void release_block(Value *data, int capacity) {
+        if (capacity == 0) {
+            return;
+        } else if (capacity <= MAX_SMALL_CAPACITY) {
+            add_free_block(data, capacity);
+        } else {
+            num_large_block_values -= capacity;
+            allocator.deallocate(data, capacity);
+        }
+    }
+
+    void move_to_new_block(Block &block, int capacity) {
+        assert(block.size <= capacity);
+        Value *data = allocate_block(capacity);
+        std::uninitialized_copy(block.data, block.data + block.size, data);
+        release_block(block.data, block.capacity);
+        block.data = data;
+        block.capacity = capacity;
+    }
+
+public:
+    // Values of a single list. Only valid until values are added to it.
+    class Range {
+        const Value *first;
+        const Value *last;
+    public:
+        Range(const Value *first, const Value *last)
+            : first(first), last(last) {
+        }
+
+        const Value *begin() const {
+            return first;
+        }
+
+        const Value *end() const {
+            return last;
+        }
+
+        std::size_t size() const {
+            return last - first;
+        }
+
+        bool empty() const {
+            return first == last;
+        }
+
+        const Value &operator[](int index) const {
+            assert(index >= 0 && index < static_cast<int>(size()));
+            return first[index];
+        }
+    };
+
+    AdjacencyLists()
+        : slab_remaining(0),
+          free_blocks(get_capacity_class(MAX_SMALL_CAPACITY) + 1),
+          num_large_block_values(0) {
+    }
+
+    ~AdjacencyLists() {
+        for (const Block &block : blocks) {
+            if (block.capacity > MAX_SMALL_CAPACITY)
+                allocator.deallocate(block.data, block.capacity);
+        }
+        for (Value *slab : slabs)
+            allocator.deallocate(slab, SLAB_CAPACITY);
+    }
+
+    AdjacencyLists(const AdjacencyLists &) = delete;
+    AdjacencyLists &operator=(const AdjacencyLists &) = delete;
+
+    // Number of lists.
+    std::size_t size() const {
+        return blocks.size();
+    }
+
+    Range operator[](int list) const {
+        const Block &block = blocks[list];
+        return Range(block.data, block.data + block.size);
+    }
+
+    void add_list() {
+        blocks.emplace_back();
+    }
+
+    void push_back(int list, Value value) {
+        Block &block = blocks[list];
+        if (block.size == block.capacity)
+            move_to_new_block(
+                block, get_block_capacity(block.capacity + block.capacity / 2 + 1));
+        new (block.data + block.size++) Value(value);
+    }
+
+    void set(int list, int index, const Value &value) {
+        const Block &block = blocks[list];
+        assert(index >= 0 && index < block.size);
+        block.data[index] = value;
+    }
+
+    // Remove all values from the given position to the end of the list.
+    void truncate(int list, int new_size) {
+        Block &block = blocks[list];
+        assert(new_size >= 0 && new_size <= block.size);
+        block.size = new_size;
+        if (new_size == 0) {
+            release_block(block.data, block.capacity);
+            block = Block();
+        } else if (new_size <= block.capacity / 4) {
+            move_to_new_block(block, get_block_capacity(new_size));
+        }
+    }
+
+    // Return the memory used by all blocks and slabs, including unused ones.
+    std::size_t estimate_memory_usage_in_bytes() const {
+        std::size_t mem = (slabs.size() * SLAB_CAPACITY + num_large_block_values) *
+            sizeof(Value);
+        mem += blocks.capacity() * sizeof(Block);
+        mem += slabs.capacity() * sizeof(Value *);
+        for (const std::vector<Value *> &free : free_blocks)
+            mem += free.capacity() * sizeof(Value *);
+        return mem;
+    }
+};
+}
+
+#endif
@@ -1,6 +1,6 @@
 #include "cartesian_heuristic_function.h"
 
-#include "refinement_hierarchy.h"
+#include "../task_proxy.h"
 
 #include "../utils/collections.h"
 
@@ -8,15 +8,21 @@ using namespace std;
 
 namespace cegar {
 CartesianHeuristicFunction::CartesianHeuristicFunction(
-    unique_ptr<RefinementHierarchy> &&hierarchy,
+    const RefinementHierarchy &hierarchy,
+    const AbstractTask &ancestor_task,
     vector<int> &&h_values)
-    : refinement_hierarchy(move(hierarchy)),
+    : refinement_hierarchy(hierarchy, ancestor_task),
       h_values(move(h_values)) {
 }
 
-int CartesianHeuristicFunction::get_value(const State &state) const {
-    int abstract_state_id = refinement_hierarchy->get_abstract_state_id(state);
+int CartesianHeuristicFunction::get_value(const vector<int> &ancestor_values) const {
+    int abstract_state_id =
+        refinement_hierarchy.get_abstract_state_id(ancestor_values);
     assert(utils::in_bounds(abstract_state_id, h_values));
     return h_values[abstract_state_id];
 }
+
+int CartesianHeuristicFunction::get_value(const State &state) const {
+    return get_value(state.get_values());
+}
 }
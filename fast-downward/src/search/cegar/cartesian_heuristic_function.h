@@ -1,30 +1,35 @@
 #ifndef CEGAR_CARTESIAN_HEURISTIC_FUNCTION_H
 #define CEGAR_CARTESIAN_HEURISTIC_FUNCTION_H
 
-#include <memory>
+#include "refinement_hierarchy.h"
+
 #include <vector>
 
+class AbstractTask;
 class State;
 
 namespace cegar {
-class RefinementHierarchy;
 /*
-  Store RefinementHierarchy and heuristic values for looking up abstract state
-  IDs and corresponding heuristic values efficiently.
+  Store a FlatRefinementHierarchy and heuristic values for looking up
+  abstract state IDs and corresponding heuristic values efficiently.
+  Lookups expect states of the ancestor task for which the hierarchy
+  has been compiled.
 */
 class CartesianHeuristicFunction {
     // Avoid const to enable moving.
-    std::unique_ptr<RefinementHierarchy> refinement_hierarchy;
+    FlatRefinementHierarchy refinement_hierarchy;
     std::vector<int> h_values;
 
 public:
     CartesianHeuristicFunction(
-        std::unique_ptr<RefinementHierarchy> &&hierarchy,
+        const RefinementHierarchy &hierarchy,
+        const AbstractTask &ancestor_task,
         std::vector<int> &&h_values);
 
     CartesianHeuristicFunction(const CartesianHeuristicFunction &) = delete;
     CartesianHeuristicFunction(CartesianHeuristicFunction &&) = default;
 
+    int get_value(const std::vector<int> &ancestor_values) const;
     int get_value(const State &state) const;
 };
 }
@@ -3,10 +3,12 @@
 #include "abstraction.h"
 #include "abstract_state.h"
 #include "cartesian_set.h"
+#include "shortest_paths.h"
 #include "transition_system.h"
 #include "utils.h"
 
 #include "../task_utils/task_properties.h"
+#include "../tasks/frozen_task.h"
 #include "../utils/language.h"
 #include "../utils/logging.h"
 #include "../utils/math.h"
@@ -84,27 +86,35 @@ CEGAR::CEGAR(
     int max_non_looping_transitions,
     double max_time,
     PickSplit pick,
+    SearchStrategy search_strategy,
     utils::RandomNumberGenerator &rng,
+    utils::Verbosity verbosity,
     bool debug)
-    : task_proxy(*task),
+    : frozen_task(tasks::freeze_task(task)),
+      task_proxy(*frozen_task),
       domain_sizes(get_domain_sizes(task_proxy)),
       max_states(max_states),
       max_non_looping_transitions(max_non_looping_transitions),
-      split_selector(task, pick),
-      abstraction(utils::make_unique_ptr<Abstraction>(task, debug)),
+      split_selector(frozen_task, pick),
+      search_strategy(search_strategy),
+      abstraction(utils::make_unique_ptr<Abstraction>(task, *frozen_task, debug)),
       abstract_search(task_properties::get_operator_costs(task_proxy)),
       timer(max_time),
+      verbosity(verbosity),
       debug(debug) {
     assert(max_states >= 1);
-    utils::g_log << "Start building abstraction." << endl;
-    cout << "Maximum number of states: " << max_states << endl;
-    cout << "Maximum number of transitions: "
-         << max_non_looping_transitions << endl;
+    if (verbosity >= utils::Verbosity::NORMAL) {
+        utils::g_log << "Start building abstraction." << endl;
+        cout << "Maximum number of states: " << max_states << endl;
+        cout << "Maximum number of transitions: "
+             << max_non_looping_transitions << endl;
+    }
     refinement_loop(rng);
-    utils::g_log << "Done building abstraction." << endl;
-    cout << "Time for building abstraction: " << timer.get_elapsed_time() << endl;
-
-    print_statistics();
+    if (verbosity >= utils::Verbosity::NORMAL) {
+        utils::g_log << "Done building abstraction." << endl;
+        cout << "Time for building abstraction: " << timer.get_elapsed_time() << endl;
+        print_statistics();
+    }
 }
 
 CEGAR::~CEGAR() {
@@ -140,16 +150,20 @@ void CEGAR::separate_facts_unreachable_before_goal() {
 
 bool CEGAR::may_keep_refining() const {
     if (abstraction->get_num_states() >= max_states) {
-        cout << "Reached maximum number of states." << endl;
+        if (verbosity >= utils::Verbosity::NORMAL)
+            cout << "Reached maximum number of states." << endl;
         return false;
     } else if (abstraction->get_transition_system().get_num_non_loops() >= max_non_looping_transitions) {
-        cout << "Reached maximum number of transitions." << endl;
+        if (verbosity >= utils::Verbosity::NORMAL)
+            cout << "Reached maximum number of transitions." << endl;
         return false;
     } else if (timer.is_expired()) {
-        cout << "Reached time limit." << endl;
+        if (verbosity >= utils::Verbosity::NORMAL)
+            cout << "Reached time limit." << endl;
         return false;
     } else if (!utils::extra_memory_padding_is_reserved()) {
-        cout << "Reached memory limit." << endl;
+        if (verbosity >= utils::Verbosity::NORMAL)
+            cout << "Reached memory limit." << endl;
         return false;
     }
     return true;
@@ -167,6 +181,14 @@ void CEGAR::refinement_loop(utils::RandomNumberGenerator &rng) {
         separate_facts_unreachable_before_goal();
     }
 
+    if (search_strategy == SearchStrategy::INCREMENTAL) {
+        shortest_paths = utils::make_unique_ptr<ShortestPaths>(
+            task_properties::get_operator_costs(task_proxy));
+        shortest_paths->recompute(
+            abstraction->get_transition_system().get_incoming_transitions(),
+            abstraction->get_goals());
+    }
+
     utils::Timer find_trace_timer;
     utils::Timer find_flaw_timer;
     utils::Timer refine_timer;
@@ -176,13 +198,11 @@ void CEGAR::refinement_loop(utils::RandomNumberGenerator &rng) {
 
     while (may_keep_refining()) {
         find_trace_timer.resume();
-        unique_ptr<Solution> solution = abstract_search.find_solution(
-            abstraction->get_transition_system().get_outgoing_transitions(),
-            abstraction->get_initial_state().get_id(),
-            abstraction->get_goals());
+        unique_ptr<Solution> solution = find_abstract_solution();
         find_trace_timer.stop();
         if (!solution) {
-            cout << "Abstract task is unsolvable." << endl;
+            if (verbosity >= utils::Verbosity::NORMAL)
+                cout << "Abstract task is unsolvable." << endl;
             break;
         }
 
@@ -190,7 +210,8 @@ void CEGAR::refinement_loop(utils::RandomNumberGenerator &rng) {
         unique_ptr<Flaw> flaw = find_flaw(*solution);
         find_flaw_timer.stop();
         if (!flaw) {
-            cout << "Found concrete solution during refinement." << endl;
+            if (verbosity >= utils::Verbosity::NORMAL)
+                cout << "Found concrete solution during refinement." << endl;
             break;
         }
 
@@ -200,20 +221,63 @@ void CEGAR::refinement_loop(utils::RandomNumberGenerator &rng) {
         vector<Split> splits = flaw->get_possible_splits();
         const Split &split = split_selector.pick_split(abstract_state, splits, rng);
         auto new_state_ids = abstraction->refine(abstract_state, split.var_id, split.values);
-        // Since h-values only increase we can assign the h-value to the children.
-        abstract_search.copy_h_value_to_children(
-            state_id, new_state_ids.first, new_state_ids.second);
+        if (search_strategy == SearchStrategy::INCREMENTAL) {
+            shortest_paths->update_incrementally(
+                abstraction->get_transition_system().get_incoming_transitions(),
+                abstraction->get_transition_system().get_outgoing_transitions(),
+                state_id, new_state_ids.first, new_state_ids.second,
+                abstraction->get_goals());
+        } else {
+            // Since h-values only increase we can assign the h-value to the children.
+            abstract_search.copy_h_value_to_children(
+                state_id, new_state_ids.first, new_state_ids.second);
+        }
         refine_timer.stop();
 
-        if (abstraction->get_num_states() % 1000 == 0) {
+        if (verbosity >= utils::Verbosity::NORMAL &&
+            abstraction->get_num_states() % 1000 == 0) {
             utils::g_log << abstraction->get_num_states() << "/" << max_states << " states, "
                          << abstraction->get_transition_system().get_num_non_loops() << "/"
                          << max_non_looping_transitions << " transitions" << endl;
         }
     }
-    cout << "Time for finding abstract traces: " << find_trace_timer << endl;
-    cout << "Time for finding flaws: " << find_flaw_timer << endl;
-    cout << "Time for splitting states: " << refine_timer << endl;
+    if (verbosity >= utils::Verbosity::NORMAL) {
+        cout << "Time for finding abstract traces: " << find_trace_timer << endl;
+        cout << "Time for finding flaws: " << find_flaw_timer << endl;
+        cout << "Time for splitting states: " << refine_timer << endl;
+    }
+}
+
+unique_ptr<Solution> CEGAR::find_abstract_solution() {
+    int init_id = abstraction->get_initial_state().get_id();
+    if (search_strategy == SearchStrategy::INCREMENTAL) {
+        return shortest_paths->extract_solution(init_id, abstraction->get_goals());
+    } else {
+        return abstract_search.find_solution(
+            abstraction->get_transition_system().get_outgoing_transitions(),
+            init_id,
+            abstraction->get_goals());
+    }
+}
+
+bool CEGAR::is_applicable(int op_id, const State &state) const {
+    const vector<int> &values = state.get_values();
+    for (const FactPair &precondition : frozen_task->get_preconditions(op_id, false)) {
+        if (values[precondition.var] != precondition.value)
+            return false;
+    }
+    return true;
+}
+
+State CEGAR::get_successor(const State &state, int op_id) const {
+    // CEGAR only supports tasks without conditional effects and axioms.
+    vector<int> values = state.get_values();
+    tasks::FactPairRange effects = frozen_task->get_effect_facts(op_id, false);
+    for (int eff_id = 0; eff_id < effects.size(); ++eff_id) {
+        assert(frozen_task->get_effect_conditions(op_id, eff_id, false).empty());
+        values[effects[eff_id].var] = effects[eff_id].value;
+    }
+    return task_proxy.create_state(move(values));
 }
 
 unique_ptr<Flaw> CEGAR::find_flaw(const Solution &solution) {
@@ -232,11 +296,11 @@ unique_ptr<Flaw> CEGAR::find_flaw(const Solution &solution) {
             break;
         OperatorProxy op = task_proxy.get_operators()[step.op_id];
         const AbstractState *next_abstract_state = &abstraction->get_state(step.target_id);
-        if (task_properties::is_applicable(op, concrete_state)) {
+        if (is_applicable(step.op_id, concrete_state)) {
             if (debug)
                 cout << "  Move to " << *next_abstract_state << " with "
                      << op.get_name() << endl;
-            State next_concrete_state = concrete_state.get_successor(op);
+            State next_concrete_state = get_successor(concrete_state, step.op_id);
             if (!next_abstract_state->includes(next_concrete_state)) {
                 if (debug)
                     cout << "  Paths deviate." << endl;
@@ -270,10 +334,18 @@ unique_ptr<Flaw> CEGAR::find_flaw(const Solution &solution) {
     }
 }
 
+int CEGAR::get_initial_h_value() const {
+    int init_id = abstraction->get_initial_state().get_id();
+    if (search_strategy == SearchStrategy::INCREMENTAL) {
+        return shortest_paths->get_goal_distance(init_id);
+    } else {
+        return abstract_search.get_h_value(init_id);
+    }
+}
+
 void CEGAR::print_statistics() {
     abstraction->print_statistics();
-    int init_id = abstraction->get_initial_state().get_id();
-    cout << "Initial h value: " << abstract_search.get_h_value(init_id) << endl;
+    cout << "Initial h value: " << get_initial_h_value() << endl;
     cout << endl;
 }
 }
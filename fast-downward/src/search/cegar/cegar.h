@@ -7,9 +7,14 @@
 #include "../task_proxy.h"
 
 #include "../utils/countdown_timer.h"
+#include "../utils/logging.h"
 
 #include <memory>
 
+namespace tasks {
+class FrozenTask;
+}
+
 namespace utils {
 class RandomNumberGenerator;
 }
@@ -17,6 +22,15 @@ class RandomNumberGenerator;
 namespace cegar {
 class Abstraction;
 struct Flaw;
+class ShortestPaths;
+
+// Strategies for finding abstract solutions during refinement.
+enum class SearchStrategy {
+    // Run A* from scratch after each refinement.
+    ASTAR,
+    // Repair goal distances after each refinement and follow shortest paths.
+    INCREMENTAL
+};
 
 /*
   Iteratively refine a Cartesian abstraction with counterexample-guided
@@ -27,18 +41,29 @@ struct Flaw;
   spurious solutions.
 */
 class CEGAR {
+    /*
+      The refinement loop accesses the operators of the task in every
+      iteration, so it works on a frozen copy of the task and reads
+      preconditions and effects through its non-virtual accessors. The
+      copy only lives as long as this object: the refinement hierarchy
+      of the abstraction refers to the original task.
+    */
+    const std::shared_ptr<tasks::FrozenTask> frozen_task;
     const TaskProxy task_proxy;
     const std::vector<int> domain_sizes;
     const int max_states;
     const int max_non_looping_transitions;
     const SplitSelector split_selector;
+    const SearchStrategy search_strategy;
 
     std::unique_ptr<Abstraction> abstraction;
     AbstractSearch abstract_search;
+    std::unique_ptr<ShortestPaths> shortest_paths;
 
     // Limit the time for building the abstraction.
     utils::CountdownTimer timer;
 
+    const utils::Verbosity verbosity;
     const bool debug;
 
     bool may_keep_refining() const;
@@ -53,6 +78,11 @@ class CEGAR {
     */
     void separate_facts_unreachable_before_goal();
 
+    std::unique_ptr<Solution> find_abstract_solution();
+
+    bool is_applicable(int op_id, const State &state) const;
+    State get_successor(const State &state, int op_id) const;
+
     /* Try to convert the abstract solution into a concrete trace. Return the
        first encountered flaw or nullptr if there is no flaw. */
     std::unique_ptr<Flaw> find_flaw(const Solution &solution);
@@ -60,6 +90,7 @@ class CEGAR {
     // Build abstraction.
     void refinement_loop(utils::RandomNumberGenerator &rng);
 
+    int get_initial_h_value() const;
     void print_statistics();
 
 public:
@@ -69,7 +100,9 @@ public:
         int max_non_looping_transitions,
         double max_time,
         PickSplit pick,
+        SearchStrategy search_strategy,
         utils::RandomNumberGenerator &rng,
+        utils::Verbosity verbosity,
         bool debug);
     ~CEGAR();
 
@@ -14,9 +14,13 @@
 #include "../utils/countdown_timer.h"
 #include "../utils/logging.h"
 #include "../utils/memory.h"
+#include "../utils/rng.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <limits>
+#include <thread>
 
 using namespace std;
 
@@ -88,7 +92,9 @@ CostSaturation::CostSaturation(
     double max_time,
     bool use_general_costs,
     PickSplit pick_split,
+    SearchStrategy search_strategy,
     utils::RandomNumberGenerator &rng,
+    int num_threads,
     bool debug)
     : subtask_generators(subtask_generators),
       max_states(max_states),
@@ -96,7 +102,9 @@ CostSaturation::CostSaturation(
       max_time(max_time),
       use_general_costs(use_general_costs),
       pick_split(pick_split),
+      search_strategy(search_strategy),
       rng(rng),
+      num_threads(num_threads),
       debug(debug),
       num_abstractions(0),
       num_states(0),
@@ -115,7 +123,7 @@ vector<CartesianHeuristicFunction> CostSaturation::generate_heuristic_functions(
     task_properties::verify_no_axioms(task_proxy);
     task_properties::verify_no_conditional_effects(task_proxy);
 
-    reset(task_proxy);
+    reset(task);
 
     State initial_state = TaskProxy(*task).get_initial_state();
 
@@ -129,11 +137,21 @@ vector<CartesianHeuristicFunction> CostSaturation::generate_heuristic_functions(
         };
 
     utils::reserve_extra_memory_padding(memory_padding_in_mb);
-    for (const shared_ptr<SubtaskGenerator> &subtask_generator : subtask_generators) {
-        SharedTasks subtasks = subtask_generator->get_subtasks(task);
-        build_abstractions(subtasks, timer, should_abort);
-        if (should_abort())
-            break;
+    if (num_threads > 1) {
+        SharedTasks subtasks;
+        for (const shared_ptr<SubtaskGenerator> &subtask_generator : subtask_generators) {
+            SharedTasks generated_subtasks = subtask_generator->get_subtasks(task);
+            subtasks.insert(
+                subtasks.end(), generated_subtasks.begin(), generated_subtasks.end());
+        }
+        build_abstractions_in_parallel(subtasks, timer, initial_state);
+    } else {
+        for (const shared_ptr<SubtaskGenerator> &subtask_generator : subtask_generators) {
+            SharedTasks subtasks = subtask_generator->get_subtasks(task);
+            build_abstractions(subtasks, timer, should_abort);
+            if (should_abort())
+                break;
+        }
     }
     if (utils::extra_memory_padding_is_reserved())
         utils::release_extra_memory_padding();
@@ -145,8 +163,9 @@ vector<CartesianHeuristicFunction> CostSaturation::generate_heuristic_functions(
     return functions;
 }
 
-void CostSaturation::reset(const TaskProxy &task_proxy) {
-    remaining_costs = task_properties::get_operator_costs(task_proxy);
+void CostSaturation::reset(const shared_ptr<AbstractTask> &task) {
+    this->task = task;
+    remaining_costs = task_properties::get_operator_costs(TaskProxy(*task));
     num_abstractions = 0;
     num_states = 0;
 }
@@ -187,6 +206,35 @@ bool CostSaturation::state_is_dead_end(const State &state) const {
     return false;
 }
 
+void CostSaturation::add_abstraction(
+    unique_ptr<Abstraction> abstraction, const vector<int> &costs) {
+    ++num_abstractions;
+    num_states += abstraction->get_num_states();
+    num_non_looping_transitions += abstraction->get_transition_system().get_num_non_loops();
+    assert(num_states <= max_states);
+
+    vector<int> init_distances = compute_distances(
+        abstraction->get_transition_system().get_outgoing_transitions(),
+        costs,
+        {abstraction->get_initial_state().get_id()});
+    vector<int> goal_distances = compute_distances(
+        abstraction->get_transition_system().get_incoming_transitions(),
+        costs,
+        abstraction->get_goals());
+    vector<int> saturated_costs = compute_saturated_costs(
+        abstraction->get_transition_system(),
+        init_distances,
+        goal_distances,
+        use_general_costs);
+
+    heuristic_functions.emplace_back(
+        *abstraction->extract_refinement_hierarchy(),
+        *task,
+        move(goal_distances));
+
+    reduce_remaining_costs(saturated_costs);
+}
+
 void CostSaturation::build_abstractions(
     const vector<shared_ptr<AbstractTask>> &subtasks,
     const utils::CountdownTimer &timer,
@@ -203,35 +251,14 @@ void CostSaturation::build_abstractions(
                 rem_subtasks),
             timer.get_remaining_time() / rem_subtasks,
             pick_split,
+            search_strategy,
             rng,
+            utils::Verbosity::NORMAL,
             debug);
 
-        unique_ptr<Abstraction> abstraction = cegar.extract_abstraction();
-        ++num_abstractions;
-        num_states += abstraction->get_num_states();
-        num_non_looping_transitions += abstraction->get_transition_system().get_num_non_loops();
-        assert(num_states <= max_states);
-
-        vector<int> costs = task_properties::get_operator_costs(TaskProxy(*subtask));
-        vector<int> init_distances = compute_distances(
-            abstraction->get_transition_system().get_outgoing_transitions(),
-            costs,
-            {abstraction->get_initial_state().get_id()});
-        vector<int> goal_distances = compute_distances(
-            abstraction->get_transition_system().get_incoming_transitions(),
-            costs,
-            abstraction->get_goals());
-        vector<int> saturated_costs = compute_saturated_costs(
-            abstraction->get_transition_system(),
-            init_distances,
-            goal_distances,
-            use_general_costs);
-
-        heuristic_functions.emplace_back(
-            abstraction->extract_refinement_hierarchy(),
-            move(goal_distances));
-
-        reduce_remaining_costs(saturated_costs);
+        add_abstraction(
+            cegar.extract_abstraction(),
+            task_properties::get_operator_costs(TaskProxy(*subtask)));
 
         if (should_abort())
             break;
@@ -240,6 +267,81 @@ void CostSaturation::build_abstractions(
     }
 }
 
+void CostSaturation::build_abstractions_in_parallel(
+    const vector<shared_ptr<AbstractTask>> &subtasks,
+    const utils::CountdownTimer &timer,
+    const State &initial_state) {
+    int num_subtasks = subtasks.size();
+    if (num_subtasks == 0)
+        return;
+    int num_workers = min(num_threads, num_subtasks);
+    cout << "Build " << num_subtasks << " abstractions with "
+         << num_workers << " threads." << endl;
+
+    /*
+      All abstractions share the state and transition limits equally.
+      Since each thread computes num_rounds abstractions, each
+      abstraction may use a corresponding share of the remaining time.
+    */
+    int abstraction_max_states = max(1, max_states / num_subtasks);
+    int abstraction_max_transitions =
+        max(1, max_non_looping_transitions / num_subtasks);
+    int num_rounds = (num_subtasks + num_workers - 1) / num_workers;
+    double abstraction_max_time = timer.get_remaining_time() / num_rounds;
+
+    /* Draw the seeds up front to make the results independent of the
+       order in which the threads process the subtasks. */
+    vector<int> seeds;
+    seeds.reserve(num_subtasks);
+    for (int i = 0; i < num_subtasks; ++i) {
+        seeds.push_back(rng(numeric_limits<int>::max()));
+    }
+
+    /*
+      The workers don't log, since their output would interleave. They
+      stop starting new abstractions once the time or memory runs out.
+      Subtasks that are skipped this way leave a null abstraction.
+    */
+    vector<unique_ptr<Abstraction>> abstractions(num_subtasks);
+    atomic<int> next_subtask(0);
+    auto build_next_abstractions = [&]() {
+            for (int i = next_subtask++; i < num_subtasks; i = next_subtask++) {
+                if (timer.is_expired() || !utils::extra_memory_padding_is_reserved())
+                    break;
+                utils::RandomNumberGenerator subtask_rng(seeds[i]);
+                CEGAR cegar(
+                    subtasks[i],
+                    abstraction_max_states,
+                    abstraction_max_transitions,
+                    abstraction_max_time,
+                    pick_split,
+                    search_strategy,
+                    subtask_rng,
+                    utils::Verbosity::SILENT,
+                    debug);
+                abstractions[i] = cegar.extract_abstraction();
+            }
+        };
+    vector<thread> workers;
+    for (int i = 0; i < num_workers; ++i) {
+        workers.emplace_back(build_next_abstractions);
+    }
+    for (thread &worker : workers) {
+        worker.join();
+    }
+
+    // Combine the abstractions by saturated cost partitioning.
+    for (unique_ptr<Abstraction> &abstraction : abstractions) {
+        if (!abstraction)
+            continue;
+        // add_abstraction() reduces the remaining costs, so pass a copy.
+        vector<int> costs = remaining_costs;
+        add_abstraction(move(abstraction), costs);
+        if (state_is_dead_end(initial_state))
+            break;
+    }
+}
+
 void CostSaturation::print_statistics(utils::Duration init_time) const {
     utils::g_log << "Done initializing additive Cartesian heuristic" << endl;
     cout << "Time for initializing additive Cartesian heuristic: "
@@ -1,6 +1,7 @@
 #ifndef CEGAR_COST_SATURATION_H
 #define CEGAR_COST_SATURATION_H
 
+#include "cegar.h"
 #include "refinement_hierarchy.h"
 #include "split_selector.h"
 
@@ -14,6 +15,7 @@ class RandomNumberGenerator;
 }
 
 namespace cegar {
+class Abstraction;
 class CartesianHeuristicFunction;
 class SubtaskGenerator;
 
@@ -23,6 +25,10 @@ class SubtaskGenerator;
   RefinementHierarchies from Abstractions to
   CartesianHeuristicFunctions, allow extracting
   CartesianHeuristicFunctions into AdditiveCartesianHeuristic.
+
+  With num_threads > 1, the abstractions are instead computed
+  independently and in parallel for the original operator costs and
+  combined by a saturated cost partitioning afterwards.
 */
 class CostSaturation {
     const std::vector<std::shared_ptr<SubtaskGenerator>> subtask_generators;
@@ -31,24 +37,35 @@ class CostSaturation {
     const double max_time;
     const bool use_general_costs;
     const PickSplit pick_split;
+    const SearchStrategy search_strategy;
     utils::RandomNumberGenerator &rng;
+    const int num_threads;
     const bool debug;
 
+    // Task for which the heuristic functions are computed.
+    std::shared_ptr<AbstractTask> task;
     std::vector<CartesianHeuristicFunction> heuristic_functions;
     std::vector<int> remaining_costs;
     int num_abstractions;
     int num_states;
     int num_non_looping_transitions;
 
-    void reset(const TaskProxy &task_proxy);
+    void reset(const std::shared_ptr<AbstractTask> &task);
     void reduce_remaining_costs(const std::vector<int> &saturated_costs);
     std::shared_ptr<AbstractTask> get_remaining_costs_task(
         std::shared_ptr<AbstractTask> &parent) const;
     bool state_is_dead_end(const State &state) const;
+    void add_abstraction(
+        std::unique_ptr<Abstraction> abstraction,
+        const std::vector<int> &costs);
     void build_abstractions(
         const std::vector<std::shared_ptr<AbstractTask>> &subtasks,
         const utils::CountdownTimer &timer,
         std::function<bool()> should_abort);
+    void build_abstractions_in_parallel(
+        const std::vector<std::shared_ptr<AbstractTask>> &subtasks,
+        const utils::CountdownTimer &timer,
+        const State &initial_state);
     void print_statistics(utils::Duration init_time) const;
 
 public:
@@ -59,7 +76,9 @@ public:
         double max_time,
         bool use_general_costs,
         PickSplit pick_split,
+        SearchStrategy search_strategy,
         utils::RandomNumberGenerator &rng,
+        int num_threads,
         bool debug);
 
     std::vector<CartesianHeuristicFunction> generate_heuristic_functions(
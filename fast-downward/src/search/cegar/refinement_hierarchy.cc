@@ -1,6 +1,10 @@
 #include "refinement_hierarchy.h"
 
-#include "../task_proxy.h"
+#include "../abstract_task.h"
+
+#include "../utils/collections.h"
+
+#include <deque>
 
 using namespace std;
 
@@ -56,15 +60,6 @@ NodeID RefinementHierarchy::add_node(int state_id) {
     return node_id;
 }
 
-NodeID RefinementHierarchy::get_node_id(const State &state) const {
-    NodeID id = 0;
-    while (nodes[id].is_split()) {
-        const Node &node = nodes[id];
-        id = node.get_child(state[node.get_var()].get_value());
-    }
-    return id;
-}
-
 pair<NodeID, NodeID> RefinementHierarchy::split(
     NodeID node_id, int var, const vector<int> &values, int left_state_id, int right_state_id) {
     NodeID helper_id = node_id;
@@ -77,9 +72,118 @@ pair<NodeID, NodeID> RefinementHierarchy::split(
     return make_pair(helper_id, right_child_id);
 }
 
-int RefinementHierarchy::get_abstract_state_id(const State &state) const {
-    TaskProxy subtask_proxy(*task);
-    State subtask_state = subtask_proxy.convert_ancestor_state(state);
-    return nodes[get_node_id(subtask_state)].get_state_id();
+int RefinementHierarchy::get_num_nodes() const {
+    return nodes.size();
+}
+
+const Node &RefinementHierarchy::get_node(NodeID node_id) const {
+    assert(utils::in_bounds(node_id, nodes));
+    return nodes[node_id];
+}
+
+
+/*
+  Compute for each variable split in the hierarchy how the values of
+  the ancestor task map to values of the hierarchy's subtask. Since the
+  conversion handles all variables independently, we can convert the
+  k-th value of all variables at once.
+*/
+static vector<vector<int>> compute_value_maps(
+    const AbstractTask &task, const AbstractTask &ancestor_task,
+    const vector<bool> &is_split_var) {
+    int num_vars = ancestor_task.get_num_variables();
+    assert(task.get_num_variables() == num_vars);
+    vector<vector<int>> value_maps(num_vars);
+    int max_domain_size = 0;
+    for (int var = 0; var < num_vars; ++var) {
+        if (is_split_var[var]) {
+            int domain_size = ancestor_task.get_variable_domain_size(var);
+            value_maps[var].resize(domain_size);
+            max_domain_size = max(max_domain_size, domain_size);
+        }
+    }
+    vector<int> values(num_vars);
+    for (int value = 0; value < max_domain_size; ++value) {
+        for (int var = 0; var < num_vars; ++var) {
+            values[var] = min(value, ancestor_task.get_variable_domain_size(var) - 1);
+        }
+        task.convert_state_values(values, &ancestor_task);
+        assert(static_cast<int>(values.size()) == num_vars);
+        for (int var = 0; var < num_vars; ++var) {
+            if (value < static_cast<int>(value_maps[var].size())) {
+                value_maps[var][value] = values[var];
+            }
+        }
+    }
+    return value_maps;
+}
+
+FlatRefinementHierarchy::FlatRefinementHierarchy(
+    const RefinementHierarchy &hierarchy, const AbstractTask &ancestor_task) {
+    const AbstractTask &task = hierarchy.get_task();
+    vector<bool> is_split_var(task.get_num_variables(), false);
+    for (NodeID id = 0; id < hierarchy.get_num_nodes(); ++id) {
+        const Node &node = hierarchy.get_node(id);
+        if (node.is_split()) {
+            is_split_var[node.get_var()] = true;
+        }
+    }
+    vector<vector<int>> value_maps = compute_value_maps(
+        task, ancestor_task, is_split_var);
+
+    // Map node IDs of the hierarchy to encoded IDs of the flat hierarchy.
+    vector<int> flat_ids(hierarchy.get_num_nodes(), UNDEFINED);
+    deque<NodeID> queue;
+    auto get_flat_id = [&](NodeID id) {
+            const Node &node = hierarchy.get_node(id);
+            if (!node.is_split()) {
+                return ~node.get_state_id();
+            }
+            if (flat_ids[id] == UNDEFINED) {
+                flat_ids[id] = queue.size() + nodes.size();
+                queue.push_back(id);
+            }
+            return flat_ids[id];
+        };
+
+    root = get_flat_id(0);
+    vector<bool> splits_off_value;
+    while (!queue.empty()) {
+        NodeID id = queue.front();
+        queue.pop_front();
+        const Node &node = hierarchy.get_node(id);
+        int var = node.get_var();
+        NodeID right_child = node.get_right_child();
+
+        // Collect the values of all helper nodes belonging to this split.
+        splits_off_value.assign(task.get_variable_domain_size(var), false);
+        NodeID left_child = id;
+        while (hierarchy.get_node(left_child).is_split() &&
+               hierarchy.get_node(left_child).get_var() == var &&
+               hierarchy.get_node(left_child).get_right_child() == right_child) {
+            const Node &helper = hierarchy.get_node(left_child);
+            splits_off_value[helper.get_value()] = true;
+            left_child = helper.get_left_child();
+        }
+
+        const vector<int> &value_map = value_maps[var];
+        int num_values = value_map.size();
+        int bitmap_offset = bitmaps.size();
+        bitmaps.resize(bitmap_offset + (num_values + 63) / 64, 0);
+        for (int value = 0; value < num_values; ++value) {
+            if (splits_off_value[value_map[value]]) {
+                bitmaps[bitmap_offset + (value >> 6)] |= uint64_t(1) << (value & 63);
+            }
+        }
+
+        assert(flat_ids[id] == static_cast<int>(nodes.size()));
+        nodes.push_back({var, bitmap_offset, UNDEFINED, UNDEFINED});
+        int flat_left_child = get_flat_id(left_child);
+        int flat_right_child = get_flat_id(right_child);
+        nodes[flat_ids[id]].left_child = flat_left_child;
+        nodes[flat_ids[id]].right_child = flat_right_child;
+    }
+    nodes.shrink_to_fit();
+    bitmaps.shrink_to_fit();
 }
 }
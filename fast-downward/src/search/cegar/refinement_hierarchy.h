@@ -4,13 +4,13 @@
 #include "types.h"
 
 #include <cassert>
+#include <cstdint>
 #include <memory>
 #include <ostream>
 #include <utility>
 #include <vector>
 
 class AbstractTask;
-class State;
 
 namespace cegar {
 class Node;
@@ -32,7 +32,6 @@ class RefinementHierarchy {
     std::vector<Node> nodes;
 
     NodeID add_node(int state_id);
-    NodeID get_node_id(const State &state) const;
 
 public:
     explicit RefinementHierarchy(const std::shared_ptr<AbstractTask> &task);
@@ -47,7 +46,63 @@ public:
         NodeID node_id, int var, const std::vector<int> &values,
         int left_state_id, int right_state_id);
 
-    int get_abstract_state_id(const State &state) const;
+    const AbstractTask &get_task() const {
+        return *task;
+    }
+
+    int get_num_nodes() const;
+    const Node &get_node(NodeID node_id) const;
+};
+
+
+/*
+  Compiled, read-only form of a RefinementHierarchy for fast lookups
+  during search.
+
+  Each chain of helper nodes that splits several values of the same
+  variable off a state is merged into a single node, which stores a
+  bitmap of all values that lead to the right child. The value
+  conversion from the ancestor task to the abstraction's subtask (e.g.,
+  a domain abstraction) is folded into these bitmaps, so lookups work
+  directly on the unpacked values of ancestor states and need no state
+  conversion. Nodes are stored in breadth-first order and are 16 bytes
+  large, so no node straddles a cache line. Child IDs are node indices
+  if they are non-negative and encode the abstract state ID s as ~s
+  (i.e., -s-1) otherwise.
+*/
+class FlatRefinementHierarchy {
+    struct alignas(16) FlatNode {
+        int var;
+        int bitmap_offset;
+        int left_child;
+        int right_child;
+    };
+
+    std::vector<FlatNode> nodes;
+    std::vector<uint64_t> bitmaps;
+    // Encoded ID of the root, negative if the abstraction has a single state.
+    int root;
+
+public:
+    /*
+      The hierarchy's subtask must convert each variable independently
+      from the ancestor task, which holds for all task transformations
+      used by CEGAR.
+    */
+    FlatRefinementHierarchy(
+        const RefinementHierarchy &hierarchy, const AbstractTask &ancestor_task);
+
+    int get_abstract_state_id(const std::vector<int> &ancestor_values) const {
+        int id = root;
+        while (id >= 0) {
+            const FlatNode &node = nodes[id];
+            int value = ancestor_values[node.var];
+            bool goes_right =
+                (bitmaps[node.bitmap_offset + (value >> 6)] >> (value & 63)) & 1;
+            id = goes_right ? node.right_child : node.left_child;
+        }
+        return ~id;
+    }
 };
 
 
@@ -83,6 +138,21 @@ public:
         return var;
     }
 
+    int get_value() const {
+        assert(is_split());
+        return value;
+    }
+
+    NodeID get_left_child() const {
+        assert(is_split());
+        return left_child;
+    }
+
+    NodeID get_right_child() const {
+        assert(is_split());
+        return right_child;
+    }
+
     NodeID get_child(int value) const {
         assert(is_split());
         if (value == this->value)
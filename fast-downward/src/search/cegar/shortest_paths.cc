@@ -0,0 +1,241 @@
+#include "shortest_paths.h"
+
+#include "../utils/collections.h"
+#include "../utils/language.h"
+#include "../utils/memory.h"
+
+#include <algorithm>
+#include <cassert>
+
+using namespace std;
+
+namespace cegar {
+static const Transition NO_TRANSITION(UNDEFINED, UNDEFINED);
+
+ShortestPaths::ShortestPaths(const vector<int> &operator_costs)
+    : operator_costs(operator_costs) {
+}
+
+int ShortestPaths::add_costs(int op_id, int distance) const {
+    assert(utils::in_bounds(op_id, operator_costs));
+    int op_cost = operator_costs[op_id];
+    assert(op_cost >= 0);
+    if (op_cost == INF || distance == INF)
+        return INF;
+    return op_cost + distance;
+}
+
+void ShortestPaths::recompute(
+    const TransitionLists &incoming, const Goals &goals) {
+    int num_states = incoming.size();
+    goal_distances.assign(num_states, INF);
+    shortest_path.assign(num_states, NO_TRANSITION);
+    dirty.assign(num_states, false);
+    open_queue.clear();
+    for (int goal_id : goals) {
+        goal_distances[goal_id] = 0;
+        open_queue.push(0, goal_id);
+    }
+    while (!open_queue.empty()) {
+        pair<int, int> top_pair = open_queue.pop();
+        int old_distance = top_pair.first;
+        int state_id = top_pair.second;
+        const int distance = goal_distances[state_id];
+        assert(distance <= old_distance);
+        if (distance < old_distance)
+            continue;
+        for (const Transition &transition : incoming[state_id]) {
+            int pred_id = transition.target_id;
+            int pred_distance = add_costs(transition.op_id, distance);
+            if (pred_distance < goal_distances[pred_id]) {
+                goal_distances[pred_id] = pred_distance;
+                shortest_path[pred_id] = Transition(transition.op_id, state_id);
+                open_queue.push(pred_distance, pred_id);
+            }
+        }
+    }
+}
+
+bool ShortestPaths::is_on_shortest_path(
+    int u_id, const Transition &transition_to_v) const {
+    const Transition &path = shortest_path[u_id];
+    return path.op_id == transition_to_v.op_id &&
+           path.target_id == transition_to_v.target_id;
+}
+
+void ShortestPaths::mark_dirty(int state_id) {
+    if (!dirty[state_id]) {
+        dirty[state_id] = true;
+        dirty_states.push_back(state_id);
+    }
+}
+
+bool ShortestPaths::find_shortest_path_keeping_distance(
+    TransitionLists::Range outgoing, int state_id, int v1_id, int v2_id,
+    int old_distance) {
+    /*
+      Look for a transition to a state w other than v1 and v2 that still
+      realizes the old distance. We require d(w) < old_distance, which
+      ensures that the shortest path from w does not pass through v1 or
+      v2 and therefore remains valid.
+    */
+    for (const Transition &transition : outgoing) {
+        int succ_id = transition.target_id;
+        if (succ_id == v1_id || succ_id == v2_id)
+            continue;
+        int succ_distance = goal_distances[succ_id];
+        if (succ_distance < old_distance &&
+            add_costs(transition.op_id, succ_distance) == old_distance) {
+            shortest_path[state_id] = transition;
+            return true;
+        }
+    }
+    return false;
+}
+
+void ShortestPaths::repair_dirty_states(
+    const TransitionLists &incoming,
+    const TransitionLists &outgoing) {
+    /*
+      All states whose shortest path leads through a dirty state are
+      dirty as well. We find them by following the shortest paths
+      backwards.
+    */
+    for (size_t i = 0; i < dirty_states.size(); ++i) {
+        int state_id = dirty_states[i];
+        for (const Transition &transition : incoming[state_id]) {
+            int pred_id = transition.target_id;
+            if (!dirty[pred_id] &&
+                is_on_shortest_path(pred_id, Transition(transition.op_id, state_id))) {
+                mark_dirty(pred_id);
+            }
+        }
+    }
+
+    for (int state_id : dirty_states) {
+        goal_distances[state_id] = INF;
+        shortest_path[state_id] = NO_TRANSITION;
+    }
+
+    // Initialize the distances of dirty states from their clean successors.
+    open_queue.clear();
+    for (int state_id : dirty_states) {
+        for (const Transition &transition : outgoing[state_id]) {
+            int succ_id = transition.target_id;
+            if (dirty[succ_id])
+                continue;
+            int distance = add_costs(transition.op_id, goal_distances[succ_id]);
+            if (distance < goal_distances[state_id]) {
+                goal_distances[state_id] = distance;
+                shortest_path[state_id] = transition;
+            }
+        }
+        if (goal_distances[state_id] != INF) {
+            open_queue.push(goal_distances[state_id], state_id);
+        }
+    }
+
+    // Run Dijkstra's algorithm restricted to the dirty states.
+    while (!open_queue.empty()) {
+        pair<int, int> top_pair = open_queue.pop();
+        int old_distance = top_pair.first;
+        int state_id = top_pair.second;
+        const int distance = goal_distances[state_id];
+        assert(distance <= old_distance);
+        if (distance < old_distance)
+            continue;
+        for (const Transition &transition : incoming[state_id]) {
+            int pred_id = transition.target_id;
+            if (!dirty[pred_id])
+                continue;
+            int pred_distance = add_costs(transition.op_id, distance);
+            if (pred_distance < goal_distances[pred_id]) {
+                goal_distances[pred_id] = pred_distance;
+                shortest_path[pred_id] = Transition(transition.op_id, state_id);
+                open_queue.push(pred_distance, pred_id);
+            }
+        }
+    }
+
+    for (int state_id : dirty_states) {
+        dirty[state_id] = false;
+    }
+    dirty_states.clear();
+}
+
+void ShortestPaths::update_incrementally(
+    const TransitionLists &incoming,
+    const TransitionLists &outgoing,
+    int v_id, int v1_id, int v2_id,
+    const Goals &goals) {
+    // State v1 reuses the ID of v and v2 is a new state.
+    assert(v1_id == v_id);
+    utils::unused_variable(v_id);
+    int num_states = incoming.size();
+    assert(v2_id == num_states - 1);
+    int old_distance = goal_distances[v1_id];
+    goal_distances.resize(num_states, old_distance);
+    shortest_path.resize(num_states, NO_TRANSITION);
+    dirty.resize(num_states, false);
+
+    if (old_distance == INF) {
+        // Dead ends stay dead ends and are not on any shortest path.
+        assert(goal_distances[v2_id] == INF);
+        shortest_path[v1_id] = NO_TRANSITION;
+        return;
+    }
+
+    /*
+      Shortest paths that used a transition u->v now use u->v1 if it
+      exists and u->v2 otherwise.
+    */
+    for (const Transition &transition : incoming[v2_id]) {
+        int u_id = transition.target_id;
+        Transition transition_to_v1(transition.op_id, v1_id);
+        TransitionLists::Range u_outgoing = outgoing[u_id];
+        if (is_on_shortest_path(u_id, transition_to_v1) &&
+            find(u_outgoing.begin(), u_outgoing.end(), transition_to_v1) ==
+            u_outgoing.end()) {
+            shortest_path[u_id] = Transition(transition.op_id, v2_id);
+        }
+    }
+
+    for (int state_id : {v1_id, v2_id}) {
+        if (goals.count(state_id)) {
+            goal_distances[state_id] = 0;
+            shortest_path[state_id] = NO_TRANSITION;
+            continue;
+        }
+        bool keeps_distance = find_shortest_path_keeping_distance(
+            outgoing[state_id], state_id, v1_id, v2_id, old_distance);
+        if (!keeps_distance) {
+            mark_dirty(state_id);
+        }
+    }
+
+    if (!dirty_states.empty()) {
+        repair_dirty_states(incoming, outgoing);
+    }
+}
+
+unique_ptr<Solution> ShortestPaths::extract_solution(
+    int init_id, const Goals &goals) const {
+    if (goal_distances[init_id] == INF)
+        return nullptr;
+    unique_ptr<Solution> solution = utils::make_unique_ptr<Solution>();
+    int current_id = init_id;
+    while (!goals.count(current_id)) {
+        const Transition &transition = shortest_path[current_id];
+        assert(transition.target_id != UNDEFINED);
+        assert(goal_distances[transition.target_id] <= goal_distances[current_id]);
+        solution->push_back(transition);
+        current_id = transition.target_id;
+    }
+    return solution;
+}
+
+int ShortestPaths::get_goal_distance(int state_id) const {
+    assert(utils::in_bounds(state_id, goal_distances));
+    return goal_distances[state_id];
+}
+}
@@ -0,0 +1,76 @@
+#ifndef CEGAR_SHORTEST_PATHS_H
+#define CEGAR_SHORTEST_PATHS_H
+
+#include "abstract_search.h"
+#include "adjacency_lists.h"
+#include "transition.h"
+#include "types.h"
+
+#include "../algorithms/priority_queues.h"
+
+#include <memory>
+#include <vector>
+
+namespace cegar {
+/*
+  Maintain goal distances and shortest paths to the goal for all states
+  of an abstraction while it is being refined.
+
+  Splitting a state never decreases goal distances. Therefore, after
+  splitting v into v1 and v2, the old distance of a state u is still
+  correct if the shortest path stored for u still exists and does not
+  pass through a state whose distance increased. We mark all states for
+  which this cannot be guaranteed as dirty and recompute their distances
+  with a Dijkstra search that is restricted to the dirty states. Abstract
+  solutions are obtained by following the stored shortest paths, i.e., by
+  an A* search with the perfect heuristic that never expands any state
+  off the solution path.
+
+  See Seipp, von Allmen and Helmert (ICAPS 2020) for a similar approach.
+*/
+class ShortestPaths {
+    const std::vector<int> operator_costs;
+
+    std::vector<int> goal_distances;
+    // First transition on a shortest path to a goal (undefined for goals
+    // and dead ends).
+    Transitions shortest_path;
+
+    // Keep data structures around to avoid reallocating them.
+    priority_queues::AdaptiveQueue<int> open_queue;
+    std::vector<bool> dirty;
+    std::vector<int> dirty_states;
+
+    int add_costs(int op_id, int distance) const;
+    bool is_on_shortest_path(int u_id, const Transition &transition_to_v) const;
+    void mark_dirty(int state_id);
+    bool find_shortest_path_keeping_distance(
+        TransitionLists::Range outgoing, int state_id, int v1_id, int v2_id,
+        int old_distance);
+    void repair_dirty_states(
+        const TransitionLists &incoming,
+        const TransitionLists &outgoing);
+
+public:
+    explicit ShortestPaths(const std::vector<int> &operator_costs);
+
+    // Compute goal distances from scratch.
+    void recompute(
+        const TransitionLists &incoming,
+        const Goals &goals);
+
+    // Update goal distances after state v has been split into v1 and v2.
+    void update_incrementally(
+        const TransitionLists &incoming,
+        const TransitionLists &outgoing,
+        int v_id, int v1_id, int v2_id,
+        const Goals &goals);
+
+    // Return nullptr if no goal is reachable from the given state.
+    std::unique_ptr<Solution> extract_solution(int init_id, const Goals &goals) const;
+
+    int get_goal_distance(int state_id) const;
+};
+}
+
+#endif
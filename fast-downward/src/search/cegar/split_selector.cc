@@ -5,6 +5,8 @@
 
 #include "../heuristics/additive_heuristic.h"
 
+#include "../tasks/frozen_task.h"
+
 #include "../utils/logging.h"
 #include "../utils/rng.h"
 
@@ -16,7 +18,7 @@ using namespace std;
 
 namespace cegar {
 SplitSelector::SplitSelector(
-    const shared_ptr<AbstractTask> &task,
+    const shared_ptr<tasks::FrozenTask> &task,
     PickSplit pick)
     : task(task),
       task_proxy(*task),
@@ -40,7 +42,7 @@ int SplitSelector::get_num_unwanted_values(
 }
 
 double SplitSelector::get_refinedness(const AbstractState &state, int var_id) const {
-    double all_values = task_proxy.get_variables()[var_id].get_domain_size();
+    double all_values = task->get_variable_domain_size(var_id);
     assert(all_values >= 2);
     double remaining_values = state.count(var_id);
     assert(2 <= remaining_values && remaining_values <= all_values);
@@ -10,6 +10,10 @@ namespace additive_heuristic {
 class AdditiveHeuristic;
 }
 
+namespace tasks {
+class FrozenTask;
+}
+
 namespace utils {
 class RandomNumberGenerator;
 }
@@ -46,7 +50,7 @@ struct Split {
   Select split in case there are multiple possible splits.
 */
 class SplitSelector {
-    const std::shared_ptr<AbstractTask> task;
+    const std::shared_ptr<tasks::FrozenTask> task;
     const TaskProxy task_proxy;
     std::unique_ptr<additive_heuristic::AdditiveHeuristic> additive_heuristic;
 
@@ -61,7 +65,7 @@ class SplitSelector {
     double rate_split(const AbstractState &state, const Split &split) const;
 
 public:
-    SplitSelector(const std::shared_ptr<AbstractTask> &task, PickSplit pick);
+    SplitSelector(const std::shared_ptr<tasks::FrozenTask> &task, PickSplit pick);
     ~SplitSelector();
 
     const Split &pick_split(
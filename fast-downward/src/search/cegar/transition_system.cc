@@ -6,7 +6,7 @@
 
 #include "../task_proxy.h"
 
-#include "../task_utils/task_properties.h"
+#include "../tasks/frozen_task.h"
 
 #include <algorithm>
 #include <map>
@@ -15,11 +15,13 @@ using namespace std;
 
 namespace cegar {
 static vector<vector<FactPair>> get_preconditions_by_operator(
-    const OperatorsProxy &ops) {
+    const tasks::FrozenTask &task) {
+    int num_operators = task.get_num_operators();
     vector<vector<FactPair>> preconditions_by_operator;
-    preconditions_by_operator.reserve(ops.size());
-    for (OperatorProxy op : ops) {
-        vector<FactPair> preconditions = task_properties::get_fact_pairs(op.get_preconditions());
+    preconditions_by_operator.reserve(num_operators);
+    for (int op_id = 0; op_id < num_operators; ++op_id) {
+        tasks::FactPairRange range = task.get_preconditions(op_id, false);
+        vector<FactPair> preconditions(range.begin(), range.end());
         sort(preconditions.begin(), preconditions.end());
         preconditions_by_operator.push_back(move(preconditions));
     }
@@ -27,14 +29,13 @@ static vector<vector<FactPair>> get_preconditions_by_operator(
 }
 
 static vector<FactPair> get_postconditions(
-    const OperatorProxy &op) {
+    const tasks::FrozenTask &task, int op_id) {
     // Use map to obtain sorted postconditions.
     map<int, int> var_to_post;
-    for (FactProxy fact : op.get_preconditions()) {
-        var_to_post[fact.get_variable().get_id()] = fact.get_value();
+    for (const FactPair &fact : task.get_preconditions(op_id, false)) {
+        var_to_post[fact.var] = fact.value;
     }
-    for (EffectProxy effect : op.get_effects()) {
-        FactPair fact = effect.get_fact().get_pair();
+    for (const FactPair &fact : task.get_effect_facts(op_id, false)) {
         var_to_post[fact.var] = fact.value;
     }
     vector<FactPair> postconditions;
@@ -46,11 +47,12 @@ static vector<FactPair> get_postconditions(
 }
 
 static vector<vector<FactPair>> get_postconditions_by_operator(
-    const OperatorsProxy &ops) {
+    const tasks::FrozenTask &task) {
+    int num_operators = task.get_num_operators();
     vector<vector<FactPair>> postconditions_by_operator;
-    postconditions_by_operator.reserve(ops.size());
-    for (OperatorProxy op : ops) {
-        postconditions_by_operator.push_back(get_postconditions(op));
+    postconditions_by_operator.reserve(num_operators);
+    for (int op_id = 0; op_id < num_operators; ++op_id) {
+        postconditions_by_operator.push_back(get_postconditions(task, op_id));
     }
     return postconditions_by_operator;
 }
@@ -67,19 +69,9 @@ static int lookup_value(const vector<FactPair> &facts, int var) {
     return UNDEFINED;
 }
 
-static void remove_transitions_with_given_target(
-    Transitions &transitions, int state_id) {
-    auto new_end = remove_if(
-        transitions.begin(), transitions.end(),
-        [state_id](const Transition &t) {return t.target_id == state_id;});
-    assert(new_end != transitions.end());
-    transitions.erase(new_end, transitions.end());
-}
-
-
-TransitionSystem::TransitionSystem(const OperatorsProxy &ops)
-    : preconditions_by_operator(get_preconditions_by_operator(ops)),
-      postconditions_by_operator(get_postconditions_by_operator(ops)),
+TransitionSystem::TransitionSystem(const tasks::FrozenTask &task)
+    : preconditions_by_operator(get_preconditions_by_operator(task)),
+      postconditions_by_operator(get_postconditions_by_operator(task)),
       num_non_loops(0),
       num_loops(0) {
     add_loops_in_trivial_abstraction();
@@ -94,10 +86,9 @@ int TransitionSystem::get_postcondition_value(int op_id, int var) const {
 }
 
 void TransitionSystem::enlarge_vectors_by_one() {
-    int new_num_states = get_num_states() + 1;
-    outgoing.resize(new_num_states);
-    incoming.resize(new_num_states);
-    loops.resize(new_num_states);
+    outgoing.add_list();
+    incoming.add_list();
+    loops.add_list();
 }
 
 void TransitionSystem::add_loops_in_trivial_abstraction() {
@@ -111,128 +102,195 @@ void TransitionSystem::add_loops_in_trivial_abstraction() {
 
 void TransitionSystem::add_transition(int src_id, int op_id, int target_id) {
     assert(src_id != target_id);
-    outgoing[src_id].emplace_back(op_id, target_id);
-    incoming[target_id].emplace_back(op_id, src_id);
+    outgoing.push_back(src_id, Transition(op_id, target_id));
+    incoming.push_back(target_id, Transition(op_id, src_id));
     ++num_non_loops;
 }
 
 void TransitionSystem::add_loop(int state_id, int op_id) {
     assert(utils::in_bounds(state_id, loops));
-    loops[state_id].push_back(op_id);
+    loops.push_back(state_id, op_id);
     ++num_loops;
 }
 
+pair<bool, bool> TransitionSystem::get_targets_after_split(
+    const AbstractState &u, int op_id,
+    const AbstractState &v1, const AbstractState &v2, int var) const {
+    /* Transition u->v with operator op: return whether op leads from u
+       to v1 and whether it leads from u to v2 after v has been split. */
+    int post = get_postcondition_value(op_id, var);
+    if (post == UNDEFINED) {
+        // op has no precondition and no effect on var.
+        bool u_and_v1_intersect = u.domain_subsets_intersect(v1, var);
+        /* If u and v1 don't intersect, op must lead to v2 and we can
+           avoid an intersection test. */
+        return make_pair(
+            u_and_v1_intersect,
+            !u_and_v1_intersect || u.domain_subsets_intersect(v2, var));
+    } else if (v1.contains(var, post)) {
+        // op can only end in v1.
+        return make_pair(true, false);
+    } else {
+        // op can only end in v2.
+        assert(v2.contains(var, post));
+        return make_pair(false, true);
+    }
+}
+
+pair<bool, bool> TransitionSystem::get_sources_after_split(
+    const AbstractState &w, int op_id,
+    const AbstractState &v1, const AbstractState &v2, int var) const {
+    /* Transition v->w with operator op: return whether op leads from v1
+       to w and whether it leads from v2 to w after v has been split. */
+    int pre = get_precondition_value(op_id, var);
+    int post = get_postcondition_value(op_id, var);
+    if (post == UNDEFINED) {
+        assert(pre == UNDEFINED);
+        // op has no precondition and no effect on var.
+        bool v1_and_w_intersect = v1.domain_subsets_intersect(w, var);
+        /* If v1 and w don't intersect, op must start in v2 and we can
+           avoid an intersection test. */
+        return make_pair(
+            v1_and_w_intersect,
+            !v1_and_w_intersect || v2.domain_subsets_intersect(w, var));
+    } else if (pre == UNDEFINED) {
+        // op has no precondition, but an effect on var.
+        return make_pair(true, true);
+    } else if (v1.contains(var, pre)) {
+        // op can only start in v1.
+        return make_pair(true, false);
+    } else {
+        // op can only start in v2.
+        assert(v2.contains(var, pre));
+        return make_pair(false, true);
+    }
+}
+
 void TransitionSystem::rewire_incoming_transitions(
-    const Transitions &old_incoming, const AbstractStates &states,
+    const AbstractStates &states,
     const AbstractState &v1, const AbstractState &v2, int var) {
     /* State v has been split into v1 and v2. Now for all transitions
-       u->v we need to add transitions u->v1, u->v2, or both. */
+       u->v we need to add transitions u->v1, u->v2, or both. Since v1
+       reuses the ID of v, we update the transitions in place: u->v
+       stays u->v1, is redirected to v2 or is duplicated for v2.
+
+       Adding transitions to a list can move it, so we iterate by index
+       over lists that grow in the meantime. */
     int v1_id = v1.get_id();
     int v2_id = v2.get_id();
 
     unordered_set<int> updated_states;
-    for (const Transition &transition : old_incoming) {
+    // Only outgoing transitions are added here, so iterating over incoming is safe.
+    for (const Transition &transition : incoming[v1_id]) {
         int u_id = transition.target_id;
         bool is_new_state = updated_states.insert(u_id).second;
-        if (is_new_state) {
-            remove_transitions_with_given_target(outgoing[u_id], v1_id);
+        if (!is_new_state)
+            continue;
+        const AbstractState &u = *states[u_id];
+        // Transitions added to v2 are appended and need no update.
+        int num_old_transitions = outgoing[u_id].size();
+        for (int i = 0; i < num_old_transitions; ++i) {
+            const Transition &u_transition = outgoing[u_id][i];
+            if (u_transition.target_id != v1_id)
+                continue;
+            int op_id = u_transition.op_id;
+            pair<bool, bool> targets = get_targets_after_split(u, op_id, v1, v2, var);
+            if (!targets.first) {
+                outgoing.set(u_id, i, Transition(op_id, v2_id));
+            } else if (targets.second) {
+                outgoing.push_back(u_id, Transition(op_id, v2_id));
+            }
         }
     }
-    num_non_loops -= old_incoming.size();
 
-    for (const Transition &transition : old_incoming) {
-        int op_id = transition.op_id;
-        int u_id = transition.target_id;
-        const AbstractState &u = *states[u_id];
-        int post = get_postcondition_value(op_id, var);
-        if (post == UNDEFINED) {
-            // op has no precondition and no effect on var.
-            bool u_and_v1_intersect = u.domain_subsets_intersect(v1, var);
-            if (u_and_v1_intersect) {
-                add_transition(u_id, op_id, v1_id);
-            }
-            /* If u and v1 don't intersect, we must add the other transition
-               and can avoid an intersection test. */
-            if (!u_and_v1_intersect || u.domain_subsets_intersect(v2, var)) {
-                add_transition(u_id, op_id, v2_id);
-            }
-        } else if (v1.contains(var, post)) {
-            // op can only end in v1.
-            add_transition(u_id, op_id, v1_id);
-        } else {
-            // op can only end in v2.
-            assert(v2.contains(var, post));
-            add_transition(u_id, op_id, v2_id);
+    int num_old_transitions = incoming[v1_id].size();
+    int num_v1_transitions = 0;
+    for (int i = 0; i < num_old_transitions; ++i) {
+        const Transition transition = incoming[v1_id][i];
+        const AbstractState &u = *states[transition.target_id];
+        pair<bool, bool> targets = get_targets_after_split(
+            u, transition.op_id, v1, v2, var);
+        if (targets.first) {
+            incoming.set(v1_id, num_v1_transitions++, transition);
+        }
+        if (targets.second) {
+            incoming.push_back(v2_id, transition);
         }
     }
+    num_non_loops += num_v1_transitions + incoming[v2_id].size();
+    num_non_loops -= num_old_transitions;
+    incoming.truncate(v1_id, num_v1_transitions);
 }
 
 void TransitionSystem::rewire_outgoing_transitions(
-    const Transitions &old_outgoing, const AbstractStates &states,
+    const AbstractStates &states,
     const AbstractState &v1, const AbstractState &v2, int var) {
     /* State v has been split into v1 and v2. Now for all transitions
-       v->w we need to add transitions v1->w, v2->w, or both. */
+       v->w we need to add transitions v1->w, v2->w, or both. As above,
+       we update the transitions in place. */
     int v1_id = v1.get_id();
     int v2_id = v2.get_id();
 
     unordered_set<int> updated_states;
-    for (const Transition &transition : old_outgoing) {
+    // Only incoming transitions are added here, so iterating over outgoing is safe.
+    for (const Transition &transition : outgoing[v1_id]) {
         int w_id = transition.target_id;
         bool is_new_state = updated_states.insert(w_id).second;
-        if (is_new_state) {
-            remove_transitions_with_given_target(incoming[w_id], v1_id);
+        if (!is_new_state)
+            continue;
+        const AbstractState &w = *states[w_id];
+        int num_old_transitions = incoming[w_id].size();
+        for (int i = 0; i < num_old_transitions; ++i) {
+            const Transition &w_transition = incoming[w_id][i];
+            if (w_transition.target_id != v1_id)
+                continue;
+            int op_id = w_transition.op_id;
+            pair<bool, bool> sources = get_sources_after_split(w, op_id, v1, v2, var);
+            if (!sources.first) {
+                incoming.set(w_id, i, Transition(op_id, v2_id));
+            } else if (sources.second) {
+                incoming.push_back(w_id, Transition(op_id, v2_id));
+            }
         }
     }
-    num_non_loops -= old_outgoing.size();
 
-    for (const Transition &transition : old_outgoing) {
-        int op_id = transition.op_id;
-        int w_id = transition.target_id;
-        const AbstractState &w = *states[w_id];
-        int pre = get_precondition_value(op_id, var);
-        int post = get_postcondition_value(op_id, var);
-        if (post == UNDEFINED) {
-            assert(pre == UNDEFINED);
-            // op has no precondition and no effect on var.
-            bool v1_and_w_intersect = v1.domain_subsets_intersect(w, var);
-            if (v1_and_w_intersect) {
-                add_transition(v1_id, op_id, w_id);
-            }
-            /* If v1 and w don't intersect, we must add the other transition
-               and can avoid an intersection test. */
-            if (!v1_and_w_intersect || v2.domain_subsets_intersect(w, var)) {
-                add_transition(v2_id, op_id, w_id);
-            }
-        } else if (pre == UNDEFINED) {
-            // op has no precondition, but an effect on var.
-            add_transition(v1_id, op_id, w_id);
-            add_transition(v2_id, op_id, w_id);
-        } else if (v1.contains(var, pre)) {
-            // op can only start in v1.
-            add_transition(v1_id, op_id, w_id);
-        } else {
-            // op can only start in v2.
-            assert(v2.contains(var, pre));
-            add_transition(v2_id, op_id, w_id);
+    int num_old_transitions = outgoing[v1_id].size();
+    int num_v1_transitions = 0;
+    for (int i = 0; i < num_old_transitions; ++i) {
+        const Transition transition = outgoing[v1_id][i];
+        const AbstractState &w = *states[transition.target_id];
+        pair<bool, bool> sources = get_sources_after_split(
+            w, transition.op_id, v1, v2, var);
+        if (sources.first) {
+            outgoing.set(v1_id, num_v1_transitions++, transition);
+        }
+        if (sources.second) {
+            outgoing.push_back(v2_id, transition);
         }
     }
+    num_non_loops += num_v1_transitions + outgoing[v2_id].size();
+    num_non_loops -= num_old_transitions;
+    outgoing.truncate(v1_id, num_v1_transitions);
 }
 
 void TransitionSystem::rewire_loops(
-    const Loops &old_loops, const AbstractState &v1, const AbstractState &v2, int var) {
+    const AbstractState &v1, const AbstractState &v2, int var) {
     /* State v has been split into v1 and v2. Now for all self-loops
        v->v we need to add one or two of the transitions v1->v1, v1->v2,
-       v2->v1 and v2->v2. */
+       v2->v1 and v2->v2. The self-loops of v1 are filtered in place. */
     int v1_id = v1.get_id();
     int v2_id = v2.get_id();
-    for (int op_id : old_loops) {
+    int num_old_loops = loops[v1_id].size();
+    int num_v1_loops = 0;
+    for (int i = 0; i < num_old_loops; ++i) {
+        int op_id = loops[v1_id][i];
         int pre = get_precondition_value(op_id, var);
         int post = get_postcondition_value(op_id, var);
         if (pre == UNDEFINED) {
             // op has no precondition on var --> it must start in v1 and v2.
             if (post == UNDEFINED) {
                 // op has no effect on var --> it must end in v1 and v2.
-                add_loop(v1_id, op_id);
+                loops.set(v1_id, num_v1_loops++, op_id);
                 add_loop(v2_id, op_id);
             } else if (v2.contains(var, post)) {
                 // op must end in v2.
@@ -241,7 +299,7 @@ void TransitionSystem::rewire_loops(
             } else {
                 // op must end in v1.
                 assert(v1.contains(var, post));
-                add_loop(v1_id, op_id);
+                loops.set(v1_id, num_v1_loops++, op_id);
                 add_transition(v2_id, op_id, v1_id);
             }
         } else if (v1.contains(var, pre)) {
@@ -249,7 +307,7 @@ void TransitionSystem::rewire_loops(
             assert(post != UNDEFINED);
             if (v1.contains(var, post)) {
                 // op must end in v1.
-                add_loop(v1_id, op_id);
+                loops.set(v1_id, num_v1_loops++, op_id);
             } else {
                 // op must end in v2.
                 assert(v2.contains(var, post));
@@ -269,39 +327,40 @@ void TransitionSystem::rewire_loops(
             }
         }
     }
-    num_loops -= old_loops.size();
+    num_loops += num_v1_loops - num_old_loops;
+    loops.truncate(v1_id, num_v1_loops);
 }
 
 void TransitionSystem::rewire(
     const AbstractStates &states, int v_id,
     const AbstractState &v1, const AbstractState &v2, int var) {
-    // Retrieve old transitions and make space for new transitions.
-    Transitions old_incoming = move(incoming[v_id]);
-    Transitions old_outgoing = move(outgoing[v_id]);
-    Loops old_loops = move(loops[v_id]);
+    /* State v1 reuses the ID of v and therefore also its transitions,
+       which are rewired in place. This avoids copying and reallocating
+       the (often long) transition vectors of v and its neighbors. */
     enlarge_vectors_by_one();
     int v1_id = v1.get_id();
     int v2_id = v2.get_id();
+    utils::unused_variable(v_id);
     utils::unused_variable(v1_id);
     utils::unused_variable(v2_id);
-    assert(incoming[v1_id].empty() && outgoing[v1_id].empty() && loops[v1_id].empty());
+    assert(v1_id == v_id);
     assert(incoming[v2_id].empty() && outgoing[v2_id].empty() && loops[v2_id].empty());
 
-    // Remove old transitions and add new transitions.
-    rewire_incoming_transitions(old_incoming, states, v1, v2, var);
-    rewire_outgoing_transitions(old_outgoing, states, v1, v2, var);
-    rewire_loops(old_loops, v1, v2, var);
+    // Update old transitions and add new transitions.
+    rewire_incoming_transitions(states, v1, v2, var);
+    rewire_outgoing_transitions(states, v1, v2, var);
+    rewire_loops(v1, v2, var);
 }
 
-const vector<Transitions> &TransitionSystem::get_incoming_transitions() const {
+const TransitionLists &TransitionSystem::get_incoming_transitions() const {
     return incoming;
 }
 
-const vector<Transitions> &TransitionSystem::get_outgoing_transitions() const {
+const TransitionLists &TransitionSystem::get_outgoing_transitions() const {
     return outgoing;
 }
 
-const vector<Loops> &TransitionSystem::get_loops() const {
+const LoopLists &TransitionSystem::get_loops() const {
     return loops;
 }
 
@@ -323,6 +382,12 @@ int TransitionSystem::get_num_loops() const {
     return num_loops;
 }
 
+size_t TransitionSystem::estimate_memory_usage_in_bytes() const {
+    return incoming.estimate_memory_usage_in_bytes() +
+           outgoing.estimate_memory_usage_in_bytes() +
+           loops.estimate_memory_usage_in_bytes();
+}
+
 void TransitionSystem::print_statistics() const {
     int total_incoming_transitions = 0;
     int total_outgoing_transitions = 0;
@@ -337,5 +402,7 @@ void TransitionSystem::print_statistics() const {
     assert(get_num_non_loops() == total_outgoing_transitions);
     cout << "Looping transitions: " << total_loops << endl;
     cout << "Non-looping transitions: " << total_outgoing_transitions << endl;
+    cout << "Transition system memory: "
+         << estimate_memory_usage_in_bytes() / 1024 << " KB" << endl;
 }
 }
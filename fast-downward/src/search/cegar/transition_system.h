@@ -1,12 +1,18 @@
 #ifndef CEGAR_TRANSITION_SYSTEM_H
 #define CEGAR_TRANSITION_SYSTEM_H
 
+#include "adjacency_lists.h"
+#include "transition.h"
 #include "types.h"
 
+#include <utility>
 #include <vector>
 
 struct FactPair;
-class OperatorsProxy;
+
+namespace tasks {
+class FrozenTask;
+}
 
 namespace cegar {
 /*
@@ -16,12 +22,16 @@ class TransitionSystem {
     const std::vector<std::vector<FactPair>> preconditions_by_operator;
     const std::vector<std::vector<FactPair>> postconditions_by_operator;
 
-    // Transitions from and to other abstract states.
-    std::vector<Transitions> incoming;
-    std::vector<Transitions> outgoing;
+    /*
+      Transitions from and to other abstract states. The transition
+      lists of all states share slabs and reuse the blocks of the
+      states' old transition lists after splits.
+    */
+    TransitionLists incoming;
+    TransitionLists outgoing;
 
     // Store self-loops (operator indices) separately to save space.
-    std::vector<Loops> loops;
+    LoopLists loops;
 
     int num_non_loops;
     int num_loops;
@@ -37,33 +47,42 @@ class TransitionSystem {
     void add_transition(int src_id, int op_id, int target_id);
     void add_loop(int state_id, int op_id);
 
+    std::pair<bool, bool> get_targets_after_split(
+        const AbstractState &u, int op_id,
+        const AbstractState &v1, const AbstractState &v2, int var) const;
+    std::pair<bool, bool> get_sources_after_split(
+        const AbstractState &w, int op_id,
+        const AbstractState &v1, const AbstractState &v2, int var) const;
+
     void rewire_incoming_transitions(
-        const Transitions &old_incoming, const AbstractStates &states,
+        const AbstractStates &states,
         const AbstractState &v1, const AbstractState &v2, int var);
     void rewire_outgoing_transitions(
-        const Transitions &old_outgoing, const AbstractStates &states,
+        const AbstractStates &states,
         const AbstractState &v1, const AbstractState &v2, int var);
     void rewire_loops(
-        const Loops &old_loops,
         const AbstractState &v1, const AbstractState &v2, int var);
 
 public:
-    explicit TransitionSystem(const OperatorsProxy &ops);
+    explicit TransitionSystem(const tasks::FrozenTask &task);
 
     // Update transition system after v has been split for var into v1 and v2.
     void rewire(
         const AbstractStates &states, int v_id,
         const AbstractState &v1, const AbstractState &v2, int var);
 
-    const std::vector<Transitions> &get_incoming_transitions() const;
-    const std::vector<Transitions> &get_outgoing_transitions() const;
-    const std::vector<Loops> &get_loops() const;
+    const TransitionLists &get_incoming_transitions() const;
+    const TransitionLists &get_outgoing_transitions() const;
+    const LoopLists &get_loops() const;
 
     int get_num_states() const;
     int get_num_operators() const;
     int get_num_non_loops() const;
     int get_num_loops() const;
 
+    // Return memory used by the transition lists, including unused blocks.
+    size_t estimate_memory_usage_in_bytes() const;
+
     void print_statistics() const;
 };
 }
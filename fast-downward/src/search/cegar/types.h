@@ -8,13 +8,16 @@
 
 namespace cegar {
 class AbstractState;
+template<typename Value>
+class AdjacencyLists;
 struct Transition;
 
 using AbstractStates = std::vector<std::unique_ptr<AbstractState>>;
 using Goals = std::unordered_set<int>;
 using NodeID = int;
-using Loops = std::vector<int>;
 using Transitions = std::vector<Transition>;
+using TransitionLists = AdjacencyLists<Transition>;
+using LoopLists = AdjacencyLists<int>;
 
 const int UNDEFINED = -1;
 
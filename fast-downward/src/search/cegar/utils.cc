@@ -18,6 +18,7 @@ unique_ptr<additive_heuristic::AdditiveHeuristic> create_additive_heuristic(
     Options opts;
     opts.set<shared_ptr<AbstractTask>>("transform", task);
     opts.set<bool>("cache_estimates", false);
+    opts.set<bool>("incremental", false);
     return utils::make_unique_ptr<additive_heuristic::AdditiveHeuristic>(opts);
 }
 
@@ -2,6 +2,7 @@
 
 #include "option_parser.h"
 #include "plan_manager.h"
+#include "plan_stream.h"
 #include "search_engine.h"
 
 #include "options/doc_printer.h"
@@ -46,6 +47,9 @@ static shared_ptr<SearchEngine> parse_cmd_line_aux(
     string plan_filename = "sas_plan";
     int num_previously_generated_plans = 0;
     bool is_part_of_anytime_portfolio = false;
+    string plan_stream_target;
+    bool use_atomic_plan_files = false;
+    bool sync_plan_files = false;
     options::Predefinitions predefinitions;
 
     shared_ptr<SearchEngine> engine;
@@ -105,6 +109,15 @@ static shared_ptr<SearchEngine> parse_cmd_line_aux(
             num_previously_generated_plans = parse_int_arg(arg, args[i]);
             if (num_previously_generated_plans < 0)
                 throw ArgError("argument for --internal-previous-portfolio-plans must be positive");
+        } else if (arg == "--plan-stream") {
+            if (is_last)
+                throw ArgError("missing argument after --plan-stream");
+            ++i;
+            plan_stream_target = args[i];
+        } else if (arg == "--atomic-plan-files") {
+            use_atomic_plan_files = true;
+        } else if (arg == "--sync-plans") {
+            sync_plan_files = true;
         } else if (utils::startswith(arg, "--") &&
                    registry.is_predefinition(arg.substr(2))) {
             if (is_last)
@@ -123,6 +136,12 @@ static shared_ptr<SearchEngine> parse_cmd_line_aux(
         plan_manager.set_plan_filename(plan_filename);
         plan_manager.set_num_previously_generated_plans(num_previously_generated_plans);
         plan_manager.set_is_part_of_anytime_portfolio(is_part_of_anytime_portfolio);
+        plan_manager.set_use_atomic_plan_files(use_atomic_plan_files);
+        plan_manager.set_sync_plan_files(sync_plan_files);
+        if (!plan_stream_target.empty()) {
+            plan_manager.set_plan_stream(
+                make_shared<PlanStream>(plan_stream_target, sync_plan_files));
+        }
     }
     return engine;
 }
@@ -154,7 +173,10 @@ string usage(const string &progname) {
     return "usage: \n" +
            progname + " [OPTIONS] --search SEARCH < OUTPUT\n\n"
            "* SEARCH (SearchEngine): configuration of the search algorithm\n"
-           "* OUTPUT (filename): translator output\n\n"
+           "* OUTPUT (filename): translator output or binary task file\n\n" +
+           progname + " --write-binary-task FILENAME < OUTPUT\n\n"
+           "* Converts translator output to a binary task file FILENAME, which\n"
+           "  can be memory-mapped and is read faster than translator output.\n\n"
            "Options:\n"
            "--help [NAME]\n"
            "    Prints help for all heuristics, open lists, etc. called NAME.\n"
@@ -171,5 +193,16 @@ string usage(const string &progname) {
            "    This planner call is part of a portfolio which already created\n"
            "    plan files FILENAME.1 up to FILENAME.COUNTER.\n"
            "    Start enumerating plan files with COUNTER+1, i.e. FILENAME.COUNTER+1\n\n"
+           "--plan-stream TARGET\n"
+           "    Additionally report every plan as soon as it is saved as one line\n"
+           "    of JSON with its number, cost, length, time and operators.\n"
+           "    TARGET is a file or FIFO, which is opened for appending, or\n"
+           "    unix:PATH for a listening Unix domain socket at PATH.\n\n"
+           "--atomic-plan-files\n"
+           "    Write plan files to FILENAME.tmp first and rename them afterwards,\n"
+           "    so that other processes never read incomplete plans.\n\n"
+           "--sync-plans\n"
+           "    Flush plan files and plan stream files to disk with fsync\n"
+           "    before reporting the plan.\n\n"
            "See http://www.fast-downward.org/ for details.";
 }
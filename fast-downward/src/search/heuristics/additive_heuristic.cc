@@ -15,8 +15,21 @@ namespace additive_heuristic {
 // construction and destruction
 AdditiveHeuristic::AdditiveHeuristic(const Options &opts)
     : RelaxationHeuristic(opts),
-      did_write_overflow_warning(false) {
+      did_write_overflow_warning(false),
+      incremental(opts.get<bool>("incremental")),
+      max_repair_work(0) {
     cout << "Initializing additive heuristic..." << endl;
+    if (incremental) {
+        build_achievers();
+        is_candidate.resize(propositions.size(), false);
+        is_affected.resize(propositions.size(), false);
+        /*
+          Repairing costs is more expensive per step than the exploration
+          from scratch, so we give up once half of the work of a full
+          computation is reached.
+        */
+        max_repair_work = (propositions.size() + unary_operators.size()) / 2;
+    }
 }
 
 void AdditiveHeuristic::write_overflow_warning() {
@@ -58,7 +71,11 @@ void AdditiveHeuristic::setup_exploration_queue_state(const State &state) {
 }
 
 void AdditiveHeuristic::relaxed_exploration() {
-    int unsolved_goals = goal_propositions.size();
+    /*
+      In incremental mode, all propositions need their final costs for
+      later repairs, so we cannot stop when all goals are reached.
+    */
+    int unsolved_goals = incremental ? -1 : goal_propositions.size();
     while (!queue.empty()) {
         pair<int, PropID> top_pair = queue.pop();
         int distance = top_pair.first;
@@ -110,10 +127,195 @@ void AdditiveHeuristic::mark_preferred_operators(
     }
 }
 
+void AdditiveHeuristic::build_achievers() {
+    vector<vector<OpID>> achievers_vectors(propositions.size());
+    int num_unary_ops = unary_operators.size();
+    for (OpID op_id = 0; op_id < num_unary_ops; ++op_id)
+        achievers_vectors[unary_operators[op_id].effect].push_back(op_id);
+
+    achievers.reserve(propositions.size());
+    num_achievers.reserve(propositions.size());
+    for (const vector<OpID> &achievers_vector : achievers_vectors) {
+        achievers.push_back(achievers_pool.append(achievers_vector));
+        num_achievers.push_back(achievers_vector.size());
+    }
+}
+
+int AdditiveHeuristic::compute_unary_operator_cost(OpID op_id) {
+    int cost = get_operator(op_id)->base_cost;
+    for (PropID precond : get_preconditions(op_id)) {
+        int precond_cost = get_proposition(precond)->cost;
+        if (precond_cost == -1)
+            return -1;
+        increase_cost(cost, precond_cost);
+    }
+    return cost;
+}
+
+OpID AdditiveHeuristic::find_unaffected_supporter(
+    PropID prop_id, int max_cost) {
+    for (OpID op_id : achievers_pool.get_slice(
+             achievers[prop_id], num_achievers[prop_id])) {
+        int op_cost = get_operator(op_id)->base_cost;
+        bool usable = true;
+        for (PropID precond_id : get_preconditions(op_id)) {
+            int precond_cost = get_proposition(precond_id)->cost;
+            if (is_affected[precond_id] || precond_cost == -1 ||
+                precond_cost >= max_cost) {
+                usable = false;
+                break;
+            }
+            increase_cost(op_cost, precond_cost);
+        }
+        if (usable && op_cost <= max_cost)
+            return op_id;
+    }
+    return NO_OP;
+}
+
+bool AdditiveHeuristic::repair_costs(const State &state) {
+    const vector<int> &values = state.get_values();
+    int num_vars = values.size();
+    assert(static_cast<int>(previous_state_values.size()) == num_vars);
+    queue.clear();
+
+    // Facts that became true have cost 0 and no supporter.
+    decreased_propositions.clear();
+    for (int var = 0; var < num_vars; ++var) {
+        if (values[var] != previous_state_values[var]) {
+            PropID prop_id = get_prop_id(var, values[var]);
+            Proposition *prop = get_proposition(prop_id);
+            prop->cost = 0;
+            prop->reached_by = NO_OP;
+            decreased_propositions.push_back(prop_id);
+        }
+    }
+
+    /*
+      Invalidate all propositions whose supporters (transitively) depend
+      on a fact that is no longer true, unless they have another
+      unaffected supporter that is at most as expensive. We process
+      candidates in the order of their old costs. Supporters are only
+      considered if all their preconditions are cheaper than the
+      candidate, which guarantees that the preconditions have already
+      been decided.
+
+      All propositions that are not invalidated keep costs that can
+      still be achieved, so their costs can only decrease.
+    */
+    candidate_propositions.clear();
+    affected_propositions.clear();
+    for (int var = 0; var < num_vars; ++var) {
+        if (values[var] != previous_state_values[var]) {
+            PropID prop_id = get_prop_id(var, previous_state_values[var]);
+            is_candidate[prop_id] = true;
+            candidate_propositions.push_back(prop_id);
+            queue.push(0, prop_id);
+        }
+    }
+    int work = 0;
+    bool too_much_work = false;
+    while (!queue.empty()) {
+        pair<int, PropID> top_pair = queue.pop();
+        int old_cost = top_pair.first;
+        PropID prop_id = top_pair.second;
+        Proposition *prop = get_proposition(prop_id);
+        if (prop->reached_by != NO_OP) {
+            OpID supporter = find_unaffected_supporter(prop_id, old_cost);
+            work += num_achievers[prop_id];
+            if (supporter != NO_OP) {
+                prop->reached_by = supporter;
+                int cost = compute_unary_operator_cost(supporter);
+                if (cost < old_cost) {
+                    prop->cost = cost;
+                    decreased_propositions.push_back(prop_id);
+                }
+                continue;
+            }
+        }
+        is_affected[prop_id] = true;
+        affected_propositions.push_back(prop_id);
+        for (OpID op_id : precondition_of_pool.get_slice(
+                 prop->precondition_of, prop->num_precondition_occurences)) {
+            PropID effect_id = get_operator(op_id)->effect;
+            Proposition *effect = get_proposition(effect_id);
+            if (!is_candidate[effect_id] && effect->reached_by == op_id) {
+                is_candidate[effect_id] = true;
+                candidate_propositions.push_back(effect_id);
+                queue.push(effect->cost, effect_id);
+            }
+        }
+        work += prop->num_precondition_occurences;
+        if (work > max_repair_work) {
+            too_much_work = true;
+            break;
+        }
+    }
+    for (PropID prop_id : candidate_propositions)
+        is_candidate[prop_id] = false;
+    for (PropID prop_id : affected_propositions) {
+        is_affected[prop_id] = false;
+        Proposition *prop = get_proposition(prop_id);
+        prop->cost = -1;
+        prop->reached_by = NO_OP;
+    }
+    if (too_much_work)
+        return false;
+    queue.clear();
+
+    for (PropID prop_id : decreased_propositions)
+        queue.push(get_proposition(prop_id)->cost, prop_id);
+
+    // Find the cheapest remaining supporters of invalidated propositions.
+    for (PropID prop_id : affected_propositions) {
+        for (OpID op_id : achievers_pool.get_slice(
+                 achievers[prop_id], num_achievers[prop_id])) {
+            int cost = compute_unary_operator_cost(op_id);
+            if (cost != -1)
+                enqueue_if_necessary(prop_id, cost, op_id);
+        }
+        work += num_achievers[prop_id];
+    }
+
+    // Propagate cost changes.
+    while (!queue.empty()) {
+        pair<int, PropID> top_pair = queue.pop();
+        int distance = top_pair.first;
+        PropID prop_id = top_pair.second;
+        Proposition *prop = get_proposition(prop_id);
+        assert(prop->cost >= 0);
+        assert(prop->cost <= distance);
+        if (prop->cost < distance)
+            continue;
+        for (OpID op_id : precondition_of_pool.get_slice(
+                 prop->precondition_of, prop->num_precondition_occurences)) {
+            int cost = compute_unary_operator_cost(op_id);
+            if (cost != -1)
+                enqueue_if_necessary(get_operator(op_id)->effect, cost, op_id);
+        }
+        work += prop->num_precondition_occurences;
+        if (work > max_repair_work)
+            return false;
+    }
+    return true;
+}
+
+void AdditiveHeuristic::compute_costs(const State &state) {
+    if (!incremental || previous_state_values.empty() ||
+        !repair_costs(state)) {
+        setup_exploration_queue();
+        setup_exploration_queue_state(state);
+        relaxed_exploration();
+    } else {
+        for (Proposition &prop : propositions)
+            prop.marked = false;
+    }
+    if (incremental)
+        previous_state_values = state.get_values();
+}
+
 int AdditiveHeuristic::compute_add_and_ff(const State &state) {
-    setup_exploration_queue();
-    setup_exploration_queue_state(state);
-    relaxed_exploration();
+    compute_costs(state);
 
     int total_cost = 0;
     for (PropID goal_id : goal_propositions) {
@@ -143,6 +345,19 @@ void AdditiveHeuristic::compute_heuristic_for_cegar(const State &state) {
     compute_heuristic(state);
 }
 
+void AdditiveHeuristic::add_options_to_parser(OptionParser &parser) {
+    parser.add_option<bool>(
+        "incremental",
+        "reuse the costs computed for the previously evaluated state and "
+        "only repair the costs affected by the facts that differ. If the "
+        "repair becomes too expensive, the costs are recomputed from "
+        "scratch. Costs are the same as without this option, but ties "
+        "between cheapest supporters may be broken differently, which "
+        "can change preferred operators and relaxed plans.",
+        "false");
+    Heuristic::add_options_to_parser(parser);
+}
+
 static shared_ptr<Heuristic> _parse(OptionParser &parser) {
     parser.document_synopsis("Additive heuristic", "");
     parser.document_language_support("action costs", "supported");
@@ -157,7 +372,7 @@ static shared_ptr<Heuristic> _parse(OptionParser &parser) {
     parser.document_property("safe", "yes for tasks without axioms");
     parser.document_property("preferred operators", "yes");
 
-    Heuristic::add_options_to_parser(parser);
+    AdditiveHeuristic::add_options_to_parser(parser);
     Options opts = parser.parse();
     if (parser.dry_run())
         return nullptr;
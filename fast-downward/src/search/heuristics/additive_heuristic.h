@@ -32,9 +32,35 @@ class AdditiveHeuristic : public relaxation_heuristic::RelaxationHeuristic {
     priority_queues::AdaptiveQueue<PropID> queue;
     bool did_write_overflow_warning;
 
+    /*
+      In incremental mode, we keep the costs of the previously evaluated
+      state and only repair the parts that change for the next state:
+      propositions whose supporters depend on a fact that is no longer
+      true are invalidated and recomputed, and cost decreases caused by
+      new facts are propagated. If the repair touches more than
+      max_repair_work propositions and unary operators, we fall back to
+      a computation from scratch.
+    */
+    const bool incremental;
+    int max_repair_work;
+    std::vector<int> previous_state_values;
+    array_pool::ArrayPool achievers_pool;
+    std::vector<array_pool::ArrayPoolIndex> achievers;
+    std::vector<int> num_achievers;
+    std::vector<PropID> decreased_propositions;
+    std::vector<PropID> candidate_propositions;
+    std::vector<bool> is_candidate;
+    std::vector<PropID> affected_propositions;
+    std::vector<bool> is_affected;
+
     void setup_exploration_queue();
     void setup_exploration_queue_state(const State &state);
     void relaxed_exploration();
+    void build_achievers();
+    int compute_unary_operator_cost(OpID op_id);
+    OpID find_unaffected_supporter(PropID prop_id, int max_cost);
+    bool repair_costs(const State &state);
+    void compute_costs(const State &state);
     void mark_preferred_operators(const State &state, PropID goal_id);
 
     void enqueue_if_necessary(PropID prop_id, int cost, OpID op_id) {
@@ -69,6 +95,8 @@ protected:
 public:
     explicit AdditiveHeuristic(const options::Options &opts);
 
+    static void add_options_to_parser(options::OptionParser &parser);
+
     /*
       TODO: The two methods below are temporarily needed for the CEGAR
       heuristic. In the long run it might be better to split the
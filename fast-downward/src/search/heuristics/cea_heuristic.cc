@@ -8,6 +8,7 @@
 
 #include "../task_utils/task_properties.h"
 
+#include <algorithm>
 #include <cassert>
 #include <limits>
 #include <vector>
@@ -47,124 +48,58 @@ using namespace domain_transition_graph;
      (LocalProblemNode *, LocalTransition *) pairs rather than straight
      transitions. So it's not clear if this would really save much, which
      is why we do not currently do it.
+
+   Local problems are stored in a pool with stable addresses. The
+   transitions and contexts of all nodes of a local problem are stored
+   contiguously in the local problem. Instead of resetting all local
+   problems and nodes for every evaluation, we increase a generation
+   counter: a local problem is set up iff its generation matches the
+   current one, and the dynamic attributes of a node are reset lazily
+   when the node is first accessed in the current generation.
  */
 namespace cea_heuristic {
-struct LocalTransition {
-    LocalProblemNode *source;
-    LocalProblemNode *target;
-    const ValueTransitionLabel *label;
-    int action_cost;
-
-    int target_cost;
-    int unreached_conditions;
-
-    LocalTransition(
-        LocalProblemNode *source_, LocalProblemNode *target_,
-        const ValueTransitionLabel *label_, int action_cost_)
-        : source(source_), target(target_),
-          label(label_), action_cost(action_cost_),
-          target_cost(-1), unreached_conditions(-1) {
-        // target_cost and unreached_cost are initialized by
-        // expand_transition.
-    }
-
-    ~LocalTransition() {
-    }
-};
-
-
-struct LocalProblemNode {
-    // Attributes fixed during initialization.
-    LocalProblem *owner;
-    vector<LocalTransition> outgoing_transitions;
-
-    // Dynamic attributes (modified during heuristic computation).
-    int cost;
-    bool expanded;
-    vector<short> context;
-
-    LocalTransition *reached_by;
-    /* Before a node is expanded, reached_by is the "current best"
-       transition leading to this node. After a node is expanded, the
-       reached_by value of the parent is copied (unless the parent is
-       the initial node), so that reached_by is the *first* transition
-       on the optimal path to this node. This is useful for preferred
-       operators. (The two attributes used to be separate, but this
-       was a bit wasteful.) */
-
-    vector<LocalTransition *> waiting_list;
-
-    LocalProblemNode(LocalProblem *owner_, int context_size)
-        : owner(owner_),
-          cost(-1),
-          expanded(false),
-          context(context_size, -1),
-          reached_by(0) {
-    }
-
-    ~LocalProblemNode() {
-    }
-};
-
-struct LocalProblem {
-    int base_priority;
-    vector<LocalProblemNode> nodes;
-    vector<int> *context_variables;
-public:
-    LocalProblem()
-        : base_priority(-1) {
-    }
-
-    ~LocalProblem() {
-    }
-};
-
 LocalProblem *ContextEnhancedAdditiveHeuristic::get_local_problem(
     int var_no, int value) {
     LocalProblem * &table_entry = local_problem_index[var_no][value];
-    if (!table_entry) {
+    if (!table_entry)
         table_entry = build_problem_for_variable(var_no);
-        local_problems.push_back(table_entry);
-    }
     return table_entry;
 }
 
 LocalProblem *ContextEnhancedAdditiveHeuristic::build_problem_for_variable(
-    int var_no) const {
-    LocalProblem *problem = new LocalProblem;
+    int var_no) {
+    local_problems.emplace_back();
+    LocalProblem *problem = &local_problems.back();
 
     DomainTransitionGraph *dtg = transition_graphs[var_no].get();
 
     problem->context_variables = &dtg->local_to_global_child;
 
-    int num_parents = problem->context_variables->size();
-    size_t num_values = task_proxy.get_variables()[var_no].get_domain_size();
-    problem->nodes.reserve(num_values);
-    for (size_t value = 0; value < num_values; ++value)
-        problem->nodes.push_back(LocalProblemNode(problem, num_parents));
+    int num_values = task_proxy.get_variables()[var_no].get_domain_size();
 
     // Compile the DTG arcs into LocalTransition objects.
-    for (size_t value = 0; value < num_values; ++value) {
-        LocalProblemNode &node = problem->nodes[value];
+    problem->initialize_nodes(num_values);
+    LocalProblemNode *nodes = problem->nodes.data();
+    for (int value = 0; value < num_values; ++value) {
         const ValueNode &dtg_node = dtg->nodes[value];
-        for (size_t i = 0; i < dtg_node.transitions.size(); ++i) {
-            const ValueTransition &dtg_trans = dtg_node.transitions[i];
-            int target_value = dtg_trans.target->value;
-            LocalProblemNode &target = problem->nodes[target_value];
+        for (const ValueTransition &dtg_trans : dtg_node.transitions) {
+            LocalProblemNode *target = nodes + dtg_trans.target->value;
             for (const ValueTransitionLabel &label : dtg_trans.labels) {
                 OperatorProxy op = label.is_axiom ?
                     task_proxy.get_axioms()[label.op_id] :
                     task_proxy.get_operators()[label.op_id];
-                LocalTransition trans(&node, &target, &label, op.get_cost());
-                node.outgoing_transitions.push_back(trans);
+                problem->transitions.emplace_back(
+                    nodes + value, target, &label, op.get_cost());
             }
         }
     }
+    problem->initialize_transition_ranges();
     return problem;
 }
 
-LocalProblem *ContextEnhancedAdditiveHeuristic::build_problem_for_goal() const {
-    LocalProblem *problem = new LocalProblem;
+LocalProblem *ContextEnhancedAdditiveHeuristic::build_problem_for_goal() {
+    local_problems.emplace_back();
+    LocalProblem *problem = &local_problems.back();
 
     GoalsProxy goals_proxy = task_proxy.get_goals();
 
@@ -172,9 +107,6 @@ LocalProblem *ContextEnhancedAdditiveHeuristic::build_problem_for_goal() const {
     for (FactProxy goal : goals_proxy)
         problem->context_variables->push_back(goal.get_variable().get_id());
 
-    for (size_t value = 0; value < 2; ++value)
-        problem->nodes.push_back(LocalProblemNode(problem, goals_proxy.size()));
-
     vector<LocalAssignment> goals;
     for (size_t goal_no = 0; goal_no < goals_proxy.size(); ++goal_no) {
         int goal_value = goals_proxy[goal_no].get_value();
@@ -182,8 +114,10 @@ LocalProblem *ContextEnhancedAdditiveHeuristic::build_problem_for_goal() const {
     }
     vector<LocalAssignment> no_effects;
     ValueTransitionLabel *label = new ValueTransitionLabel(0, true, goals, no_effects);
-    LocalTransition trans(&problem->nodes[0], &problem->nodes[1], label, 0);
-    problem->nodes[0].outgoing_transitions.push_back(trans);
+    problem->initialize_nodes(2);
+    problem->transitions.emplace_back(
+        &problem->nodes[0], &problem->nodes[1], label, 0);
+    problem->initialize_transition_ranges();
     return problem;
 }
 
@@ -210,26 +144,35 @@ inline void ContextEnhancedAdditiveHeuristic::add_to_heap(
 
 bool ContextEnhancedAdditiveHeuristic::is_local_problem_set_up(
     const LocalProblem *problem) const {
-    return problem->base_priority != -1;
+    return problem->generation == current_generation;
+}
+
+inline void ContextEnhancedAdditiveHeuristic::update_generation(
+    LocalProblemNode *node) const {
+    if (node->generation != current_generation) {
+        assert(is_local_problem_set_up(node->owner));
+        node->generation = current_generation;
+        node->expanded = false;
+        node->cost = numeric_limits<int>::max();
+        node->waiting_list.clear();
+        node->reached_by = 0;
+    }
 }
 
 void ContextEnhancedAdditiveHeuristic::set_up_local_problem(
     LocalProblem *problem, int base_priority,
     int start_value, const State &state) {
-    assert(problem->base_priority == -1);
+    assert(!is_local_problem_set_up(problem));
+    problem->generation = current_generation;
     problem->base_priority = base_priority;
 
-    for (auto &to_node : problem->nodes) {
-        to_node.expanded = false;
-        to_node.cost = numeric_limits<int>::max();
-        to_node.waiting_list.clear();
-        to_node.reached_by = 0;
-    }
-
     LocalProblemNode *start = &problem->nodes[start_value];
+    update_generation(start);
     start->cost = 0;
-    for (size_t i = 0; i < problem->context_variables->size(); ++i)
-        start->context[i] = state[(*problem->context_variables)[i]].get_value();
+    const vector<int> &values = state.get_values();
+    int context_size = problem->get_context_size();
+    for (int i = 0; i < context_size; ++i)
+        start->context[i] = values[(*problem->context_variables)[i]];
 
     add_to_heap(start);
 }
@@ -238,6 +181,7 @@ void ContextEnhancedAdditiveHeuristic::try_to_fire_transition(
     LocalTransition *trans) {
     if (!trans->unreached_conditions) {
         LocalProblemNode *target = trans->target;
+        update_generation(target);
         if (trans->target_cost < target->cost) {
             target->cost = trans->target_cost;
             target->reached_by = trans;
@@ -252,8 +196,9 @@ void ContextEnhancedAdditiveHeuristic::expand_node(LocalProblemNode *node) {
     LocalTransition *reached_by = node->reached_by;
     if (reached_by) {
         LocalProblemNode *parent = reached_by->source;
-        vector<short> &context = node->context;
-        context = parent->context;
+        short *context = node->context;
+        copy(parent->context,
+             parent->context + node->owner->get_context_size(), context);
         const vector<LocalAssignment> &precond = reached_by->label->precond;
         for (size_t i = 0; i < precond.size(); ++i)
             context[precond[i].local_var] = precond[i].value;
@@ -287,6 +232,7 @@ void ContextEnhancedAdditiveHeuristic::expand_transition(
 
     trans->target_cost = trans->source->cost + trans->action_cost;
 
+    update_generation(trans->target);
     if (trans->target->cost <= trans->target_cost) {
         // Transition cannot find a shorter path to target.
         return;
@@ -299,7 +245,7 @@ void ContextEnhancedAdditiveHeuristic::expand_transition(
         curr_precond = precond.begin(),
         last_precond = precond.end();
 
-    vector<short>::const_iterator context = trans->source->context.begin();
+    const short *context = trans->source->context;
     vector<int>::const_iterator parent_vars =
         trans->source->owner->context_variables->begin();
 
@@ -321,6 +267,7 @@ void ContextEnhancedAdditiveHeuristic::expand_transition(
         }
 
         LocalProblemNode *cond_node = &subproblem->nodes[precond_value];
+        update_generation(cond_node);
         if (cond_node->expanded) {
             trans->target_cost += cond_node->cost;
             if (trans->target->cost <= trans->target_cost) {
@@ -349,8 +296,9 @@ int ContextEnhancedAdditiveHeuristic::compute_costs(const State &state) {
 
         assert(get_priority(node) == curr_priority);
         expand_node(node);
-        for (auto &transition : node->outgoing_transitions)
-            expand_transition(&transition, state);
+        for (LocalTransition *trans = node->transitions_begin;
+             trans != node->transitions_end; ++trans)
+            expand_transition(trans, state);
     }
     return DEAD_END;
 }
@@ -385,6 +333,7 @@ void ContextEnhancedAdditiveHeuristic::mark_helpful_transitions(
                 LocalProblem *subproblem = get_local_problem(
                     precond_var_no, state[precond_var_no].get_value());
                 LocalProblemNode *subnode = &subproblem->nodes[precond_value];
+                assert(subnode->generation == current_generation);
                 mark_helpful_transitions(subproblem, subnode, state);
             }
         }
@@ -395,9 +344,7 @@ int ContextEnhancedAdditiveHeuristic::compute_heuristic(
     const GlobalState &global_state) {
     const State state = convert_global_state(global_state);
     initialize_heap();
-    goal_problem->base_priority = -1;
-    for (LocalProblem *problem : local_problems)
-        problem->base_priority = -1;
+    ++current_generation;
 
     set_up_local_problem(goal_problem, 0, 0, state);
 
@@ -412,7 +359,8 @@ int ContextEnhancedAdditiveHeuristic::compute_heuristic(
 ContextEnhancedAdditiveHeuristic::ContextEnhancedAdditiveHeuristic(
     const Options &opts)
     : Heuristic(opts),
-      min_action_cost(task_properties::get_min_operator_cost(task_proxy)) {
+      min_action_cost(task_properties::get_min_operator_cost(task_proxy)),
+      current_generation(0) {
     cout << "Initializing context-enhanced additive heuristic..." << endl;
 
     DTGFactory factory(task_proxy, true, [](int, int) {return false;});
@@ -430,12 +378,8 @@ ContextEnhancedAdditiveHeuristic::ContextEnhancedAdditiveHeuristic(
 ContextEnhancedAdditiveHeuristic::~ContextEnhancedAdditiveHeuristic() {
     if (goal_problem) {
         delete goal_problem->context_variables;
-        delete goal_problem->nodes[0].outgoing_transitions[0].label;
+        delete goal_problem->transitions[0].label;
     }
-    delete goal_problem;
-
-    for (LocalProblem *problem : local_problems)
-        delete problem;
 }
 
 bool ContextEnhancedAdditiveHeuristic::dead_ends_are_reliable() const {
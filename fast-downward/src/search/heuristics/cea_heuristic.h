@@ -7,6 +7,8 @@
 
 #include "../algorithms/priority_queues.h"
 
+#include <cassert>
+#include <deque>
 #include <vector>
 
 class State;
@@ -14,27 +16,137 @@ class State;
 namespace cea_heuristic {
 struct LocalProblem;
 struct LocalProblemNode;
-struct LocalTransition;
+
+struct LocalTransition {
+    LocalProblemNode *source;
+    LocalProblemNode *target;
+    const domain_transition_graph::ValueTransitionLabel *label;
+    int action_cost;
+
+    int target_cost;
+    int unreached_conditions;
+
+    LocalTransition(
+        LocalProblemNode *source_, LocalProblemNode *target_,
+        const domain_transition_graph::ValueTransitionLabel *label_, int action_cost_)
+        : source(source_), target(target_),
+          label(label_), action_cost(action_cost_),
+          target_cost(-1), unreached_conditions(-1) {
+        // target_cost and unreached_cost are initialized by
+        // expand_transition.
+    }
+
+    ~LocalTransition() {
+    }
+};
+
+
+struct LocalProblemNode {
+    // Attributes fixed during initialization.
+    LocalProblem *owner;
+    LocalTransition *transitions_begin;
+    LocalTransition *transitions_end;
+    short *context;
+
+    // Dynamic attributes (modified during heuristic computation).
+    int generation;
+    int cost;
+    bool expanded;
+
+    LocalTransition *reached_by;
+    /* Before a node is expanded, reached_by is the "current best"
+       transition leading to this node. After a node is expanded, the
+       reached_by value of the parent is copied (unless the parent is
+       the initial node), so that reached_by is the *first* transition
+       on the optimal path to this node. This is useful for preferred
+       operators. (The two attributes used to be separate, but this
+       was a bit wasteful.) */
+
+    std::vector<LocalTransition *> waiting_list;
+
+    explicit LocalProblemNode(LocalProblem *owner_)
+        : owner(owner_),
+          transitions_begin(nullptr),
+          transitions_end(nullptr),
+          context(nullptr),
+          generation(-1),
+          cost(-1),
+          expanded(false),
+          reached_by(0) {
+    }
+};
+
+struct LocalProblem {
+    int base_priority;
+    int generation;
+    std::vector<LocalProblemNode> nodes;
+    std::vector<LocalTransition> transitions;
+    std::vector<short> contexts;
+    std::vector<int> *context_variables;
+public:
+    LocalProblem()
+        : base_priority(-1),
+          generation(-1),
+          context_variables(nullptr) {
+    }
+
+    int get_context_size() const {
+        return context_variables->size();
+    }
+
+    /*
+      Create the nodes. Transitions can only point to the nodes once
+      this vector is complete and no longer reallocates.
+    */
+    void initialize_nodes(int num_values) {
+        int context_size = get_context_size();
+        contexts.resize(num_values * context_size, -1);
+        nodes.reserve(num_values);
+        for (int value = 0; value < num_values; ++value) {
+            nodes.emplace_back(this);
+            nodes.back().context = contexts.data() + value * context_size;
+        }
+    }
+
+    /*
+      Assign the nodes their outgoing transitions, which must be grouped
+      and sorted by source value.
+    */
+    void initialize_transition_ranges() {
+        LocalTransition *trans = transitions.data();
+        LocalTransition *transitions_end = trans + transitions.size();
+        for (LocalProblemNode &node : nodes) {
+            node.transitions_begin = trans;
+            while (trans != transitions_end && trans->source == &node)
+                ++trans;
+            node.transitions_end = trans;
+        }
+        assert(trans == transitions_end);
+    }
+};
 
 class ContextEnhancedAdditiveHeuristic : public Heuristic {
     std::vector<std::unique_ptr<domain_transition_graph::DomainTransitionGraph>> transition_graphs;
-    std::vector<LocalProblem *> local_problems;
+    // Pool of all local problems with stable addresses.
+    std::deque<LocalProblem> local_problems;
     std::vector<std::vector<LocalProblem *>> local_problem_index;
     LocalProblem *goal_problem;
     LocalProblemNode *goal_node;
     int min_action_cost;
+    int current_generation;
 
     priority_queues::AdaptiveQueue<LocalProblemNode *> node_queue;
 
     LocalProblem *get_local_problem(int var_no, int value);
-    LocalProblem *build_problem_for_variable(int var_no) const;
-    LocalProblem *build_problem_for_goal() const;
+    LocalProblem *build_problem_for_variable(int var_no);
+    LocalProblem *build_problem_for_goal();
 
     int get_priority(LocalProblemNode *node) const;
     void initialize_heap();
     void add_to_heap(LocalProblemNode *node);
 
     bool is_local_problem_set_up(const LocalProblem *problem) const;
+    void update_generation(LocalProblemNode *node) const;
     void set_up_local_problem(LocalProblem *problem, int base_priority,
                               int start_value, const State &state);
 
@@ -4,19 +4,26 @@
 
 #include "../task_utils/causal_graph.h"
 #include "../utils/collections.h"
+#include "../utils/hash.h"
 #include "../utils/math.h"
 
 #include <algorithm>
 #include <cassert>
+#include <fstream>
 #include <iostream>
+#include <limits>
 #include <vector>
 
 using namespace std;
+using domain_transition_graph::ValueTransitionLabel;
 
 namespace cg_heuristic {
 const int CGCache::NOT_COMPUTED;
 
-CGCache::CGCache(const TaskProxy &task_proxy, int max_cache_size)
+static const string CACHE_FILE_HEADER = "cg_cache 1";
+
+CGCache::CGCache(
+    const TaskProxy &task_proxy, int max_cache_size, int max_hashed_cache_size)
     : task_proxy(task_proxy) {
     cout << "Initializing heuristic cache... " << flush;
 
@@ -51,19 +58,47 @@ CGCache::CGCache(const TaskProxy &task_proxy, int max_cache_size)
                               depends_on[var].end());
     }
 
-    cache.resize(var_count);
-    helpful_transition_cache.resize(var_count);
+    variable_caches.resize(var_count);
 
+    int num_dense = 0;
+    vector<int> hashed_vars;
+    VariablesProxy variables = task_proxy.get_variables();
     for (int var = 0; var < var_count; ++var) {
+        VariableCache &var_cache = variable_caches[var];
+        int domain_size = variables[var].get_domain_size();
+        if (domain_size < 2)
+            continue;
+        var_cache.row_size = domain_size - 1;
         int required_cache_size = compute_required_cache_size(
             var, depends_on[var], max_cache_size);
         if (required_cache_size != -1) {
-            cache[var].resize(required_cache_size, NOT_COMPUTED);
-            helpful_transition_cache[var].resize(required_cache_size, nullptr);
+            var_cache.is_cached = true;
+            var_cache.entries.resize(
+                required_cache_size, CacheEntry {NOT_COMPUTED, nullptr});
+            ++num_dense;
+        } else if (max_hashed_cache_size > 0) {
+            hashed_vars.push_back(var);
+        }
+    }
+
+    // The hashed variables share max_hashed_cache_size entries equally.
+    int num_hashed = hashed_vars.size();
+    for (int var : hashed_vars) {
+        VariableCache &var_cache = variable_caches[var];
+        var_cache.is_cached = true;
+        var_cache.is_hashed = true;
+        if (!has_narrow_keys(var)) {
+            var_cache.has_wide_keys = true;
+            var_cache.context_size = 1 + depends_on[var].size();
         }
+        // The stored contexts count towards the size of the cache.
+        int row_cost = var_cache.row_size + var_cache.context_size;
+        var_cache.max_num_rows =
+            max(1, max_hashed_cache_size / num_hashed / row_cost);
     }
 
-    cout << "done!" << endl;
+    cout << "done! " << num_dense << " dense, " << num_hashed << " hashed, "
+         << var_count - num_dense - num_hashed << " uncached variables" << endl;
 }
 
 CGCache::~CGCache() {
@@ -72,11 +107,11 @@ CGCache::~CGCache() {
 int CGCache::compute_required_cache_size(
     int var_id, const vector<int> &depends_on, int max_cache_size) const {
     /*
-      Compute the size of the cache required for variable with ID "var_id",
-      which depends on the variables in "depends_on". Requires that the caches
-      for all variables in "depends_on" have already been allocated. Returns -1
-      if the variable cannot be cached because the required cache size would be
-      too large.
+      Compute the size of the dense table required for variable with ID
+      "var_id", which depends on the variables in "depends_on". Requires
+      that the caches for all variables in "depends_on" have already been
+      set up. Returns -1 if the variable cannot use a dense table because
+      the required size would be too large.
     */
 
     VariablesProxy variables = task_proxy.get_variables();
@@ -91,13 +126,15 @@ int CGCache::compute_required_cache_size(
         int depend_var_domain = variables[depend_var_id].get_domain_size();
 
         /*
-          If var depends on a variable var_i that is not cached, then
-          it cannot be cached. This is possible even if var would have
-          an acceptable cache size because the domain of var_i
-          contributes quadratically to its own cache size but only
-          linearly to the cache size of var.
+          If var depends on a variable var_i that has no dense table,
+          then it cannot have one either. This is possible even if var
+          would have an acceptable table size because the domain of
+          var_i contributes quadratically to its own table size but
+          only linearly to the table size of var.
         */
-        if (cache[depend_var_id].empty())
+        const VariableCache &depend_cache = variable_caches[depend_var_id];
+        if (depend_cache.row_size > 0 &&
+            (!depend_cache.is_cached || depend_cache.is_hashed))
             return -1;
 
         if (!utils::is_product_within_limit(required_size, depend_var_domain,
@@ -110,20 +147,312 @@ int CGCache::compute_required_cache_size(
     return required_size;
 }
 
-int CGCache::get_index(int var, const State &state,
-                       int from_val, int to_val) const {
+bool CGCache::has_narrow_keys(int var_id) const {
+    // Test if the mixed-radix keys of the variable fit into 64 bits.
+    VariablesProxy variables = task_proxy.get_variables();
+    uint64_t max_key = numeric_limits<uint64_t>::max();
+    uint64_t key_space = variables[var_id].get_domain_size();
+    for (int depend_var_id : depends_on[var_id]) {
+        uint64_t depend_var_domain = variables[depend_var_id].get_domain_size();
+        if (key_space > max_key / depend_var_domain)
+            return false;
+        key_space *= depend_var_domain;
+    }
+    return true;
+}
+
+uint64_t CGCache::get_key(int var, const State &state, int from_val) const {
     assert(is_cached(var));
-    assert(from_val != to_val);
-    int index = from_val;
-    int multiplier = task_proxy.get_variables()[var].get_domain_size();
+    if (variable_caches[var].has_wide_keys) {
+        context.clear();
+        context.push_back(from_val);
+        for (int dep_var : depends_on[var])
+            context.push_back(state[dep_var].get_value());
+        return utils::get_hash64(context);
+    }
+    uint64_t key = from_val;
+    uint64_t multiplier = task_proxy.get_variables()[var].get_domain_size();
     for (int dep_var : depends_on[var]) {
-        index += state[dep_var].get_value() * multiplier;
+        key += state[dep_var].get_value() * multiplier;
         multiplier *= task_proxy.get_variables()[dep_var].get_domain_size();
     }
-    if (to_val > from_val)
-        --to_val;
-    index += to_val * multiplier;
-    assert(utils::in_bounds(index, cache[var]));
-    return index;
+    return key;
+}
+
+int CGCache::find_row(const VariableCache &var_cache, uint64_t key) const {
+    if (!var_cache.is_hashed) {
+        assert(key * var_cache.row_size < var_cache.entries.size());
+        return key;
+    }
+    auto it = var_cache.row_index.find(key);
+    if (it == var_cache.row_index.end())
+        return -1;
+    int row = it->second;
+    if (var_cache.has_wide_keys) {
+        // Rule out hash collisions.
+        auto row_context = var_cache.row_contexts.begin() +
+            row * var_cache.context_size;
+        if (!equal(context.begin(), context.end(), row_context))
+            return -1;
+    }
+    return row;
+}
+
+int CGCache::evict_row(VariableCache &var_cache) {
+    /*
+      CLOCK eviction: advance the hand over the rows and give referenced
+      rows a second chance until we find one that has not been
+      referenced since the hand last passed it.
+    */
+    int num_rows = var_cache.row_keys.size();
+    while (var_cache.row_referenced[var_cache.clock_hand]) {
+        var_cache.row_referenced[var_cache.clock_hand] = false;
+        var_cache.clock_hand = (var_cache.clock_hand + 1) % num_rows;
+    }
+    int row = var_cache.clock_hand;
+    var_cache.clock_hand = (var_cache.clock_hand + 1) % num_rows;
+    var_cache.row_index.erase(var_cache.row_keys[row]);
+    ++var_cache.evictions;
+    return row;
+}
+
+int CGCache::insert_row(VariableCache &var_cache, uint64_t key) {
+    assert(var_cache.is_hashed);
+    int row;
+    if (static_cast<int>(var_cache.row_keys.size()) < var_cache.max_num_rows) {
+        row = var_cache.row_keys.size();
+        var_cache.row_keys.push_back(key);
+        var_cache.row_referenced.push_back(true);
+        var_cache.entries.resize(var_cache.entries.size() + var_cache.row_size);
+        var_cache.row_contexts.resize(
+            var_cache.row_contexts.size() + var_cache.context_size);
+    } else {
+        row = evict_row(var_cache);
+        var_cache.row_keys[row] = key;
+        var_cache.row_referenced[row] = true;
+    }
+    var_cache.row_index[key] = row;
+    return row;
+}
+
+const CGCache::CacheEntry *CGCache::lookup(
+    int var, const State &state, int from_val) {
+    VariableCache &var_cache = variable_caches[var];
+    int row = find_row(var_cache, get_key(var, state, from_val));
+    if (row != -1) {
+        CacheEntry *entries = get_row(var_cache, row);
+        if (entries[0].cost != NOT_COMPUTED) {
+            ++var_cache.hits;
+            if (var_cache.is_hashed)
+                var_cache.row_referenced[row] = true;
+            return entries;
+        }
+    }
+    ++var_cache.misses;
+    return nullptr;
+}
+
+const CGCache::CacheEntry *CGCache::find(
+    int var, const State &state, int from_val) const {
+    const VariableCache &var_cache = variable_caches[var];
+    int row = find_row(var_cache, get_key(var, state, from_val));
+    if (row == -1)
+        return nullptr;
+    const CacheEntry *entries = get_row(var_cache, row);
+    if (entries[0].cost == NOT_COMPUTED)
+        return nullptr;
+    return entries;
+}
+
+CGCache::CacheEntry *CGCache::get_row_for_storing(
+    VariableCache &var_cache, uint64_t key) {
+    if (!var_cache.is_hashed)
+        return get_row(var_cache, find_row(var_cache, key));
+    int row;
+    auto it = var_cache.row_index.find(key);
+    if (it == var_cache.row_index.end()) {
+        row = insert_row(var_cache, key);
+    } else {
+        // For wide keys, this overwrites a row in case of a hash collision.
+        row = it->second;
+        var_cache.row_referenced[row] = true;
+    }
+    if (var_cache.has_wide_keys) {
+        copy(context.begin(), context.end(),
+             var_cache.row_contexts.begin() + row * var_cache.context_size);
+    }
+    return get_row(var_cache, row);
+}
+
+CGCache::CacheEntry *CGCache::store(int var, const State &state, int from_val) {
+    VariableCache &var_cache = variable_caches[var];
+    return get_row_for_storing(var_cache, get_key(var, state, from_val));
+}
+
+void CGCache::load(const string &filename,
+                   const LabelsByVariable &labels_by_variable) {
+    ifstream infile(filename);
+    if (!infile) {
+        cout << "No heuristic cache file " << filename << " found." << endl;
+        return;
+    }
+    cout << "Loading heuristic cache from " << filename << "... " << flush;
+
+    /*
+      The header describes the task for which the file was written. If
+      it does not match our task, we ignore the file.
+    */
+    string line;
+    getline(infile, line);
+    bool matches = (line == CACHE_FILE_HEADER);
+    int var_count = variable_caches.size();
+    VariablesProxy variables = task_proxy.get_variables();
+    for (int var = 0; matches && var < var_count; ++var) {
+        int domain_size;
+        size_t num_labels;
+        size_t num_depends;
+        infile >> domain_size >> num_labels >> num_depends;
+        matches = infile && domain_size == variables[var].get_domain_size() &&
+            num_labels == labels_by_variable[var].size() &&
+            num_depends == depends_on[var].size();
+        for (size_t i = 0; matches && i < num_depends; ++i) {
+            int depend_var;
+            infile >> depend_var;
+            matches = infile && depend_var == depends_on[var][i];
+        }
+    }
+    if (!matches) {
+        cout << "ignored (written for a different task)." << endl;
+        return;
+    }
+
+    /*
+      Each row starts with the variable and the key. For variables with
+      wide keys, the key is replaced by the start value and the ancestor
+      values.
+    */
+    int num_rows = 0;
+    int var;
+    while (infile >> var) {
+        if (var < 0 || var >= var_count)
+            break;
+        VariableCache &var_cache = variable_caches[var];
+        uint64_t key = 0;
+        if (var_cache.has_wide_keys) {
+            context.resize(var_cache.context_size);
+            for (int &value : context)
+                infile >> value;
+            key = utils::get_hash64(context);
+        } else {
+            infile >> key;
+        }
+        const vector<ValueTransitionLabel *> &labels = labels_by_variable[var];
+        vector<CacheEntry> row(var_cache.row_size);
+        bool valid = true;
+        for (CacheEntry &entry : row) {
+            int label_index;
+            infile >> entry.cost >> label_index;
+            valid = valid && label_index >= -1 &&
+                label_index < static_cast<int>(labels.size());
+            entry.helpful_transition = (valid && label_index != -1) ?
+                labels[label_index] : nullptr;
+        }
+        if (!infile || !valid)
+            break;
+        if (!var_cache.is_cached)
+            continue;
+        if (!var_cache.is_hashed &&
+            key * var_cache.row_size >= var_cache.entries.size())
+            continue;
+        copy(row.begin(), row.end(), get_row_for_storing(var_cache, key));
+        ++num_rows;
+    }
+    cout << "loaded " << num_rows << " rows." << endl;
+}
+
+void CGCache::save(const string &filename,
+                   const LabelsByVariable &labels_by_variable) const {
+    ofstream outfile(filename);
+    if (outfile.rdstate() & ofstream::failbit) {
+        cerr << "Failed to open heuristic cache file: " << filename << endl;
+        return;
+    }
+
+    outfile << CACHE_FILE_HEADER << endl;
+    int var_count = variable_caches.size();
+    VariablesProxy variables = task_proxy.get_variables();
+    for (int var = 0; var < var_count; ++var) {
+        outfile << variables[var].get_domain_size() << " "
+                << labels_by_variable[var].size() << " "
+                << depends_on[var].size();
+        for (int depend_var : depends_on[var])
+            outfile << " " << depend_var;
+        outfile << endl;
+    }
+
+    int num_rows = 0;
+    for (int var = 0; var < var_count; ++var) {
+        const VariableCache &var_cache = variable_caches[var];
+        if (!var_cache.is_cached)
+            continue;
+        unordered_map<const ValueTransitionLabel *, int> label_indices;
+        const vector<ValueTransitionLabel *> &labels = labels_by_variable[var];
+        for (size_t i = 0; i < labels.size(); ++i)
+            label_indices[labels[i]] = i;
+
+        int row_size = var_cache.row_size;
+        int var_num_rows = var_cache.entries.size() / row_size;
+        for (int row = 0; row < var_num_rows; ++row) {
+            const CacheEntry *entries = &var_cache.entries[row * row_size];
+            if (entries[0].cost == NOT_COMPUTED)
+                continue;
+            outfile << var;
+            if (var_cache.has_wide_keys) {
+                int context_size = var_cache.context_size;
+                for (int i = 0; i < context_size; ++i)
+                    outfile << " " << var_cache.row_contexts[row * context_size + i];
+            } else {
+                outfile << " " << (var_cache.is_hashed ? var_cache.row_keys[row] : row);
+            }
+            for (int i = 0; i < row_size; ++i) {
+                const ValueTransitionLabel *label = entries[i].helpful_transition;
+                outfile << " " << entries[i].cost << " "
+                        << (label ? label_indices.at(label) : -1);
+            }
+            outfile << "\n";
+            ++num_rows;
+        }
+    }
+    cout << "Saved " << num_rows << " rows of the heuristic cache to "
+         << filename << "." << endl;
+}
+
+void CGCache::print_statistics() const {
+    int64_t total_hits = 0;
+    int64_t total_misses = 0;
+    int64_t total_evictions = 0;
+    int var_count = variable_caches.size();
+    for (int var = 0; var < var_count; ++var) {
+        const VariableCache &var_cache = variable_caches[var];
+        int64_t lookups = var_cache.hits + var_cache.misses;
+        if (!var_cache.is_cached || lookups == 0)
+            continue;
+        cout << "Heuristic cache for variable " << var << " ("
+             << (var_cache.is_hashed ? "hashed" : "dense") << "): "
+             << lookups << " lookups, hit rate "
+             << 100.0 * var_cache.hits / lookups << "%";
+        if (var_cache.is_hashed) {
+            cout << ", " << var_cache.row_keys.size() << " rows, "
+                 << var_cache.evictions << " evictions";
+        }
+        cout << endl;
+        total_hits += var_cache.hits;
+        total_misses += var_cache.misses;
+        total_evictions += var_cache.evictions;
+    }
+    int64_t total_lookups = total_hits + total_misses;
+    cout << "Heuristic cache lookups: " << total_lookups << endl;
+    cout << "Heuristic cache hits: " << total_hits << endl;
+    cout << "Heuristic cache evictions: " << total_evictions << endl;
 }
 }
@@ -3,6 +3,9 @@
 
 #include "../task_proxy.h"
 
+#include <cstdint>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace domain_transition_graph {
@@ -10,46 +13,132 @@ struct ValueTransitionLabel;
 }
 
 namespace cg_heuristic {
+/*
+  Cache for the transition costs and helpful transitions computed by
+  the causal graph heuristic. The entries of a variable depend on the
+  values of its ancestors in the (reduced) causal graph. We store them
+  in rows: a row holds the entries for one assignment to the ancestors
+  and one start value, with one entry for each other value.
+
+  If all rows of a variable fit into max_cache_size entries, we store
+  them in a dense table. Otherwise, we store its rows in a hash table
+  and evict rows with the CLOCK algorithm (an approximation of LRU) once
+  the table is full. All hashed variables together store at most
+  max_hashed_cache_size entries, which are split equally among them. Rows are keyed by the
+  mixed-radix encoding of the start value and the ancestor values. If
+  this encoding does not fit into 64 bits ("wide keys"), we key them by
+  a hash of these values instead and store the values with the row to
+  detect collisions.
+*/
 class CGCache {
+public:
+    struct CacheEntry {
+        int cost;
+        domain_transition_graph::ValueTransitionLabel *helpful_transition;
+    };
+
+    using LabelsByVariable =
+        std::vector<std::vector<domain_transition_graph::ValueTransitionLabel *>>;
+
+private:
+    struct VariableCache {
+        bool is_cached;
+        bool is_hashed;
+        bool has_wide_keys;
+        // Number of entries per row (domain size - 1).
+        int row_size;
+        std::vector<CacheEntry> entries;
+
+        // Only used for hashed variables.
+        int max_num_rows;
+        std::unordered_map<std::uint64_t, int> row_index;
+        std::vector<std::uint64_t> row_keys;
+        std::vector<bool> row_referenced;
+        int clock_hand;
+
+        // Only used for variables with wide keys.
+        int context_size;
+        std::vector<int> row_contexts;
+
+        std::int64_t hits;
+        std::int64_t misses;
+        std::int64_t evictions;
+
+        VariableCache()
+            : is_cached(false),
+              is_hashed(false),
+              has_wide_keys(false),
+              row_size(0),
+              max_num_rows(0),
+              clock_hand(0),
+              context_size(0),
+              hits(0),
+              misses(0),
+              evictions(0) {
+        }
+    };
+
     TaskProxy task_proxy;
-    std::vector<std::vector<int>> cache;
-    std::vector<std::vector<domain_transition_graph::ValueTransitionLabel *>> helpful_transition_cache;
+    std::vector<VariableCache> variable_caches;
     std::vector<std::vector<int>> depends_on;
+    // Start value and ancestor values of the last wide key.
+    mutable std::vector<int> context;
 
-    int get_index(int var, const State &state, int from_val, int to_val) const;
+    std::uint64_t get_key(int var, const State &state, int from_val) const;
     int compute_required_cache_size(
         int var_id, const std::vector<int> &depends_on, int max_cache_size) const;
+    bool has_narrow_keys(int var_id) const;
+    CacheEntry *get_row(VariableCache &var_cache, int row) {
+        return &var_cache.entries[row * var_cache.row_size];
+    }
+    const CacheEntry *get_row(const VariableCache &var_cache, int row) const {
+        return &var_cache.entries[row * var_cache.row_size];
+    }
+    int find_row(const VariableCache &var_cache, std::uint64_t key) const;
+    int insert_row(VariableCache &var_cache, std::uint64_t key);
+    int evict_row(VariableCache &var_cache);
+    CacheEntry *get_row_for_storing(VariableCache &var_cache, std::uint64_t key);
 public:
     static const int NOT_COMPUTED = -2;
 
-    CGCache(const TaskProxy &task_proxy, int max_cache_size);
+    CGCache(const TaskProxy &task_proxy, int max_cache_size,
+            int max_hashed_cache_size);
     ~CGCache();
 
     bool is_cached(int var) const {
-        return !cache[var].empty();
+        return variable_caches[var].is_cached;
     }
 
-    int lookup(int var, const State &state, int from_val, int to_val) const {
-        return cache[var][get_index(var, state, from_val, to_val)];
+    static int get_entry_index(int from_val, int to_val) {
+        return (to_val > from_val) ? to_val - 1 : to_val;
     }
 
-    void store(int var, const State &state,
-               int from_val, int to_val, int cost) {
-        cache[var][get_index(var, state, from_val, to_val)] = cost;
-    }
+    /*
+      Return the row for the given start value in the given state, or
+      nullptr if it has not been computed (or has been evicted). The
+      row stays valid until the next call to store(). Unlike find(),
+      lookup() updates the statistics and the eviction order.
+    */
+    const CacheEntry *lookup(int var, const State &state, int from_val);
+    const CacheEntry *find(int var, const State &state, int from_val) const;
 
-    domain_transition_graph::ValueTransitionLabel *lookup_helpful_transition(
-        int var, const State &state, int from_val, int to_val) const {
-        int index = get_index(var, state, from_val, to_val);
-        return helpful_transition_cache[var][index];
-    }
+    /*
+      Return the row for the given start value in the given state. The
+      caller has to set all entries of the row.
+    */
+    CacheEntry *store(int var, const State &state, int from_val);
 
-    void store_helpful_transition(
-        int var, const State &state, int from_val, int to_val,
-        domain_transition_graph::ValueTransitionLabel *helpful_transition) {
-        int index = get_index(var, state, from_val, to_val);
-        helpful_transition_cache[var][index] = helpful_transition;
-    }
+    /*
+      Load and save the cache from/to a text file. Helpful transitions
+      are identified by their position in labels_by_variable[var].
+      Files written for a different task are ignored.
+    */
+    void load(const std::string &filename,
+              const LabelsByVariable &labels_by_variable);
+    void save(const std::string &filename,
+              const LabelsByVariable &labels_by_variable) const;
+
+    void print_statistics() const;
 };
 }
 
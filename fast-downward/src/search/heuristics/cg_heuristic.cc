@@ -19,15 +19,15 @@ using namespace domain_transition_graph;
 namespace cg_heuristic {
 CGHeuristic::CGHeuristic(const Options &opts)
     : Heuristic(opts),
-      cache_hits(0),
-      cache_misses(0),
+      cache_file(opts.get<string>("cache_file")),
       helpful_transition_extraction_counter(0),
       min_action_cost(task_properties::get_min_operator_cost(task_proxy)) {
     cout << "Initializing causal graph heuristic..." << endl;
 
     int max_cache_size = opts.get<int>("max_cache_size");
     if (max_cache_size > 0)
-        cache = utils::make_unique_ptr<CGCache>(task_proxy, max_cache_size);
+        cache = utils::make_unique_ptr<CGCache>(
+            task_proxy, max_cache_size, opts.get<int>("max_hashed_cache_size"));
 
     unsigned int num_vars = task_proxy.get_variables().size();
     prio_queues.reserve(num_vars);
@@ -38,9 +38,34 @@ CGHeuristic::CGHeuristic(const Options &opts)
         [](int dtg_var, int cond_var) {return dtg_var <= cond_var;};
     DTGFactory factory(task_proxy, false, pruning_condition);
     transition_graphs = factory.build_dtgs();
+
+    if (cache_file == "none")
+        cache_file.clear();
+    if (cache && !cache_file.empty())
+        cache->load(cache_file, get_labels_by_variable());
 }
 
 CGHeuristic::~CGHeuristic() {
+    if (cache) {
+        cache->print_statistics();
+        if (!cache_file.empty())
+            cache->save(cache_file, get_labels_by_variable());
+    }
+}
+
+vector<vector<ValueTransitionLabel *>> CGHeuristic::get_labels_by_variable() const {
+    vector<vector<ValueTransitionLabel *>> labels_by_variable;
+    labels_by_variable.reserve(transition_graphs.size());
+    for (auto &dtg : transition_graphs) {
+        labels_by_variable.emplace_back();
+        for (ValueNode &node : dtg->nodes) {
+            for (ValueTransition &transition : node.transitions) {
+                for (ValueTransitionLabel &label : transition.labels)
+                    labels_by_variable.back().push_back(&label);
+            }
+        }
+    }
+    return labels_by_variable;
 }
 
 bool CGHeuristic::dead_ends_are_reliable() const {
@@ -91,13 +116,10 @@ int CGHeuristic::get_transition_cost(const State &state,
     // Check cache.
     bool use_the_cache = cache && cache->is_cached(var_no);
     if (use_the_cache) {
-        int cached_val = cache->lookup(var_no, state, start_val, goal_val);
-        if (cached_val != CGCache::NOT_COMPUTED) {
-            ++cache_hits;
-            return cached_val;
-        }
-    } else {
-        ++cache_misses;
+        const CGCache::CacheEntry *cached_row =
+            cache->lookup(var_no, state, start_val);
+        if (cached_row)
+            return cached_row[CGCache::get_entry_index(start_val, goal_val)].cost;
     }
 
     ValueNode *start = &dtg->nodes[start_val];
@@ -203,6 +225,7 @@ int CGHeuristic::get_transition_cost(const State &state,
     }
 
     if (use_the_cache) {
+        CGCache::CacheEntry *row = cache->store(var_no, state, start_val);
         int num_values = start->distances.size();
         for (int val = 0; val < num_values; ++val) {
             if (val == start_val)
@@ -211,9 +234,10 @@ int CGHeuristic::get_transition_cost(const State &state,
             ValueTransitionLabel *helpful = start->helpful_transitions[val];
             // We should have a helpful transition iff distance is infinite.
             assert((distance == numeric_limits<int>::max()) == !helpful);
-            cache->store(var_no, state, start_val, val, distance);
-            cache->store_helpful_transition(
-                var_no, state, start_val, val, helpful);
+            CGCache::CacheEntry &entry =
+                row[CGCache::get_entry_index(start_val, val)];
+            entry.cost = distance;
+            entry.helpful_transition = helpful;
         }
     }
 
@@ -255,8 +279,16 @@ void CGHeuristic::mark_helpful_transitions(const State &state,
     int cost;
     // Check cache.
     if (cache && cache->is_cached(var_no)) {
-        helpful = cache->lookup_helpful_transition(var_no, state, from, to);
-        cost = cache->lookup(var_no, state, from, to);
+        const CGCache::CacheEntry *cached_row = cache->find(var_no, state, from);
+        if (!cached_row) {
+            // The row has been evicted since we computed the cost.
+            get_transition_cost(state, dtg, from, to);
+            cached_row = cache->find(var_no, state, from);
+        }
+        const CGCache::CacheEntry &entry =
+            cached_row[CGCache::get_entry_index(from, to)];
+        helpful = entry.helpful_transition;
+        cost = entry.cost;
         assert(helpful);
     } else {
         ValueNode *start_node = &dtg->nodes[from];
@@ -303,6 +335,22 @@ static shared_ptr<Heuristic> _parse(OptionParser &parser) {
         "maximum number of cached entries per variable (set to 0 to disable cache)",
         "1000000",
         Bounds("0", "infinity"));
+    parser.add_option<int>(
+        "max_hashed_cache_size",
+        "maximum total number of cached entries for all variables with "
+        "more than max_cache_size entries, split equally among these "
+        "variables. The entries are stored in hash tables that evict the "
+        "least recently used ones (approximately) once they are full. "
+        "Set to 0 to leave such variables uncached.",
+        "1000000",
+        Bounds("0", "infinity"));
+    parser.add_option<string>(
+        "cache_file",
+        "file for warm-starting the cache: if it exists, it is loaded on "
+        "startup, and the cache is written to it when the heuristic is "
+        "destroyed. Note that the search configuration, including this "
+        "file name, is converted to lower case. Use 'none' to disable.",
+        "none");
 
     Heuristic::add_options_to_parser(parser);
     Options opts = parser.parse();
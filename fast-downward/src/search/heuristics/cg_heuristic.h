@@ -12,6 +12,7 @@
 namespace domain_transition_graph {
 class DomainTransitionGraph;
 struct ValueNode;
+struct ValueTransitionLabel;
 }
 
 class GlobalState;
@@ -26,14 +27,15 @@ class CGHeuristic : public Heuristic {
     std::vector<std::unique_ptr<domain_transition_graph::DomainTransitionGraph>> transition_graphs;
 
     std::unique_ptr<CGCache> cache;
-    int cache_hits;
-    int cache_misses;
+    std::string cache_file;
 
     int helpful_transition_extraction_counter;
 
     int min_action_cost;
 
     void setup_domain_transition_graphs();
+    std::vector<std::vector<domain_transition_graph::ValueTransitionLabel *>>
+    get_labels_by_variable() const;
     int get_transition_cost(
         const State &state,
         domain_transition_graph::DomainTransitionGraph *dtg,
@@ -5,259 +5,479 @@
 
 #include "../task_utils/task_properties.h"
 #include "../utils/logging.h"
+#include "../utils/system.h"
 
+#include <algorithm>
 #include <cassert>
+#include <cstdint>
 #include <limits>
-#include <set>
 
 using namespace std;
 
 namespace hm_heuristic {
+static const int INF = numeric_limits<int>::max();
+static const int EMPTY_TUPLE = -1;
+
+enum TargetKind {
+    EFFECT,
+    // Effect on a variable that the operator may set to different values.
+    AMBIGUOUS_EFFECT,
+    PREVAIL,
+    EXTRA_PRECONDITION
+};
+
 HMHeuristic::HMHeuristic(const Options &opts)
     : Heuristic(opts),
       m(opts.get<int>("m")),
-      has_cond_effects(task_properties::has_conditional_effects(task_proxy)),
-      goals(task_properties::get_fact_pairs(task_proxy.get_goals())) {
+      has_cond_effects(task_properties::has_conditional_effects(task_proxy)) {
     cout << "Using h^" << m << "." << endl;
-    cout << "The implementation of the h^m heuristic is preliminary." << endl
-         << "It is SLOOOOOOOOOOOW." << endl
-         << "Please do not use this for comparison!" << endl;
-    generate_all_tuples();
-}
+    build_tuples();
+    build_operators();
 
+    vector<int> goal_facts;
+    for (FactProxy goal : task_proxy.get_goals()) {
+        goal_facts.push_back(
+            fact_offsets[goal.get_variable().get_id()] + goal.get_value());
+    }
+    sort(goal_facts.begin(), goal_facts.end());
+    add_subtuples(goal_facts, 0, EMPTY_TUPLE, -1, 0, goal_tuples);
+    is_goal_tuple.assign(num_tuples, false);
+    for (int tuple : goal_tuples) {
+        is_goal_tuple[tuple] = true;
+    }
 
-bool HMHeuristic::dead_ends_are_reliable() const {
-    return !task_properties::has_axioms(task_proxy) && !has_cond_effects;
+    hm_table.resize(num_tuples);
+    settled.resize(num_tuples);
+    num_unsettled_preconditions.resize(operators.size());
+    precondition_costs.resize(operators.size());
+    cout << "Number of h^" << m << " tuples: " << num_tuples << endl;
 }
 
-
-int HMHeuristic::compute_heuristic(const GlobalState &global_state) {
-    State state = convert_global_state(global_state);
-    if (task_properties::is_goal_state(task_proxy, state)) {
-        return 0;
-    } else {
-        Tuple s_tup = task_properties::get_fact_pairs(state);
-
-        init_hm_table(s_tup);
-        update_hm_table();
-
-        int h = eval(goals);
-
-        if (h == numeric_limits<int>::max())
-            return DEAD_END;
-        return h;
+void HMHeuristic::build_tuples() {
+    int num_facts = 0;
+    for (VariableProxy var : task_proxy.get_variables()) {
+        fact_offsets.push_back(num_facts);
+        for (int value = 0; value < var.get_domain_size(); ++value) {
+            fact_vars.push_back(var.get_id());
+        }
+        num_facts += var.get_domain_size();
     }
-}
-
+    fact_offsets.push_back(num_facts);
 
-void HMHeuristic::init_hm_table(const Tuple &t) {
-    for (auto &hm_ent : hm_table) {
-        const Tuple &tuple = hm_ent.first;
-        int h_val = check_tuple_in_tuple(tuple, t);
-        hm_table[tuple] = h_val;
+    for (int fact = 0; fact < num_facts; ++fact) {
+        tuple_parents.push_back(EMPTY_TUPLE);
+        tuple_last_facts.push_back(fact);
     }
-}
-
-
-void HMHeuristic::update_hm_table() {
-    int round = 0;
-    do {
-        ++round;
-        was_updated = false;
-
-        for (OperatorProxy op : task_proxy.get_operators()) {
-            Tuple pre = get_operator_pre(op);
-
-            int c1 = eval(pre);
-            if (c1 != numeric_limits<int>::max()) {
-                Tuple eff = get_operator_eff(op);
-                vector<Tuple> partial_effs;
-                generate_all_partial_tuples(eff, partial_effs);
-                for (Tuple &partial_eff : partial_effs) {
-                    update_hm_entry(partial_eff, c1 + op.get_cost());
-
-                    int eff_size = partial_eff.size();
-                    if (eff_size < m) {
-                        extend_tuple(partial_eff, op);
-                    }
-                }
+    int64_t total_tuples = num_facts;
+    int level_begin = 0;
+    int level_end = num_facts;
+    for (int size = 1; size < m; ++size) {
+        for (int tuple = level_begin; tuple < level_end; ++tuple) {
+            int first_fact = fact_offsets[fact_vars[tuple_last_facts[tuple]] + 1];
+            total_tuples += num_facts - first_fact;
+            if (total_tuples > numeric_limits<int>::max()) {
+                cerr << "Too many tuples for h^" << m << "." << endl;
+                utils::exit_with(utils::ExitCode::SEARCH_OUT_OF_MEMORY);
+            }
+            child_offsets.push_back(tuple_parents.size());
+            for (int fact = first_fact; fact < num_facts; ++fact) {
+                tuple_parents.push_back(tuple);
+                tuple_last_facts.push_back(fact);
             }
         }
-    } while (was_updated);
+        level_begin = level_end;
+        level_end = total_tuples;
+    }
+    num_tuples = total_tuples;
 }
 
-
-void HMHeuristic::extend_tuple(const Tuple &t, const OperatorProxy &op) {
-    for (auto &hm_ent : hm_table) {
-        const Tuple &tuple = hm_ent.first;
-        bool contradict = false;
-        for (const FactPair &fact : tuple) {
-            if (contradict_effect_of(op, fact.var, fact.value)) {
-                contradict = true;
-                break;
-            }
+void HMHeuristic::build_operators() {
+    int num_variables = task_proxy.get_variables().size();
+    OperatorsProxy ops = task_proxy.get_operators();
+    operators.reserve(ops.size());
+    operator_touches_var.assign(ops.size() * num_variables, false);
+    precondition_of.resize(fact_vars.size());
+    vector<int> num_precondition_tuples(num_tuples, 0);
+    for (OperatorProxy op : ops) {
+        int op_id = op.get_id();
+        HMOperator hm_op;
+        hm_op.cost = op.get_cost();
+        for (FactProxy pre : op.get_preconditions()) {
+            int var = pre.get_variable().get_id();
+            hm_op.preconditions.push_back(fact_offsets[var] + pre.get_value());
+            operator_touches_var[op_id * num_variables + var] = true;
         }
-        if (!contradict && (tuple.size() > t.size()) && (check_tuple_in_tuple(t, tuple) == 0)) {
-            Tuple pre = get_operator_pre(op);
-
-            Tuple others;
-            for (const FactPair &fact : tuple) {
-                if (find(t.begin(), t.end(), fact) == t.end()) {
-                    others.push_back(fact);
-                    if (find(pre.begin(), pre.end(), fact) == pre.end()) {
-                        pre.push_back(fact);
-                    }
-                }
-            }
-
-            sort(pre.begin(), pre.end());
-
-            set<int> vars;
-            bool is_valid = true;
-            for (const FactPair &fact : pre) {
-                if (vars.count(fact.var) != 0) {
-                    is_valid = false;
-                    break;
-                }
-                vars.insert(fact.var);
+        sort(hm_op.preconditions.begin(), hm_op.preconditions.end());
+        for (EffectProxy eff : op.get_effects()) {
+            FactProxy fact = eff.get_fact();
+            int var = fact.get_variable().get_id();
+            hm_op.effects.push_back(fact_offsets[var] + fact.get_value());
+            operator_touches_var[op_id * num_variables + var] = true;
+        }
+        sort(hm_op.effects.begin(), hm_op.effects.end());
+        hm_op.effects.erase(
+            unique(hm_op.effects.begin(), hm_op.effects.end()),
+            hm_op.effects.end());
+        for (int pre : hm_op.preconditions) {
+            int var = fact_vars[pre];
+            if (none_of(hm_op.effects.begin(), hm_op.effects.end(),
+                        [&](int eff) {return fact_vars[eff] == var;})) {
+                hm_op.prevails.push_back(pre);
             }
+            precondition_of[pre].push_back(op_id);
+        }
+        add_subtuples(
+            hm_op.preconditions, 0, EMPTY_TUPLE, -1, 0,
+            hm_op.precondition_tuples);
+        for (int tuple : hm_op.precondition_tuples) {
+            ++num_precondition_tuples[tuple];
+        }
+        operators.push_back(move(hm_op));
+    }
 
-            if (is_valid) {
-                int c2 = eval(pre);
-                if (c2 != numeric_limits<int>::max()) {
-                    update_hm_entry(tuple, c2 + op.get_cost());
-                }
-            }
+    precondition_tuple_offsets.reserve(num_tuples + 1);
+    int offset = 0;
+    for (int tuple = 0; tuple < num_tuples; ++tuple) {
+        precondition_tuple_offsets.push_back(offset);
+        offset += num_precondition_tuples[tuple];
+    }
+    precondition_tuple_offsets.push_back(offset);
+    precondition_tuple_operators.resize(offset);
+    for (size_t op_id = 0; op_id < operators.size(); ++op_id) {
+        for (int tuple : operators[op_id].precondition_tuples) {
+            int pos = precondition_tuple_offsets[tuple + 1] -
+                num_precondition_tuples[tuple]--;
+            precondition_tuple_operators[pos] = op_id;
         }
     }
 }
 
+int HMHeuristic::extend_tuple(int tuple, int last_var, int fact) const {
+    if (tuple == EMPTY_TUPLE) {
+        return fact;
+    }
+    assert(fact_vars[fact] > last_var);
+    return child_offsets[tuple] + fact - fact_offsets[last_var + 1];
+}
 
-int HMHeuristic::eval(const Tuple &t) const {
-    vector<Tuple> partial;
-    generate_all_partial_tuples(t, partial);
-    int max = 0;
-    for (Tuple &tuple : partial) {
-        assert(hm_table.count(tuple) == 1);
-
-        int h = hm_table.at(tuple);
-        if (h > max) {
-            max = h;
+void HMHeuristic::add_subtuples(
+    const vector<int> &facts, int pos, int tuple, int last_var, int size,
+    vector<int> &tuples) const {
+    for (size_t i = pos; i < facts.size(); ++i) {
+        int fact = facts[i];
+        int var = fact_vars[fact];
+        int subtuple = extend_tuple(tuple, last_var, fact);
+        tuples.push_back(subtuple);
+        if (size + 1 < m) {
+            add_subtuples(facts, i + 1, subtuple, var, size + 1, tuples);
         }
     }
-    return max;
 }
 
+bool HMHeuristic::touches(int op_id, int var) const {
+    return operator_touches_var[op_id * (fact_offsets.size() - 1) + var];
+}
 
-int HMHeuristic::update_hm_entry(const Tuple &t, int val) {
-    assert(hm_table.count(t) == 1);
-    if (hm_table[t] > val) {
-        hm_table[t] = val;
-        was_updated = true;
-    }
-    return val;
+bool HMHeuristic::has_precondition(const HMOperator &op, int fact) const {
+    return binary_search(op.preconditions.begin(), op.preconditions.end(), fact);
 }
 
+bool HMHeuristic::dead_ends_are_reliable() const {
+    return !task_properties::has_axioms(task_proxy) && !has_cond_effects;
+}
 
-int HMHeuristic::check_tuple_in_tuple(
-    const Tuple &tuple, const Tuple &big_tuple) const {
-    for (const FactPair &fact0 : tuple) {
-        bool found = false;
-        for (auto &fact1 : big_tuple) {
-            if (fact0 == fact1) {
-                found = true;
-                break;
-            }
+void HMHeuristic::update_hm_entry(int tuple, int value) {
+    if (value < hm_table[tuple]) {
+        assert(!settled[tuple]);
+        hm_table[tuple] = value;
+        queue.push(value, tuple);
+    }
+}
+
+/*
+  Compute the maximum value of all subtuples of instance_facts that
+  contain at least one extra precondition. Return false if one of them
+  is not settled yet.
+*/
+bool HMHeuristic::get_max_extra_subtuple_value(
+    int pos, int tuple, int last_var, int size, bool has_extra,
+    int &max_value) const {
+    for (size_t i = pos; i < instance_facts.size(); ++i) {
+        int fact = instance_facts[i];
+        int subtuple = extend_tuple(tuple, last_var, fact);
+        bool subtuple_has_extra = has_extra || instance_fact_is_extra[i];
+        if (subtuple_has_extra) {
+            if (!settled[subtuple])
+                return false;
+            max_value = max(max_value, hm_table[subtuple]);
         }
-        if (!found) {
-            return numeric_limits<int>::max();
+        if (size + 1 < m &&
+            !get_max_extra_subtuple_value(
+                i + 1, subtuple, fact_vars[fact], size + 1, subtuple_has_extra,
+                max_value)) {
+            return false;
         }
     }
-    return 0;
+    return true;
 }
 
-
-HMHeuristic::Tuple HMHeuristic::get_operator_pre(const OperatorProxy &op) const {
-    Tuple preconditions = task_properties::get_fact_pairs(op.get_preconditions());
-    sort(preconditions.begin(), preconditions.end());
-    return preconditions;
+/*
+  Update all tuples S u Y u Z reached by the current action, where S is
+  a non-empty set of effects, Y are the extra preconditions and Z is a
+  set of prevail conditions. Like before, tuples combining effects on
+  variables with multiple effect values with other facts are ignored.
+*/
+void HMHeuristic::update_targets(
+    int pos, int tuple, int last_var, int size, int num_extra,
+    bool has_effect, bool has_ambiguous_effect, bool has_other, int value) {
+    int num_required = extra_preconditions.size();
+    for (size_t i = pos; i < target_facts.size(); ++i) {
+        int fact = target_facts[i];
+        int var = fact_vars[fact];
+        int kind = target_fact_kinds[i];
+        if (var != last_var) {
+            int subtuple = extend_tuple(tuple, last_var, fact);
+            int new_num_extra = num_extra + (kind == EXTRA_PRECONDITION);
+            bool new_has_effect =
+                has_effect || kind == EFFECT || kind == AMBIGUOUS_EFFECT;
+            bool new_has_ambiguous_effect =
+                has_ambiguous_effect || kind == AMBIGUOUS_EFFECT;
+            bool new_has_other =
+                has_other || kind == PREVAIL || kind == EXTRA_PRECONDITION;
+            if (new_num_extra == num_required && new_has_effect &&
+                !(new_has_ambiguous_effect && new_has_other)) {
+                update_hm_entry(subtuple, value);
+            }
+            if (size + 1 < m) {
+                update_targets(
+                    i + 1, subtuple, var, size + 1, new_num_extra,
+                    new_has_effect, new_has_ambiguous_effect, new_has_other,
+                    value);
+            }
+        }
+        // All targets contain the extra preconditions.
+        if (kind == EXTRA_PRECONDITION)
+            break;
+    }
 }
 
-
-HMHeuristic::Tuple HMHeuristic::get_operator_eff(const OperatorProxy &op) const {
-    Tuple effects;
-    for (EffectProxy eff : op.get_effects()) {
-        effects.push_back(eff.get_fact().get_pair());
+/*
+  Apply the action consisting of the given (ready) operator and the
+  extra preconditions if all of its precondition subtuples are settled.
+*/
+void HMHeuristic::apply_instance(int op_id) {
+    const HMOperator &op = operators[op_id];
+    int value = precondition_costs[op_id];
+    auto is_extra = [&](int fact) {
+            return find(extra_preconditions.begin(), extra_preconditions.end(),
+                        fact) != extra_preconditions.end();
+        };
+
+    if (!extra_preconditions.empty()) {
+        instance_facts = op.preconditions;
+        instance_facts.insert(
+            instance_facts.end(), extra_preconditions.begin(),
+            extra_preconditions.end());
+        sort(instance_facts.begin(), instance_facts.end());
+        instance_fact_is_extra.clear();
+        for (int fact : instance_facts) {
+            instance_fact_is_extra.push_back(is_extra(fact));
+        }
+        int extra_value = 0;
+        if (!get_max_extra_subtuple_value(0, EMPTY_TUPLE, -1, 0, false, extra_value))
+            return;
+        value = max(value, extra_value);
     }
-    sort(effects.begin(), effects.end());
-    return effects;
+    value += op.cost;
+
+    target_facts = op.effects;
+    target_facts.insert(target_facts.end(), op.prevails.begin(), op.prevails.end());
+    target_facts.insert(
+        target_facts.end(), extra_preconditions.begin(), extra_preconditions.end());
+    sort(target_facts.begin(), target_facts.end());
+    target_fact_kinds.clear();
+    for (size_t i = 0; i < target_facts.size(); ++i) {
+        int fact = target_facts[i];
+        int var = fact_vars[fact];
+        if (is_extra(fact)) {
+            target_fact_kinds.push_back(EXTRA_PRECONDITION);
+        } else if (binary_search(op.prevails.begin(), op.prevails.end(), fact)) {
+            target_fact_kinds.push_back(PREVAIL);
+        } else if ((i > 0 && fact_vars[target_facts[i - 1]] == var) ||
+                   (i + 1 < target_facts.size() &&
+                    fact_vars[target_facts[i + 1]] == var)) {
+            target_fact_kinds.push_back(AMBIGUOUS_EFFECT);
+        } else {
+            target_fact_kinds.push_back(EFFECT);
+        }
+    }
+    update_targets(0, EMPTY_TUPLE, -1, 0, 0, false, false, false, value);
 }
 
-
-bool HMHeuristic::contradict_effect_of(
-    const OperatorProxy &op, int var, int val) const {
-    for (EffectProxy eff : op.get_effects()) {
-        FactProxy fact = eff.get_fact();
-        if (fact.get_variable().get_id() == var && fact.get_value() != val) {
-            return true;
+/*
+  Apply all actions for the given operator whose extra preconditions
+  extend the current extra preconditions by up to max_size facts on
+  free variables, starting with first_fact.
+*/
+void HMHeuristic::apply_instances_with_extra_preconditions(
+    int op_id, int first_fact, int max_size) {
+    int num_facts = fact_vars.size();
+    for (int fact = first_fact; fact < num_facts; ++fact) {
+        int var = fact_vars[fact];
+        if (touches(op_id, var) ||
+            any_of(extra_preconditions.begin(), extra_preconditions.end(),
+                   [&](int extra) {return fact_vars[extra] == var;})) {
+            // Skip the remaining facts of this variable.
+            fact = fact_offsets[var + 1] - 1;
+            continue;
         }
+        extra_preconditions.push_back(fact);
+        apply_instance(op_id);
+        if (max_size > 1) {
+            apply_instances_with_extra_preconditions(
+                op_id, fact_offsets[var + 1], max_size - 1);
+        }
+        extra_preconditions.pop_back();
     }
-    return false;
 }
 
-
-void HMHeuristic::generate_all_tuples() {
-    Tuple t;
-    generate_all_tuples_aux(0, m, t);
+void HMHeuristic::operator_becomes_ready(int op_id) {
+    const HMOperator &op = operators[op_id];
+    int cost = 0;
+    for (int tuple : op.precondition_tuples) {
+        assert(settled[tuple]);
+        cost = max(cost, hm_table[tuple]);
+    }
+    precondition_costs[op_id] = cost;
+    extra_preconditions.clear();
+    apply_instance(op_id);
+    if (m > 1) {
+        apply_instances_with_extra_preconditions(op_id, 0, m - 1);
+    }
 }
 
+/*
+  Decrement the counters of operators with the tuple as a precondition
+  subtuple, and reapply the actions of ready operators that have the
+  tuple as a subtuple of pre(o) u Y with Y containing at least one fact
+  of the tuple.
+*/
+void HMHeuristic::tuple_settled(int tuple) {
+    for (int i = precondition_tuple_offsets[tuple];
+         i < precondition_tuple_offsets[tuple + 1]; ++i) {
+        int op_id = precondition_tuple_operators[i];
+        if (--num_unsettled_preconditions[op_id] == 0) {
+            operator_becomes_ready(op_id);
+        }
+    }
+
+    tuple_facts.clear();
+    for (int t = tuple; t != EMPTY_TUPLE; t = tuple_parents[t]) {
+        tuple_facts.push_back(tuple_last_facts[t]);
+    }
+    reverse(tuple_facts.begin(), tuple_facts.end());
+    int tuple_size = tuple_facts.size();
+
+    auto apply_instances = [&](int op_id) {
+            apply_instance(op_id);
+            int num_missing = m - 1 - extra_preconditions.size();
+            if (num_missing > 0) {
+                apply_instances_with_extra_preconditions(op_id, 0, num_missing);
+            }
+        };
+
+    // Operators for which tuple_facts[i] is the first precondition fact.
+    for (int i = 0; i < tuple_size; ++i) {
+        for (int op_id : precondition_of[tuple_facts[i]]) {
+            if (num_unsettled_preconditions[op_id] != 0)
+                continue;
+            const HMOperator &op = operators[op_id];
+            extra_preconditions.clear();
+            bool is_relevant = true;
+            for (int j = 0; j < tuple_size; ++j) {
+                int fact = tuple_facts[j];
+                if (j == i || (j > i && has_precondition(op, fact)))
+                    continue;
+                if (touches(op_id, fact_vars[fact])) {
+                    is_relevant = false;
+                    break;
+                }
+                extra_preconditions.push_back(fact);
+            }
+            if (is_relevant && !extra_preconditions.empty()) {
+                apply_instances(op_id);
+            }
+        }
+    }
 
-void HMHeuristic::generate_all_tuples_aux(int var, int sz, const Tuple &base) {
-    int num_variables = task_proxy.get_variables().size();
-    for (int i = var; i < num_variables; ++i) {
-        int domain_size = task_proxy.get_variables()[i].get_domain_size();
-        for (int j = 0; j < domain_size; ++j) {
-            Tuple tuple(base);
-            tuple.emplace_back(i, j);
-            hm_table[tuple] = 0;
-            if (sz > 1) {
-                generate_all_tuples_aux(i + 1, sz - 1, tuple);
+    // Operators for which all facts are extra preconditions.
+    if (tuple_size < m) {
+        int num_operators = operators.size();
+        for (int op_id = 0; op_id < num_operators; ++op_id) {
+            if (num_unsettled_preconditions[op_id] != 0 ||
+                any_of(tuple_facts.begin(), tuple_facts.end(),
+                       [&](int fact) {return touches(op_id, fact_vars[fact]);})) {
+                continue;
             }
+            extra_preconditions = tuple_facts;
+            apply_instances(op_id);
         }
     }
 }
 
+int HMHeuristic::compute_heuristic(const GlobalState &global_state) {
+    State state = convert_global_state(global_state);
+    if (task_properties::is_goal_state(task_proxy, state)) {
+        return 0;
+    }
 
-void HMHeuristic::generate_all_partial_tuples(
-    const Tuple &base_tuple, vector<Tuple> &res) const {
-    Tuple t;
-    generate_all_partial_tuples_aux(base_tuple, t, 0, m, res);
-}
+    fill(hm_table.begin(), hm_table.end(), INF);
+    fill(settled.begin(), settled.end(), false);
+    queue.clear();
 
+    vector<int> state_facts;
+    for (FactProxy fact : state) {
+        state_facts.push_back(
+            fact_offsets[fact.get_variable().get_id()] + fact.get_value());
+    }
+    vector<int> initial_tuples;
+    add_subtuples(state_facts, 0, EMPTY_TUPLE, -1, 0, initial_tuples);
+    for (int tuple : initial_tuples) {
+        update_hm_entry(tuple, 0);
+    }
 
-void HMHeuristic::generate_all_partial_tuples_aux(
-    const Tuple &base_tuple, const Tuple &t, int index, int sz, vector<Tuple> &res) const {
-    if (sz == 1) {
-        for (size_t i = index; i < base_tuple.size(); ++i) {
-            Tuple tuple(t);
-            tuple.push_back(base_tuple[i]);
-            res.push_back(tuple);
-        }
-    } else {
-        for (size_t i = index; i < base_tuple.size(); ++i) {
-            Tuple tuple(t);
-            tuple.push_back(base_tuple[i]);
-            res.push_back(tuple);
-            generate_all_partial_tuples_aux(base_tuple, tuple, i + 1, sz - 1, res);
+    int num_operators = operators.size();
+    for (int op_id = 0; op_id < num_operators; ++op_id) {
+        num_unsettled_preconditions[op_id] =
+            operators[op_id].precondition_tuples.size();
+    }
+    for (int op_id = 0; op_id < num_operators; ++op_id) {
+        if (num_unsettled_preconditions[op_id] == 0) {
+            operator_becomes_ready(op_id);
         }
     }
-}
 
+    int num_unsettled_goal_tuples = goal_tuples.size();
+    while (!queue.empty()) {
+        pair<int, int> top = queue.pop();
+        int value = top.first;
+        int tuple = top.second;
+        if (settled[tuple] || value > hm_table[tuple])
+            continue;
+        assert(value == hm_table[tuple]);
+        settled[tuple] = true;
+        if (is_goal_tuple[tuple] && --num_unsettled_goal_tuples == 0)
+            break;
+        tuple_settled(tuple);
+    }
 
-void HMHeuristic::dump_table() const {
-    for (auto &hm_ent : hm_table) {
-        cout << "h(" << hm_ent.first << ") = " << hm_ent.second << endl;
+    int h = 0;
+    for (int tuple : goal_tuples) {
+        h = max(h, hm_table[tuple]);
     }
+    if (h == INF)
+        return DEAD_END;
+    return h;
 }
 
 
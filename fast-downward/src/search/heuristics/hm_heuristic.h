@@ -3,10 +3,8 @@
 
 #include "../heuristic.h"
 
-#include <algorithm>
-#include <iostream>
-#include <map>
-#include <string>
+#include "../algorithms/priority_queues.h"
+
 #include <vector>
 
 namespace options {
@@ -17,45 +15,97 @@ namespace hm_heuristic {
 /*
   Haslum's h^m heuristic family ("critical path heuristics").
 
-  This is a very slow implementation and should not be used for
-  speed benchmarks.
+  Tuples are sets of at most m facts on pairwise different variables.
+  We compute h^m for all tuples with a generalized Dijkstra search in
+  the compiled task Pi^m: an action (o, Y) consists of an operator o
+  and a tuple Y of extra preconditions on variables that o neither
+  mentions in its precondition nor affects. Its cost is the maximum
+  h^m value of all subtuples of pre(o) u Y plus cost(o), and it
+  achieves all tuples S u Y u Z, where S is a non-empty subset of
+  eff(o) and Z is a subset of the prevail conditions of o. The search
+  stops as soon as all subtuples of the goal are settled.
 */
-
 class HMHeuristic : public Heuristic {
-    using Tuple = std::vector<FactPair>;
+    struct HMOperator {
+        // Fact IDs, sorted by variable.
+        std::vector<int> preconditions;
+        std::vector<int> effects;
+        std::vector<int> prevails;
+        // Tuple IDs of all subtuples of the precondition.
+        std::vector<int> precondition_tuples;
+        int cost;
+    };
+
     // parameters
     const int m;
     const bool has_cond_effects;
 
-    const Tuple goals;
-
-    // h^m table
-    std::map<Tuple, int> hm_table;
-    bool was_updated;
-
-    // auxiliary methods
-    void init_hm_table(const Tuple &t);
-    void update_hm_table();
-    int eval(const Tuple &t) const;
-    int update_hm_entry(const Tuple &t, int val);
-    void extend_tuple(const Tuple &t, const OperatorProxy &op);
-
-    int check_tuple_in_tuple(const Tuple &tuple, const Tuple &big_tuple) const;
-
-    int get_operator_pre_value(const OperatorProxy &op, int var) const;
-    Tuple get_operator_pre(const OperatorProxy &op) const;
-    Tuple get_operator_eff(const OperatorProxy &op) const;
-    bool contradict_effect_of(const OperatorProxy &op, int var, int val) const;
-
-    void generate_all_tuples();
-    void generate_all_tuples_aux(int var, int sz, const Tuple &base);
-
-    void generate_all_partial_tuples(const Tuple &base_tuple,
-                                     std::vector<Tuple> &res) const;
-    void generate_all_partial_tuples_aux(const Tuple &base_tuple, const Tuple &t, int index,
-                                         int sz, std::vector<Tuple> &res) const;
-
-    void dump_table() const;
+    /* Facts are numbered consecutively and ordered by variable. The IDs
+       of the facts of variable var start at fact_offsets[var]. */
+    std::vector<int> fact_offsets;
+    std::vector<int> fact_vars;
+
+    /*
+      Tuples are numbered level-wise: the tuples of size 1 get the fact
+      IDs and the extensions of a tuple t of size k < m by a fact on a
+      variable greater than the last variable of t are numbered
+      consecutively, starting at child_offsets[t]. All tuples of size
+      k < m therefore come before the tuples of size m.
+    */
+    std::vector<int> child_offsets;
+    std::vector<int> tuple_parents;
+    std::vector<int> tuple_last_facts;
+    int num_tuples;
+
+    std::vector<HMOperator> operators;
+    // Bitmap of the variables that each operator mentions.
+    std::vector<bool> operator_touches_var;
+    // Operators with the given fact in their precondition.
+    std::vector<std::vector<int>> precondition_of;
+    // Operators that have the given tuple as a precondition subtuple.
+    std::vector<int> precondition_tuple_offsets;
+    std::vector<int> precondition_tuple_operators;
+
+    std::vector<int> goal_tuples;
+    std::vector<bool> is_goal_tuple;
+
+    // Per-evaluation data.
+    std::vector<int> hm_table;
+    std::vector<bool> settled;
+    std::vector<int> num_unsettled_preconditions;
+    std::vector<int> precondition_costs;
+    priority_queues::AdaptiveQueue<int> queue;
+
+    // Scratch space for enumerating subtuples.
+    std::vector<int> extra_preconditions;
+    std::vector<int> instance_facts;
+    std::vector<bool> instance_fact_is_extra;
+    std::vector<int> target_facts;
+    std::vector<int> target_fact_kinds;
+    std::vector<int> tuple_facts;
+
+    int extend_tuple(int tuple, int last_var, int fact) const;
+    void add_subtuples(
+        const std::vector<int> &facts, int pos, int tuple, int last_var,
+        int size, std::vector<int> &tuples) const;
+    bool touches(int op_id, int var) const;
+    bool has_precondition(const HMOperator &op, int fact) const;
+
+    void build_tuples();
+    void build_operators();
+
+    void update_hm_entry(int tuple, int value);
+    bool get_max_extra_subtuple_value(
+        int pos, int tuple, int last_var, int size, bool has_extra,
+        int &max_value) const;
+    void update_targets(
+        int pos, int tuple, int last_var, int size, int num_extra,
+        bool has_effect, bool has_ambiguous_effect, bool has_other, int value);
+    void apply_instance(int op_id);
+    void apply_instances_with_extra_preconditions(
+        int op_id, int first_fact, int max_size);
+    void operator_becomes_ready(int op_id);
+    void tuple_settled(int tuple);
 
 protected:
     virtual int compute_heuristic(const GlobalState &global_state);
@@ -0,0 +1,215 @@
+#include "layered_ff_heuristic.h"
+
+#include "../global_state.h"
+#include "../option_parser.h"
+#include "../plugin.h"
+
+#include "../task_utils/task_properties.h"
+
+#include <algorithm>
+#include <cassert>
+
+using namespace std;
+
+namespace layered_ff_heuristic {
+static int get_num_words(int num_bits) {
+    return (num_bits + 63) / 64;
+}
+
+// construction and destruction
+LayeredFFHeuristic::LayeredFFHeuristic(const Options &opts)
+    : RelaxationHeuristic(opts),
+      relaxed_plan(task_proxy.get_operators().size(), false) {
+    cout << "Initializing layered FF heuristic..." << endl;
+    int num_propositions = propositions.size();
+    int num_unary_ops = unary_operators.size();
+
+    reached.resize(get_num_words(num_propositions), 0);
+    marked.resize(get_num_words(num_propositions), 0);
+    layer.resize(num_propositions, -1);
+    reached_by.resize(num_propositions, NO_OP);
+
+    num_preconditions.reserve(num_unary_ops);
+    for (OpID op_id = 0; op_id < num_unary_ops; ++op_id) {
+        int num_op_preconditions = unary_operators[op_id].num_preconditions;
+        num_preconditions.push_back(num_op_preconditions);
+        if (num_op_preconditions == 0)
+            precondition_free_operators.push_back(op_id);
+    }
+    unsatisfied_preconditions = num_preconditions;
+
+    if (!task_properties::is_unit_cost(task_proxy)) {
+        cout << "Layered FF heuristic: the task has non-unit costs; "
+             << "supporters are selected by layer, not by cost." << endl;
+    }
+}
+
+bool LayeredFFHeuristic::reach(PropID prop_id, int prop_layer, OpID op_id) {
+    uint64_t &word = reached[prop_id / 64];
+    uint64_t mask = uint64_t(1) << (prop_id % 64);
+    if (word & mask)
+        return false;
+    word |= mask;
+    layer[prop_id] = prop_layer;
+    reached_by[prop_id] = op_id;
+    return true;
+}
+
+void LayeredFFHeuristic::apply_operator(
+    OpID op_id, int next_layer_index, int &num_unreached_goals) {
+    PropID effect = unary_operators[op_id].effect;
+    if (reach(effect, next_layer_index, op_id)) {
+        next_layer.push_back(effect);
+        if (propositions[effect].is_goal)
+            --num_unreached_goals;
+    }
+}
+
+int LayeredFFHeuristic::build_layers(const State &state) {
+    fill(reached.begin(), reached.end(), 0);
+    unsatisfied_preconditions = num_preconditions;
+
+    int num_unreached_goals = goal_propositions.size();
+    current_layer.clear();
+    const vector<int> &values = state.get_values();
+    int num_vars = values.size();
+    for (int var = 0; var < num_vars; ++var) {
+        PropID prop_id = get_prop_id(var, values[var]);
+        if (reach(prop_id, 0, NO_OP)) {
+            current_layer.push_back(prop_id);
+            if (propositions[prop_id].is_goal)
+                --num_unreached_goals;
+        }
+    }
+
+    if (num_unreached_goals == 0)
+        return 1;
+
+    next_layer.clear();
+    for (OpID op_id : precondition_free_operators)
+        apply_operator(op_id, 1, num_unreached_goals);
+    int layer_index = 0;
+    while (true) {
+        for (PropID prop_id : current_layer) {
+            const Proposition &prop = propositions[prop_id];
+            for (OpID op_id : precondition_of_pool.get_slice(
+                     prop.precondition_of, prop.num_precondition_occurences)) {
+                assert(unsatisfied_preconditions[op_id] > 0);
+                if (--unsatisfied_preconditions[op_id] == 0)
+                    apply_operator(op_id, layer_index + 1, num_unreached_goals);
+            }
+        }
+        if (next_layer.empty())
+            return -1;
+        swap(current_layer, next_layer);
+        next_layer.clear();
+        ++layer_index;
+        if (num_unreached_goals == 0)
+            return layer_index + 1;
+    }
+}
+
+void LayeredFFHeuristic::mark_subgoal(PropID prop_id) {
+    assert(is_reached(prop_id));
+    int prop_layer = layer[prop_id];
+    if (prop_layer == 0)
+        return;
+    uint64_t &word = marked[prop_id / 64];
+    uint64_t mask = uint64_t(1) << (prop_id % 64);
+    if (word & mask)
+        return;
+    word |= mask;
+    goals_by_layer[prop_layer].push_back(prop_id);
+}
+
+int LayeredFFHeuristic::extract_relaxed_plan(int num_layers) {
+    fill(marked.begin(), marked.end(), 0);
+    if (static_cast<int>(goals_by_layer.size()) < num_layers)
+        goals_by_layer.resize(num_layers);
+    for (int i = 0; i < num_layers; ++i)
+        goals_by_layer[i].clear();
+
+    for (PropID goal_id : goal_propositions)
+        mark_subgoal(goal_id);
+
+    /*
+      Each subgoal in layer i is achieved by an operator whose
+      preconditions lie in layers < i, so processing the layers top-down
+      visits every subgoal after all subgoals that depend on it.
+    */
+    int h_ff = 0;
+    for (int i = num_layers - 1; i > 0; --i) {
+        for (PropID subgoal : goals_by_layer[i]) {
+            OpID op_id = reached_by[subgoal];
+            assert(op_id != NO_OP);
+            bool is_preferred = true;
+            for (PropID precond : get_preconditions(op_id)) {
+                if (layer[precond] != 0) {
+                    is_preferred = false;
+                    mark_subgoal(precond);
+                }
+            }
+            const UnaryOperator &unary_op = unary_operators[op_id];
+            int operator_no = unary_op.operator_no;
+            if (operator_no != -1) {
+                // This is not an axiom.
+                if (!relaxed_plan[operator_no]) {
+                    relaxed_plan[operator_no] = true;
+                    relaxed_plan_operators.push_back(operator_no);
+                    h_ff += unary_op.base_cost;
+                }
+                if (is_preferred) {
+                    OperatorProxy op = task_proxy.get_operators()[operator_no];
+                    assert(task_properties::is_applicable(op, state));
+                    set_preferred(op);
+                }
+            }
+        }
+    }
+
+    // Clean up for next computation.
+    for (int operator_no : relaxed_plan_operators)
+        relaxed_plan[operator_no] = false;
+    relaxed_plan_operators.clear();
+    return h_ff;
+}
+
+int LayeredFFHeuristic::compute_heuristic(const GlobalState &global_state) {
+    State state = convert_global_state(global_state);
+    int num_layers = build_layers(state);
+    if (num_layers == -1)
+        return DEAD_END;
+    return extract_relaxed_plan(num_layers);
+}
+
+
+static shared_ptr<Heuristic> _parse(OptionParser &parser) {
+    parser.document_synopsis(
+        "Layered FF heuristic",
+        "FF heuristic computed on a layered relaxed planning graph, as in "
+        "the original FF planner. It does not need a priority queue and "
+        "is intended for unit-cost tasks. For tasks with "
+        "general costs, supporters are chosen by layer, and action costs "
+        "are only used to sum up the cost of the relaxed plan.");
+    parser.document_language_support("action costs", "supported");
+    parser.document_language_support("conditional effects", "supported");
+    parser.document_language_support(
+        "axioms",
+        "supported (in the sense that the planner won't complain -- "
+        "handling of axioms might be very stupid "
+        "and even render the heuristic unsafe)");
+    parser.document_property("admissible", "no");
+    parser.document_property("consistent", "no");
+    parser.document_property("safe", "yes for tasks without axioms");
+    parser.document_property("preferred operators", "yes");
+
+    Heuristic::add_options_to_parser(parser);
+    Options opts = parser.parse();
+    if (parser.dry_run())
+        return nullptr;
+    else
+        return make_shared<LayeredFFHeuristic>(opts);
+}
+
+static Plugin<Evaluator> _plugin("layered_ff", _parse);
+}
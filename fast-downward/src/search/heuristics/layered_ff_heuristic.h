@@ -0,0 +1,77 @@
+#ifndef HEURISTICS_LAYERED_FF_HEURISTIC_H
+#define HEURISTICS_LAYERED_FF_HEURISTIC_H
+
+#include "relaxation_heuristic.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace layered_ff_heuristic {
+using relaxation_heuristic::PropID;
+using relaxation_heuristic::OpID;
+
+using relaxation_heuristic::NO_OP;
+
+using relaxation_heuristic::Proposition;
+using relaxation_heuristic::UnaryOperator;
+
+/*
+  FF heuristic based on a layered relaxed planning graph, as in the
+  original FF planner. Instead of running Dijkstra's algorithm on h^add
+  costs, we compute reachability breadth-first: layer 0 holds the facts
+  of the evaluated state and layer i + 1 holds the facts first achieved
+  by unary operators whose last precondition appears in layer i. The
+  relaxed plan is then extracted backwards from the goals using the
+  layer indices.
+
+  Reachability is tracked with precondition counters and bitsets over
+  the propositions, which can be reset 64 propositions at a time. All
+  data structures are allocated once and only reset between
+  evaluations.
+
+  For unit-cost tasks, the layers coincide with h^max values and no
+  priority queue is needed. For tasks with general costs, supporters
+  are still chosen by layer, i.e., action costs are only considered
+  when summing up the cost of the relaxed plan.
+*/
+class LayeredFFHeuristic : public relaxation_heuristic::RelaxationHeuristic {
+    // Bitsets over propositions.
+    std::vector<uint64_t> reached;
+    std::vector<uint64_t> marked;
+
+    // Number of preconditions of each unary operator (constant).
+    std::vector<int> num_preconditions;
+    std::vector<int> unsatisfied_preconditions;
+    std::vector<OpID> precondition_free_operators;
+
+    // Only meaningful for reached propositions.
+    std::vector<int> layer;
+    std::vector<OpID> reached_by;
+
+    std::vector<PropID> current_layer;
+    std::vector<PropID> next_layer;
+    std::vector<std::vector<PropID>> goals_by_layer;
+
+    // Relaxed plans are represented as a set of operators implemented
+    // as a bit vector.
+    std::vector<bool> relaxed_plan;
+    std::vector<int> relaxed_plan_operators;
+
+    bool is_reached(PropID prop_id) const {
+        return reached[prop_id / 64] & (uint64_t(1) << (prop_id % 64));
+    }
+
+    bool reach(PropID prop_id, int prop_layer, OpID op_id);
+    void apply_operator(
+        OpID op_id, int next_layer_index, int &num_unreached_goals);
+    int build_layers(const State &state);
+    int extract_relaxed_plan(int num_layers);
+    void mark_subgoal(PropID prop_id);
+protected:
+    virtual int compute_heuristic(const GlobalState &global_state) override;
+public:
+    explicit LayeredFFHeuristic(const options::Options &opts);
+};
+}
+
+#endif
@@ -12,7 +12,10 @@
 
 namespace lm_cut_heuristic {
 // TODO: Fix duplication with the other relaxation heuristics.
-struct RelaxedProposition;
+using PropID = int;
+using OpID = int;
+
+const PropID NO_PROP = -1;
 
 enum PropositionStatus {
     UNREACHED = 0,
@@ -21,64 +24,127 @@ enum PropositionStatus {
     BEFORE_GOAL_ZONE = 3
 };
 
-struct RelaxedOperator {
-    int original_op_id;
-    std::vector<RelaxedProposition *> preconditions;
-    std::vector<RelaxedProposition *> effects;
-    int base_cost; // 0 for axioms, 1 for regular operators
+// Range of positions in one of the ID pools of LandmarkCutLandmarks.
+struct IDRange {
+    int begin;
+    int end;
+};
+
+class IDSlice {
+    const int *first;
+    const int *last;
+public:
+    IDSlice(const std::vector<int> &pool, IDRange range)
+        : first(pool.data() + range.begin),
+          last(pool.data() + range.end) {
+        assert(0 <= range.begin && range.begin <= range.end &&
+               range.end <= static_cast<int>(pool.size()));
+    }
+
+    const int *begin() const {
+        return first;
+    }
+
+    const int *end() const {
+        return last;
+    }
+};
 
+/*
+  Operators and propositions refer to each other by ID. Their
+  preconditions, effects and precondition_of lists are stored in flat
+  pools, and the explorations access these together with the per-state
+  fields, so the ranges are kept next to them. Data that the explorations
+  don't need (original operator IDs, effect_of lists) lives elsewhere.
+*/
+struct RelaxedOperator {
     int cost;
     int unsatisfied_preconditions;
     int h_max_supporter_cost; // h_max_cost of h_max_supporter
-    RelaxedProposition *h_max_supporter;
-    RelaxedOperator(std::vector<RelaxedProposition *> &&pre,
-                    std::vector<RelaxedProposition *> &&eff,
-                    int op_id, int base)
-        : original_op_id(op_id), preconditions(pre), effects(eff), base_cost(base) {
-    }
-
-    inline void update_h_max_supporter();
+    PropID h_max_supporter;
+    IDRange preconditions;
+    IDRange effects;
 };
 
-struct RelaxedProposition {
-    std::vector<RelaxedOperator *> precondition_of;
-    std::vector<RelaxedOperator *> effect_of;
+static_assert(sizeof(RelaxedOperator) == 32, "RelaxedOperator has wrong size");
 
+struct RelaxedProposition {
     PropositionStatus status;
     int h_max_cost;
+    IDRange precondition_of;
 };
 
+static_assert(sizeof(RelaxedProposition) == 16, "RelaxedProposition has wrong size");
+
 class LandmarkCutLandmarks {
     std::vector<RelaxedOperator> relaxed_operators;
-    std::vector<std::vector<RelaxedProposition>> propositions;
-    RelaxedProposition artificial_precondition;
-    RelaxedProposition artificial_goal;
+    /* Operators with their original costs (0 for the artificial goal
+       operator) and all preconditions unsatisfied. Copied to
+       relaxed_operators at the start of each computation, which then
+       reduces the costs of the operators in each cut. */
+    std::vector<RelaxedOperator> initial_relaxed_operators;
+    /* Propositions of all facts, followed by the artificial precondition
+       and the artificial goal. */
+    std::vector<RelaxedProposition> propositions;
+
+    std::vector<PropID> precondition_pool;
+    std::vector<PropID> effect_pool;
+    std::vector<OpID> precondition_of_pool;
+    std::vector<int> original_op_ids;
+    std::vector<std::vector<OpID>> effect_of;
+
+    // proposition_offsets[var_id]: first PropID related to variable var_id
+    std::vector<PropID> proposition_offsets;
+    PropID artificial_precondition;
+    PropID artificial_goal;
     int num_propositions;
-    priority_queues::AdaptiveQueue<RelaxedProposition *> priority_queue;
+    priority_queues::AdaptiveQueue<PropID> priority_queue;
+    // Propositions marked as GOAL_ZONE or BEFORE_GOAL_ZONE in this round.
+    std::vector<PropID> zone_propositions;
 
     void build_relaxed_operator(const OperatorProxy &op);
-    void add_relaxed_operator(std::vector<RelaxedProposition *> &&precondition,
-                              std::vector<RelaxedProposition *> &&effects,
+    void add_relaxed_operator(const std::vector<PropID> &precondition,
+                              const std::vector<PropID> &effects,
                               int op_id, int base_cost);
-    RelaxedProposition *get_proposition(const FactProxy &fact);
+    PropID get_prop_id(const FactProxy &fact) const;
+
+    IDSlice get_preconditions(const RelaxedOperator &op) const {
+        return IDSlice(precondition_pool, op.preconditions);
+    }
+
+    IDSlice get_effects(const RelaxedOperator &op) const {
+        return IDSlice(effect_pool, op.effects);
+    }
+
+    IDSlice get_precondition_of(const RelaxedProposition &prop) const {
+        return IDSlice(precondition_of_pool, prop.precondition_of);
+    }
+
     void setup_exploration_queue();
     void setup_exploration_queue_state(const State &state);
     void first_exploration(const State &state);
-    void first_exploration_incremental(std::vector<RelaxedOperator *> &cut);
+    void first_exploration_incremental(std::vector<OpID> &cut);
     void second_exploration(const State &state,
-                            std::vector<RelaxedProposition *> &second_exploration_queue,
-                            std::vector<RelaxedOperator *> &cut);
+                            std::vector<PropID> &second_exploration_queue,
+                            std::vector<OpID> &cut);
 
-    void enqueue_if_necessary(RelaxedProposition *prop, int cost) {
+    void enqueue_if_necessary(PropID prop_id, int cost) {
         assert(cost >= 0);
-        if (prop->status == UNREACHED || prop->h_max_cost > cost) {
-            prop->status = REACHED;
-            prop->h_max_cost = cost;
-            priority_queue.push(cost, prop);
+        RelaxedProposition &prop = propositions[prop_id];
+        if (prop.status == UNREACHED || prop.h_max_cost > cost) {
+            prop.status = REACHED;
+            prop.h_max_cost = cost;
+            priority_queue.push(cost, prop_id);
         }
     }
 
-    void mark_goal_plateau(RelaxedProposition *subgoal);
+    void enqueue_effects(const RelaxedOperator &op, int cost) {
+        for (PropID effect : get_effects(op))
+            enqueue_if_necessary(effect, cost);
+    }
+
+    inline void update_h_max_supporter(RelaxedOperator &op);
+    void mark_goal_plateau(PropID subgoal);
     void validate_h_max() const;
 public:
     using Landmark = std::vector<int>;
@@ -105,12 +171,17 @@ public:
                            LandmarkCallback landmark_callback);
 };
 
-inline void RelaxedOperator::update_h_max_supporter() {
-    assert(!unsatisfied_preconditions);
-    for (size_t i = 0; i < preconditions.size(); ++i)
-        if (preconditions[i]->h_max_cost > h_max_supporter->h_max_cost)
-            h_max_supporter = preconditions[i];
-    h_max_supporter_cost = h_max_supporter->h_max_cost;
+inline void LandmarkCutLandmarks::update_h_max_supporter(RelaxedOperator &op) {
+    assert(!op.unsatisfied_preconditions);
+    int h_max_supporter_cost = propositions[op.h_max_supporter].h_max_cost;
+    for (PropID pre : get_preconditions(op)) {
+        int pre_cost = propositions[pre].h_max_cost;
+        if (pre_cost > h_max_supporter_cost) {
+            op.h_max_supporter = pre;
+            h_max_supporter_cost = pre_cost;
+        }
+    }
+    op.h_max_supporter_cost = h_max_supporter_cost;
 }
 }
 
@@ -31,10 +31,11 @@ namespace landmarks {
 */
 
 // Construction and destruction
-Exploration::Exploration(const TaskProxy &task_proxy)
+Exploration::Exploration(const TaskProxy &task_proxy, ostream &log)
     : task_proxy(task_proxy),
+      log(log),
       did_write_overflow_warning(false) {
-    cout << "Initializing Exploration..." << endl;
+    log << "Initializing Exploration..." << endl;
 
     // Build propositions.
     for (VariableProxy var : task_proxy.get_variables()) {
@@ -84,7 +85,7 @@ void Exploration::write_overflow_warning() {
     if (!did_write_overflow_warning) {
         // TODO: Should have a planner-wide warning mechanism to handle
         // things like this.
-        cout << "WARNING: overflow on landmark exploration h^add! Costs clamped to "
+        log << "WARNING: overflow on landmark exploration h^add! Costs clamped to "
              << MAX_COST_VALUE << endl;
         did_write_overflow_warning = true;
     }
@@ -7,6 +7,7 @@
 
 #include "../algorithms/priority_queues.h"
 
+#include <ostream>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -85,6 +86,7 @@ class Exploration {
     static const int MAX_COST_VALUE = 100000000; // See additive_heuristic.h.
 
     TaskProxy task_proxy;
+    std::ostream &log;
 
     std::vector<ExUnaryOperator> unary_operators;
     std::vector<std::vector<ExProposition>> propositions;
@@ -104,7 +106,7 @@ class Exploration {
     void increase_cost(int &cost, int amount);
     void write_overflow_warning();
 public:
-    explicit Exploration(const TaskProxy &task_proxy);
+    Exploration(const TaskProxy &task_proxy, std::ostream &log);
 
     void compute_reachability_with_excludes(std::vector<std::vector<int>> &lvl_var,
                                             std::vector<utils::HashMap<FactPair, int>> &lvl_op,
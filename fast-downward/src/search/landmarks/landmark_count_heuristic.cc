@@ -108,14 +108,13 @@ int LandmarkCountHeuristic::get_heuristic_value(const GlobalState &global_state)
     int h = -1;
 
     if (admissible) {
+        lm_status_manager->set_landmark_statuses(global_state);
         double h_val = lm_cost_assignment->cost_sharing_h_value();
         h = static_cast<int>(ceil(h_val - epsilon));
     } else {
-        lgraph->count_costs();
-
         int total_cost = lgraph->cost_of_landmarks();
-        int reached_cost = lgraph->get_reached_cost();
-        int needed_cost = lgraph->get_needed_cost();
+        int reached_cost = lm_status_manager->get_reached_cost();
+        int needed_cost = lm_status_manager->get_needed_cost();
 
         h = total_cost - reached_cost + needed_cost;
     }
@@ -133,26 +132,15 @@ int LandmarkCountHeuristic::compute_heuristic(const GlobalState &global_state) {
     int h = get_heuristic_value(global_state);
 
     if (use_preferred_operators) {
-        BitsetView landmark_info = lm_status_manager->get_reached_landmarks(global_state);
-        LandmarkSet reached_lms = convert_to_landmark_set(landmark_info);
+        BitsetView reached_lms = lm_status_manager->get_reached_landmarks(global_state);
         generate_helpful_actions(state, reached_lms);
     }
 
     return h;
 }
 
-bool LandmarkCountHeuristic::check_node_orders_disobeyed(const LandmarkNode &node,
-                                                         const LandmarkSet &reached) const {
-    for (const auto &parent : node.parents) {
-        if (reached.count(parent.first) == 0) {
-            return true;
-        }
-    }
-    return false;
-}
-
 bool LandmarkCountHeuristic::generate_helpful_actions(const State &state,
-                                                      const LandmarkSet &reached) {
+                                                      const BitsetView &reached) {
     /* Find actions that achieve new landmark leaves. If no such action exist,
      return false. If a simple landmark can be achieved, return only operators
      that achieve simple landmarks, else return operators that achieve
@@ -163,6 +151,11 @@ bool LandmarkCountHeuristic::generate_helpful_actions(const State &state,
     vector<OperatorID> ha_simple;
     vector<OperatorID> ha_disj;
 
+    int num_reached = 0;
+    for (int i = 0; i < reached.num_blocks(); ++i)
+        num_reached += BitsetMath::popcount(reached.get_block(i));
+    bool all_reached = (num_reached == lgraph->number_of_landmarks());
+
     for (OperatorID op_id : applicable_operators) {
         OperatorProxy op = task_proxy.get_operators()[op_id];
         EffectsProxy effects = op.get_effects();
@@ -171,7 +164,8 @@ bool LandmarkCountHeuristic::generate_helpful_actions(const State &state,
                 continue;
             FactProxy fact_proxy = effect.get_fact();
             LandmarkNode *lm_p = lgraph->get_landmark(fact_proxy.get_pair());
-            if (lm_p != 0 && landmark_is_interesting(state, reached, *lm_p)) {
+            if (lm_p != 0 &&
+                landmark_is_interesting(state, reached, all_reached, *lm_p)) {
                 if (lm_p->disjunctive) {
                     ha_disj.push_back(op_id);
                 } else {
@@ -197,17 +191,17 @@ bool LandmarkCountHeuristic::generate_helpful_actions(const State &state,
 }
 
 bool LandmarkCountHeuristic::landmark_is_interesting(
-    const State &state, const LandmarkSet &reached, LandmarkNode &lm) const {
+    const State &state, const BitsetView &reached, bool all_reached,
+    LandmarkNode &lm) const {
     /* A landmark is interesting if it hasn't been reached before and
      its parents have all been reached, or if all landmarks have been
      reached before, the LM is a goal, and it's not true at moment */
 
-    int num_reached = reached.size();
-    if (num_reached != lgraph->number_of_landmarks()) {
-        if (reached.find(&lm) != reached.end())
+    if (!all_reached) {
+        if (reached.test(lm.get_id()))
             return false;
         else
-            return !check_node_orders_disobeyed(lm, reached);
+            return lm_status_manager->landmark_is_leaf(lm.get_id(), reached);
     }
     return lm.is_goal() && !lm.is_true_in_state(state);
 }
@@ -231,19 +225,6 @@ bool LandmarkCountHeuristic::dead_ends_are_reliable() const {
     return dead_ends_reliable;
 }
 
-// This function exists purely so we don't have to change all the
-// functions in this class that use LandmarkSets for the reached LMs
-// (HACK).
-LandmarkSet LandmarkCountHeuristic::convert_to_landmark_set(
-    const BitsetView &landmark_bitset) {
-    LandmarkSet landmark_set;
-    for (int i = 0; i < landmark_bitset.size(); ++i)
-        if (landmark_bitset.test(i))
-            landmark_set.insert(lgraph->get_lm_for_index(i));
-    return landmark_set;
-}
-
-
 static shared_ptr<Heuristic> _parse(OptionParser &parser) {
     parser.document_synopsis(
         "Landmark-count heuristic",
@@ -28,17 +28,11 @@ class LandmarkCountHeuristic : public Heuristic {
 
     int get_heuristic_value(const GlobalState &global_state);
 
-    bool check_node_orders_disobeyed(
-        const LandmarkNode &node, const LandmarkSet &reached) const;
-
-    void add_node_children(LandmarkNode &node, const LandmarkSet &reached) const;
-
     bool landmark_is_interesting(
-        const State &state, const LandmarkSet &reached, LandmarkNode &lm) const;
+        const State &state, const BitsetView &reached, bool all_reached,
+        LandmarkNode &lm) const;
     bool generate_helpful_actions(
-        const State &state, const LandmarkSet &reached);
-
-    LandmarkSet convert_to_landmark_set(const BitsetView &landmark_bitset);
+        const State &state, const BitsetView &reached);
 protected:
     virtual int compute_heuristic(const GlobalState &global_state) override;
 public:
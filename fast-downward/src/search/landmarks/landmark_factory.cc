@@ -12,8 +12,10 @@
 #include "../utils/memory.h"
 #include "../utils/timer.h"
 
+#include <atomic>
 #include <fstream>
 #include <limits>
+#include <thread>
 
 using namespace std;
 
@@ -24,8 +26,14 @@ LandmarkFactory::LandmarkFactory(const options::Options &opts)
       only_causal_landmarks(opts.get<bool>("only_causal_landmarks")),
       disjunctive_landmarks(opts.get<bool>("disjunctive_landmarks")),
       conjunctive_landmarks(opts.get<bool>("conjunctive_landmarks")),
-      no_orders(opts.get<bool>("no_orders")) {
+      no_orders(opts.get<bool>("no_orders")),
+      num_threads(opts.get<int>("threads")),
+      current_log(&cout) {
 }
+
+LandmarkFactory::~LandmarkFactory() {
+}
+
 /*
   Note: To allow reusing landmark graphs, we use the following temporary
   solution.
@@ -46,7 +54,9 @@ LandmarkFactory::LandmarkFactory(const options::Options &opts)
   as the TaskProxy object passed to this function.
 */
 shared_ptr<LandmarkGraph> LandmarkFactory::compute_lm_graph(
-    const shared_ptr<AbstractTask> &task) {
+    const shared_ptr<AbstractTask> &task, ostream &log_stream) {
+    // lm_merged may ask for the graph of a shared factory on two threads.
+    lock_guard<mutex> lock(compute_mutex);
     if (lm_graph) {
         if (lm_graph_task != task.get()) {
             cerr << "LandmarkFactory was asked to compute landmark graphs for "
@@ -57,27 +67,31 @@ shared_ptr<LandmarkGraph> LandmarkFactory::compute_lm_graph(
         return lm_graph;
     }
     lm_graph_task = task.get();
+    current_log = &log_stream;
     utils::Timer lm_generation_timer;
 
     TaskProxy task_proxy(*task);
 
     lm_graph = make_shared<LandmarkGraph>(task_proxy);
-    Exploration exploration(task_proxy);
+    Exploration exploration(task_proxy, log());
     generate_landmarks(task, exploration);
 
     // the following replaces the old "build_lm_graph"
     generate(task_proxy, exploration);
-    cout << "Landmarks generation time: " << lm_generation_timer << endl;
+    worker_explorations.clear();
+    worker_logs.clear();
+    log() << "Landmarks generation time: " << lm_generation_timer << endl;
     if (lm_graph->number_of_landmarks() == 0)
-        cout << "Warning! No landmarks found. Task unsolvable?" << endl;
+        log() << "Warning! No landmarks found. Task unsolvable?" << endl;
     else {
-        cout << "Discovered " << lm_graph->number_of_landmarks()
+        log() << "Discovered " << lm_graph->number_of_landmarks()
              << " landmarks, of which " << lm_graph->number_of_disj_landmarks()
              << " are disjunctive and "
              << lm_graph->number_of_conj_landmarks() << " are conjunctive \n"
              << lm_graph->number_of_edges() << " edges\n";
     }
     //lm_graph->dump();
+    current_log = &cout;
     return lm_graph;
 }
 
@@ -93,9 +107,9 @@ void LandmarkFactory::generate(const TaskProxy &task_proxy, Exploration &explora
     if (no_orders)
         discard_all_orderings();
     else if (reasonable_orders) {
-        cout << "approx. reasonable orders" << endl;
+        log() << "approx. reasonable orders" << endl;
         approximate_reasonable_orders(task_proxy, false);
-        cout << "approx. obedient reasonable orders" << endl;
+        log() << "approx. obedient reasonable orders" << endl;
         approximate_reasonable_orders(task_proxy, true);
     }
     mk_acyclic_graph();
@@ -605,14 +619,62 @@ void LandmarkFactory::edge_add(LandmarkNode &from, LandmarkNode &to,
     assert(to.parents.find(&from) != to.parents.end());
 }
 
+void LandmarkFactory::run_in_parallel(
+    const TaskProxy &task_proxy, Exploration &exploration, int num_items,
+    const function<void(int, Exploration &)> &process) {
+    int num_workers = min(num_threads, num_items);
+    if (num_workers <= 1) {
+        for (int i = 0; i < num_items; ++i)
+            process(i, exploration);
+        return;
+    }
+    while (static_cast<int>(worker_explorations.size()) < num_workers - 1) {
+        worker_logs.push_back(utils::make_unique_ptr<ostringstream>());
+        worker_explorations.push_back(
+            utils::make_unique_ptr<Exploration>(task_proxy, *worker_logs.back()));
+    }
+
+    atomic<int> next_item(0);
+    auto process_next_items = [&](Exploration &worker_exploration) {
+            for (int i = next_item++; i < num_items; i = next_item++)
+                process(i, worker_exploration);
+        };
+    vector<thread> workers;
+    for (int i = 0; i < num_workers - 1; ++i) {
+        workers.emplace_back(
+            process_next_items, ref(*worker_explorations[i]));
+    }
+    process_next_items(exploration);
+    for (thread &worker : workers) {
+        worker.join();
+    }
+    for (const unique_ptr<ostringstream> &worker_log : worker_logs) {
+        log() << worker_log->str();
+        worker_log->str("");
+    }
+}
+
 void LandmarkFactory::discard_noncausal_landmarks(const TaskProxy &task_proxy, Exploration &exploration) {
     int num_all_landmarks = lm_graph->number_of_landmarks();
+    const LandmarkGraph::Nodes &nodes = lm_graph->get_nodes();
+    unordered_set<const LandmarkNode *> noncausal_landmarks;
+    vector<bool> is_causal(nodes.size());
+    run_in_parallel(
+        task_proxy, exploration, nodes.size(),
+        [&](int i, Exploration &worker_exploration) {
+            is_causal[i] = is_causal_landmark(
+                task_proxy, worker_exploration, *nodes[i]);
+        });
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        if (!is_causal[i])
+            noncausal_landmarks.insert(nodes[i].get());
+    }
     lm_graph->remove_node_if(
-        [this, &task_proxy, &exploration](const LandmarkNode &node) {
-            return !is_causal_landmark(task_proxy, exploration, node);
+        [&noncausal_landmarks](const LandmarkNode &node) {
+            return noncausal_landmarks.count(&node);
         });
     int num_causal_landmarks = lm_graph->number_of_landmarks();
-    cout << "Discarded " << num_all_landmarks - num_causal_landmarks
+    log() << "Discarded " << num_all_landmarks - num_causal_landmarks
          << " non-causal landmarks" << endl;
 }
 
@@ -623,7 +685,7 @@ void LandmarkFactory::discard_disjunctive_landmarks() {
       allow removing disjunctive landmarks after landmark generation.
     */
     if (lm_graph->number_of_disj_landmarks() > 0) {
-        cout << "Discarding " << lm_graph->number_of_disj_landmarks()
+        log() << "Discarding " << lm_graph->number_of_disj_landmarks()
              << " disjunctive landmarks" << endl;
         lm_graph->remove_node_if(
             [](const LandmarkNode &node) {return node.disjunctive;});
@@ -632,7 +694,7 @@ void LandmarkFactory::discard_disjunctive_landmarks() {
 
 void LandmarkFactory::discard_conjunctive_landmarks() {
     if (lm_graph->number_of_conj_landmarks() > 0) {
-        cout << "Discarding " << lm_graph->number_of_conj_landmarks()
+        log() << "Discarding " << lm_graph->number_of_conj_landmarks()
              << " conjunctive landmarks" << endl;
         lm_graph->remove_node_if(
             [](const LandmarkNode &node) {return node.conjunctive;});
@@ -640,7 +702,7 @@ void LandmarkFactory::discard_conjunctive_landmarks() {
 }
 
 void LandmarkFactory::discard_all_orderings() {
-    cout << "Removing all orderings." << endl;
+    log() << "Removing all orderings." << endl;
     for (auto &node : lm_graph->get_nodes()) {
         node->children.clear();
         node->parents.clear();
@@ -657,7 +719,7 @@ void LandmarkFactory::mk_acyclic_graph() {
     // [Malte] Commented out the following assertion because
     // the old method for this is no longer available.
     // assert(acyclic_node_set.size() == number_of_landmarks());
-    cout << "Removed " << removed_edges
+    log() << "Removed " << removed_edges
          << " reasonable or obedient reasonable orders\n";
 }
 
@@ -771,27 +833,32 @@ void LandmarkFactory::compute_predecessor_information(
 
 void LandmarkFactory::calc_achievers(const TaskProxy &task_proxy, Exploration &exploration) {
     VariablesProxy variables = task_proxy.get_variables();
-    for (auto &lmn : lm_graph->get_nodes()) {
-        for (const FactPair &lm_fact : lmn->facts) {
-            const vector<int> &ops = lm_graph->get_operators_including_eff(lm_fact);
-            lmn->possible_achievers.insert(ops.begin(), ops.end());
-
-            if (variables[lm_fact.var].is_derived())
-                lmn->is_derived = true;
-        }
+    const LandmarkGraph::Nodes &nodes = lm_graph->get_nodes();
+    run_in_parallel(
+        task_proxy, exploration, nodes.size(),
+        [&](int i, Exploration &worker_exploration) {
+            LandmarkNode *lmn = nodes[i].get();
+            for (const FactPair &lm_fact : lmn->facts) {
+                const vector<int> &ops = lm_graph->get_operators_including_eff(lm_fact);
+                lmn->possible_achievers.insert(ops.begin(), ops.end());
+
+                if (variables[lm_fact.var].is_derived())
+                    lmn->is_derived = true;
+            }
 
-        vector<vector<int>> lvl_var;
-        vector<utils::HashMap<FactPair, int>> lvl_op;
-        compute_predecessor_information(task_proxy, exploration, lmn.get(), lvl_var, lvl_op);
+            vector<vector<int>> lvl_var;
+            vector<utils::HashMap<FactPair, int>> lvl_op;
+            compute_predecessor_information(
+                task_proxy, worker_exploration, lmn, lvl_var, lvl_op);
 
-        for (int op_or_axom_id : lmn->possible_achievers) {
-            OperatorProxy op = get_operator_or_axiom(task_proxy, op_or_axom_id);
+            for (int op_or_axom_id : lmn->possible_achievers) {
+                OperatorProxy op = get_operator_or_axiom(task_proxy, op_or_axom_id);
 
-            if (_possibly_reaches_lm(op, lvl_var, lmn.get())) {
-                lmn->first_achievers.insert(op_or_axom_id);
+                if (_possibly_reaches_lm(op, lvl_var, lmn)) {
+                    lmn->first_achievers.insert(op_or_axom_id);
+                }
             }
-        }
-    }
+        });
 }
 
 void _add_options_to_parser(OptionParser &parser) {
@@ -810,6 +877,15 @@ void _add_options_to_parser(OptionParser &parser) {
     parser.add_option<bool>("no_orders",
                             "discard all orderings",
                             "false");
+    parser.add_option<int>(
+        "threads",
+        "number of threads for landmark generation. They are used for the "
+        "relaxed explorations of independent landmarks and, in lm_merged, "
+        "for computing the landmark graphs of the merged factories "
+        "concurrently. The resulting landmark graph does not depend on this "
+        "option.",
+        "1",
+        Bounds("1", "infinity"));
 }
 
 
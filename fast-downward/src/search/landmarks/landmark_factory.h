@@ -3,10 +3,14 @@
 
 #include "landmark_graph.h"
 
+#include <functional>
+#include <iostream>
 #include <list>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <set>
+#include <sstream>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -27,11 +31,18 @@ enum class EdgeType;
 class LandmarkFactory {
 public:
     explicit LandmarkFactory(const options::Options &opts);
-    virtual ~LandmarkFactory() = default;
+    virtual ~LandmarkFactory();
 
     LandmarkFactory(const LandmarkFactory &) = delete;
 
-    std::shared_ptr<LandmarkGraph> compute_lm_graph(const std::shared_ptr<AbstractTask> &task);
+    /*
+      Compute the landmark graph and write all output of the computation
+      to the given stream. Several threads may call this function at the
+      same time, but only the first call computes the graph.
+    */
+    std::shared_ptr<LandmarkGraph> compute_lm_graph(
+        const std::shared_ptr<AbstractTask> &task,
+        std::ostream &log_stream = std::cout);
 
     bool use_disjunctive_landmarks() const {return disjunctive_landmarks;}
     bool use_reasonable_orders() const {return reasonable_orders;}
@@ -42,6 +53,19 @@ protected:
     AbstractTask *lm_graph_task;
 
     bool use_orders() const {return !no_orders;}   // only needed by HMLandmark
+    int get_num_threads() const {return num_threads;}
+    // Stream for the output of the current landmark graph computation.
+    std::ostream &log() const {return *current_log;}
+
+    /*
+      Call process(i, exploration) for all 0 <= i < num_items on up to
+      num_threads threads. Each thread uses its own Exploration object,
+      so process(i, ...) may only modify data belonging to item i.
+    */
+    void run_in_parallel(const TaskProxy &task_proxy,
+                         Exploration &exploration,
+                         int num_items,
+                         const std::function<void(int, Exploration &)> &process);
 
     virtual void generate_landmarks(const std::shared_ptr<AbstractTask> &task, Exploration &exploration) = 0;
     void generate(const TaskProxy &task_proxy, Exploration &exploration);
@@ -74,6 +98,17 @@ private:
     const bool disjunctive_landmarks;
     const bool conjunctive_landmarks;
     const bool no_orders;
+    const int num_threads;
+
+    std::mutex compute_mutex;
+    std::ostream *current_log;
+
+    /*
+      Explorations for threads other than the main thread. Their output
+      is buffered and appended to log() after each parallel run.
+    */
+    std::vector<std::unique_ptr<Exploration>> worker_explorations;
+    std::vector<std::unique_ptr<std::ostringstream>> worker_logs;
 
     bool interferes(const TaskProxy &task_proxy,
                     const LandmarkNode *node_a,
@@ -293,7 +293,7 @@ void LandmarkFactoryHM::get_m_sets(const VariablesProxy &variables, int m,
 void LandmarkFactoryHM::print_proposition(const VariablesProxy &variables, const FactPair &fluent) const {
     VariableProxy var = variables[fluent.var];
     FactProxy fact = var.get_fact(fluent.value);
-    cout << fact.get_name()
+    log() << fact.get_name()
          << " (" << var.get_name() << "(" << fact.get_variable().get_id() << ")"
          << "->" << fact.get_value() << ")";
 }
@@ -346,70 +346,70 @@ void LandmarkFactoryHM::print_pm_op(const VariablesProxy &variables, const PMOp
         cond_eff.clear();
         int pm_fluent;
         size_t j;
-        cout << "PC:" << endl;
+        log() << "PC:" << endl;
         for (j = 0; (pm_fluent = op.cond_noops[i][j]) != -1; ++j) {
             print_fluentset(variables, h_m_table_[pm_fluent].fluents);
-            cout << endl;
+            log() << endl;
 
             for (size_t k = 0; k < h_m_table_[pm_fluent].fluents.size(); ++k) {
                 cond_pc.insert(h_m_table_[pm_fluent].fluents[k]);
             }
         }
         // advance to effects section
-        cout << endl;
+        log() << endl;
         ++j;
 
-        cout << "EFF:" << endl;
+        log() << "EFF:" << endl;
         for (; j < op.cond_noops[i].size(); ++j) {
             int pm_fluent = op.cond_noops[i][j];
 
             print_fluentset(variables, h_m_table_[pm_fluent].fluents);
-            cout << endl;
+            log() << endl;
 
             for (size_t k = 0; k < h_m_table_[pm_fluent].fluents.size(); ++k) {
                 cond_eff.insert(h_m_table_[pm_fluent].fluents[k]);
             }
         }
         conds.emplace_back(cond_pc, cond_eff);
-        cout << endl << endl << endl;
+        log() << endl << endl << endl;
     }
 
-    cout << "Action " << op.index << endl;
-    cout << "Precondition: ";
+    log() << "Action " << op.index << endl;
+    log() << "Precondition: ";
     for (const FactPair &pc : pcs) {
         print_proposition(variables, pc);
-        cout << " ";
+        log() << " ";
     }
 
-    cout << endl << "Effect: ";
+    log() << endl << "Effect: ";
     for (const FactPair &eff : effs) {
         print_proposition(variables, eff);
-        cout << " ";
+        log() << " ";
     }
-    cout << endl << "Conditionals: " << endl;
+    log() << endl << "Conditionals: " << endl;
     int i = 0;
     for (const auto &cond : conds) {
-        cout << "Cond PC #" << i++ << ":" << endl << "\t";
+        log() << "Cond PC #" << i++ << ":" << endl << "\t";
         for (const FactPair &pc : cond.first) {
             print_proposition(variables, pc);
-            cout << " ";
+            log() << " ";
         }
-        cout << endl << "Cond Effect #" << i << ":" << endl << "\t";
+        log() << endl << "Cond Effect #" << i << ":" << endl << "\t";
         for (const FactPair &eff : cond.second) {
             print_proposition(variables, eff);
-            cout << " ";
+            log() << " ";
         }
-        cout << endl << endl;
+        log() << endl << endl;
     }
 }
 
 void LandmarkFactoryHM::print_fluentset(const VariablesProxy &variables, const FluentSet &fs) {
-    cout << "( ";
+    log() << "( ";
     for (const FactPair &fact : fs) {
         print_proposition(variables, fact);
-        cout << " ";
+        log() << " ";
     }
-    cout << ")";
+    log() << ")";
 }
 
 // check whether fs2 is a possible noop set for action with fs1 as effect
@@ -447,7 +447,7 @@ void LandmarkFactoryHM::build_pm_ops(const TaskProxy &task_proxy) {
     FluentSet pc, eff;
     vector<FluentSet> pc_subsets, eff_subsets, noop_pc_subsets, noop_eff_subsets;
 
-    static int op_count = 0;
+    int op_count = 0;
     int set_index, noop_index;
 
     OperatorsProxy operators = task_proxy.get_operators();
@@ -565,7 +565,7 @@ LandmarkFactoryHM::LandmarkFactoryHM(const options::Options &opts)
 }
 
 void LandmarkFactoryHM::initialize(const TaskProxy &task_proxy) {
-    cout << "h^m landmarks m=" << m_ << endl;
+    log() << "h^m landmarks m=" << m_ << endl;
     if (!task_proxy.get_axioms().empty()) {
         cerr << "h^m landmarks don't support axioms" << endl;
         utils::exit_with(ExitCode::SEARCH_UNSUPPORTED);
@@ -580,13 +580,13 @@ void LandmarkFactoryHM::initialize(const TaskProxy &task_proxy) {
         set_indices_[msets[i]] = i;
         h_m_table_[i].fluents = msets[i];
     }
-    cout << "Using " << h_m_table_.size() << " P^m fluents." << endl;
+    log() << "Using " << h_m_table_.size() << " P^m fluents." << endl;
 
     build_pm_ops(task_proxy);
 }
 
 void LandmarkFactoryHM::calc_achievers(const TaskProxy &task_proxy, Exploration &) {
-    cout << "Calculating achievers." << endl;
+    log() << "Calculating achievers." << endl;
 
     OperatorsProxy operators = task_proxy.get_operators();
     VariablesProxy variables = task_proxy.get_variables();
@@ -803,10 +803,10 @@ void LandmarkFactoryHM::compute_h_m_landmarks(const TaskProxy &task_proxy) {
         current_trigger.swap(next_trigger);
         next_trigger.clear();
 
-        cout << "Level " << level << " completed." << endl;
+        log() << "Level " << level << " completed." << endl;
         ++level;
     }
-    cout << "h^m landmarks computed." << endl;
+    log() << "h^m landmarks computed." << endl;
 }
 
 void LandmarkFactoryHM::compute_noop_landmarks(
@@ -914,10 +914,10 @@ void LandmarkFactoryHM::generate_landmarks(
         int set_index = set_indices_[goal_subset];
 
         if (h_m_table_[set_index].level == -1) {
-            cout << endl << endl << "Subset of goal not reachable !!." << endl << endl << endl;
-            cout << "Subset is: ";
+            log() << endl << endl << "Subset of goal not reachable !!." << endl << endl << endl;
+            log() << "Subset is: ";
             print_fluentset(variables, h_m_table_[set_index].fluents);
-            cout << endl;
+            log() << endl;
         }
 
         // set up goals landmarks for processing
@@ -5,9 +5,15 @@
 #include "../option_parser.h"
 #include "../plugin.h"
 
+#include "../task_proxy.h"
+
 #include "../utils/system.h"
 
+#include <algorithm>
+#include <atomic>
 #include <set>
+#include <sstream>
+#include <thread>
 
 using namespace std;
 using utils::ExitCode;
@@ -40,15 +46,85 @@ LandmarkNode *LandmarkFactoryMerged::get_matching_landmark(const LandmarkNode &l
     return 0;
 }
 
+/*
+  Compute the landmark graphs of the given factories on num_workers
+  threads. Each factory writes its output to its own buffer, and the
+  buffers are printed in the order of the factories afterwards.
+*/
+void LandmarkFactoryMerged::compute_lm_graphs_in_parallel(
+    const shared_ptr<AbstractTask> &task,
+    const vector<int> &factory_ids, int num_workers) {
+    log() << "Computing " << factory_ids.size() << " landmark graphs with "
+          << num_workers << " threads" << endl;
+    /*
+      The causal graph is computed lazily and cached per task without
+      synchronization, so we compute it before starting the threads.
+    */
+    TaskProxy(*task).get_causal_graph();
+
+    int num_graphs = factory_ids.size();
+    vector<ostringstream> factory_logs(num_graphs);
+    atomic<int> next_graph(0);
+    auto compute_next_lm_graphs = [&]() {
+            for (int i = next_graph++; i < num_graphs; i = next_graph++) {
+                int factory_id = factory_ids[i];
+                lm_graphs[factory_id] = lm_factories[factory_id]->compute_lm_graph(
+                    task, factory_logs[i]);
+            }
+        };
+    vector<thread> workers;
+    for (int i = 0; i < num_workers - 1; ++i) {
+        workers.emplace_back(compute_next_lm_graphs);
+    }
+    compute_next_lm_graphs();
+    for (thread &worker : workers) {
+        worker.join();
+    }
+    for (const ostringstream &factory_log : factory_logs) {
+        log() << factory_log.str();
+    }
+}
+
 void LandmarkFactoryMerged::generate_landmarks(
     const shared_ptr<AbstractTask> &task, Exploration &) {
-    cout << "Merging " << lm_factories.size() << " landmark graphs" << endl;
+    log() << "Merging " << lm_factories.size() << " landmark graphs" << endl;
+
+    int num_factories = lm_factories.size();
+    lm_graphs.resize(num_factories);
+    /*
+      Landmark factories can be listed more than once (e.g., via
+      predefinitions). Since they cache their landmark graph, we compute
+      it only once per factory and let the other entries share it.
+    */
+    vector<int> first_occurrence(num_factories);
+    vector<int> distinct_factories;
+    for (int i = 0; i < num_factories; ++i) {
+        first_occurrence[i] = i;
+        for (int j = 0; j < i; ++j) {
+            if (lm_factories[j] == lm_factories[i]) {
+                first_occurrence[i] = j;
+                break;
+            }
+        }
+        if (first_occurrence[i] == i)
+            distinct_factories.push_back(i);
+    }
 
-    for (const shared_ptr<LandmarkFactory> &lm_factory : lm_factories) {
-        lm_graphs.push_back(lm_factory->compute_lm_graph(task));
+    int num_workers = min(get_num_threads(),
+                          static_cast<int>(distinct_factories.size()));
+    if (num_workers > 1) {
+        compute_lm_graphs_in_parallel(task, distinct_factories, num_workers);
+    } else {
+        for (int factory_id : distinct_factories) {
+            lm_graphs[factory_id] =
+                lm_factories[factory_id]->compute_lm_graph(task, log());
+        }
+    }
+    for (int i = 0; i < num_factories; ++i) {
+        lm_graphs[i] = lm_graphs[first_occurrence[i]];
     }
 
-    cout << "Adding simple landmarks" << endl;
+    log() << "Adding simple landmarks" << endl;
     for (size_t i = 0; i < lm_graphs.size(); ++i) {
         const LandmarkGraph::Nodes &nodes = lm_graphs[i]->get_nodes();
         for (auto &lm : nodes) {
@@ -61,7 +137,7 @@ void LandmarkFactoryMerged::generate_landmarks(
         }
     }
 
-    cout << "Adding disjunctive landmarks" << endl;
+    log() << "Adding disjunctive landmarks" << endl;
     for (size_t i = 0; i < lm_graphs.size(); ++i) {
         const LandmarkGraph::Nodes &nodes = lm_graphs[i]->get_nodes();
         for (auto &lm : nodes) {
@@ -87,7 +163,7 @@ void LandmarkFactoryMerged::generate_landmarks(
         }
     }
 
-    cout << "Adding orderings" << endl;
+    log() << "Adding orderings" << endl;
     for (size_t i = 0; i < lm_graphs.size(); ++i) {
         const LandmarkGraph::Nodes &nodes = lm_graphs[i]->get_nodes();
         for (auto &from_orig : nodes) {
@@ -100,11 +176,11 @@ void LandmarkFactoryMerged::generate_landmarks(
                     if (to_node) {
                         edge_add(*from, *to_node, e_type);
                     } else {
-                        cout << "Discarded to ordering" << endl;
+                        log() << "Discarded to ordering" << endl;
                     }
                 }
             } else {
-                cout << "Discarded from ordering" << endl;
+                log() << "Discarded from ordering" << endl;
             }
         }
     }
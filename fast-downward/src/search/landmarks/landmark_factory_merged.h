@@ -13,6 +13,9 @@ class LandmarkFactoryMerged : public LandmarkFactory {
     std::vector<std::shared_ptr<LandmarkGraph>> lm_graphs;
     std::vector<std::shared_ptr<LandmarkFactory>> lm_factories;
 
+    void compute_lm_graphs_in_parallel(
+        const std::shared_ptr<AbstractTask> &task,
+        const std::vector<int> &factory_ids, int num_workers);
     virtual void generate_landmarks(const std::shared_ptr<AbstractTask> &task, Exploration &exploration) override;
     LandmarkNode *get_matching_landmark(const LandmarkNode &lm) const;
 public:
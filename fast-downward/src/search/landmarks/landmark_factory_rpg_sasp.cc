@@ -413,7 +413,7 @@ void LandmarkFactoryRpgSasp::compute_disjunctive_preconditions(
 void LandmarkFactoryRpgSasp::generate_landmarks(
     const shared_ptr<AbstractTask> &task, Exploration &exploration) {
     TaskProxy task_proxy(*task);
-    cout << "Generating landmarks using the RPG/SAS+ approach\n";
+    log() << "Generating landmarks using the RPG/SAS+ approach\n";
     build_dtg_successors(task_proxy);
     build_disjunction_classes(task_proxy);
 
@@ -425,9 +425,12 @@ void LandmarkFactoryRpgSasp::generate_landmarks(
 
     State initial_state = task_proxy.get_initial_state();
     while (!open_landmarks.empty()) {
+        if (get_num_threads() > 1 && precomputed_predecessors.empty())
+            precompute_predecessor_information(task_proxy, exploration);
         LandmarkNode *bp = open_landmarks.front();
         open_landmarks.pop_front();
         assert(bp->forward_orders.empty());
+        auto precomputed = precomputed_predecessors.find(bp);
 
         if (!bp->is_true_in_state(initial_state)) {
             // Backchain from landmark bp and compute greedy necessary predecessors.
@@ -435,8 +438,13 @@ void LandmarkFactoryRpgSasp::generate_landmarks(
             // relaxed plan that propositions are achieved (in lvl_var) and operators
             // applied (in lvl_ops).
             vector<vector<int>> lvl_var;
-            vector<utils::HashMap<FactPair, int>> lvl_op;
-            compute_predecessor_information(task_proxy, exploration, bp, lvl_var, lvl_op);
+            if (precomputed != precomputed_predecessors.end() &&
+                precomputed->second.facts == bp->facts) {
+                lvl_var = move(precomputed->second.lvl_var);
+            } else {
+                vector<utils::HashMap<FactPair, int>> lvl_op;
+                compute_predecessor_information(task_proxy, exploration, bp, lvl_var, lvl_op);
+            }
             // Use this information to determine all operators that can possibly achieve bp
             // for the first time, and collect any precondition propositions that all such
             // operators share (if there are any).
@@ -459,10 +467,43 @@ void LandmarkFactoryRpgSasp::generate_landmarks(
                     found_disj_lm_and_order(task_proxy, preconditions, *bp, EdgeType::greedy_necessary);
                 }
         }
+        if (precomputed != precomputed_predecessors.end())
+            precomputed_predecessors.erase(precomputed);
     }
     add_lm_forward_orders();
 }
 
+void LandmarkFactoryRpgSasp::precompute_predecessor_information(
+    const TaskProxy &task_proxy, Exploration &exploration) {
+    /*
+      The relaxed exploration for a landmark only depends on its facts,
+      so we can run it for the next open landmarks in parallel. The
+      landmarks are then processed sequentially in the usual order. If
+      the facts of a landmark change in the meantime, the precomputed
+      information is ignored.
+    */
+    State initial_state = task_proxy.get_initial_state();
+    int max_batch_size = 16 * get_num_threads();
+    vector<LandmarkNode *> batch;
+    auto it = open_landmarks.begin();
+    for (int i = 0; i < max_batch_size && it != open_landmarks.end(); ++i, ++it) {
+        if (!(*it)->is_true_in_state(initial_state))
+            batch.push_back(*it);
+    }
+    vector<PredecessorInformation> batch_information(batch.size());
+    run_in_parallel(
+        task_proxy, exploration, batch.size(),
+        [&](int i, Exploration &worker_exploration) {
+            vector<utils::HashMap<FactPair, int>> lvl_op;
+            batch_information[i].facts = batch[i]->facts;
+            compute_predecessor_information(
+                task_proxy, worker_exploration, batch[i],
+                batch_information[i].lvl_var, lvl_op);
+        });
+    for (size_t i = 0; i < batch.size(); ++i)
+        precomputed_predecessors[batch[i]] = move(batch_information[i]);
+}
+
 void LandmarkFactoryRpgSasp::approximate_lookahead_orders(
     const TaskProxy &task_proxy, const vector<vector<int>> &lvl_var, LandmarkNode *lmp) {
     // Find all var-val pairs that can only be reached after the landmark
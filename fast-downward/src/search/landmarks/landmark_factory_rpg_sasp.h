@@ -9,7 +9,16 @@
 
 namespace landmarks {
 class LandmarkFactoryRpgSasp : public LandmarkFactory {
+    struct PredecessorInformation {
+        // Facts of the landmark when the information was computed.
+        std::vector<FactPair> facts;
+        std::vector<std::vector<int>> lvl_var;
+    };
+
     std::list<LandmarkNode *> open_landmarks;
+    // Only used with multiple threads.
+    std::unordered_map<const LandmarkNode *, PredecessorInformation>
+    precomputed_predecessors;
     std::vector<std::vector<int>> disjunction_classes;
 
     // dtg_successors[var_id][val] contains all successor values of val in the
@@ -36,6 +45,9 @@ class LandmarkFactoryRpgSasp : public LandmarkFactory {
         std::vector<std::set<FactPair>> &disjunctive_pre,
         std::vector<std::vector<int>> &lvl_var, LandmarkNode *bp);
 
+    void precompute_predecessor_information(
+        const TaskProxy &task_proxy, Exploration &exploration);
+
     int min_cost_for_landmark(const TaskProxy &task_proxy,
                               LandmarkNode *bp,
                               std::vector<std::vector<int>> &lvl_var);
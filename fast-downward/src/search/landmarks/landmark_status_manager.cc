@@ -2,6 +2,8 @@
 
 #include "landmark_graph.h"
 
+#include <algorithm>
+
 using namespace std;
 
 namespace landmarks {
@@ -11,13 +13,146 @@ namespace landmarks {
 */
 LandmarkStatusManager::LandmarkStatusManager(LandmarkGraph &graph)
     : reached_lms(vector<bool>(graph.number_of_landmarks(), true)),
-      lm_graph(graph) {
+      lm_graph(graph),
+      num_blocks(BitsetMath::compute_num_blocks(graph.number_of_landmarks())),
+      goal_landmarks(num_blocks, BitsetMath::zeros),
+      no_first_achievers(num_blocks, BitsetMath::zeros),
+      no_possible_achievers(num_blocks, BitsetMath::zeros),
+      true_lms(num_blocks, BitsetMath::zeros),
+      needed_again_lms(num_blocks, BitsetMath::zeros),
+      reached_cost(0),
+      needed_cost(0) {
+    int num_landmarks = lm_graph.number_of_landmarks();
+    vector<vector<vector<int>>> ids_by_fact;
+    vector<vector<int>> ids_by_cost;
+    vector<int> costs;
+    parents.reserve(num_landmarks);
+    greedy_necessary_children.reserve(num_landmarks);
+    for (int id = 0; id < num_landmarks; ++id) {
+        LandmarkNode *node = lm_graph.get_lm_for_index(id);
+        int block_index = BitsetMath::block_index(id);
+        BitsetMath::Block mask = BitsetMath::bit_mask(id);
+
+        if (node->disjunctive || node->facts.size() == 1) {
+            for (const FactPair &fact : node->facts) {
+                if (fact.var >= static_cast<int>(ids_by_fact.size()))
+                    ids_by_fact.resize(fact.var + 1);
+                vector<vector<int>> &ids_by_value = ids_by_fact[fact.var];
+                if (fact.value >= static_cast<int>(ids_by_value.size()))
+                    ids_by_value.resize(fact.value + 1);
+                ids_by_value[fact.value].push_back(id);
+            }
+        } else {
+            conjunctive_landmarks.push_back(node);
+        }
+
+        vector<int> parent_ids;
+        for (const auto &parent : node->parents) {
+            parent_ids.push_back(parent.first->get_id());
+        }
+        parents.push_back(make_sparse_mask(move(parent_ids)));
+
+        vector<int> child_ids;
+        for (const auto &child : node->children) {
+            if (child.second >= EdgeType::greedy_necessary)
+                child_ids.push_back(child.first->get_id());
+        }
+        greedy_necessary_children.push_back(make_sparse_mask(move(child_ids)));
+
+        if (node->is_goal())
+            goal_landmarks[block_index] |= mask;
+        if (!node->is_derived) {
+            if (node->first_achievers.empty())
+                no_first_achievers[block_index] |= mask;
+            if (node->possible_achievers.empty())
+                no_possible_achievers[block_index] |= mask;
+        }
+
+        auto it = find(costs.begin(), costs.end(), node->min_cost);
+        if (it == costs.end()) {
+            costs.push_back(node->min_cost);
+            ids_by_cost.emplace_back();
+            ids_by_cost.back().push_back(id);
+        } else {
+            ids_by_cost[it - costs.begin()].push_back(id);
+        }
+    }
+
+    landmarks_by_fact.resize(ids_by_fact.size());
+    for (size_t var = 0; var < ids_by_fact.size(); ++var) {
+        for (vector<int> &ids : ids_by_fact[var]) {
+            landmarks_by_fact[var].push_back(make_sparse_mask(move(ids)));
+        }
+    }
+    for (size_t i = 0; i < costs.size(); ++i) {
+        landmarks_by_cost.emplace_back(
+            costs[i], make_sparse_mask(move(ids_by_cost[i])));
+    }
+}
+
+LandmarkStatusManager::SparseMask LandmarkStatusManager::make_sparse_mask(
+    vector<int> &&ids) {
+    sort(ids.begin(), ids.end());
+    SparseMask mask;
+    for (int id : ids) {
+        int block_index = BitsetMath::block_index(id);
+        if (mask.empty() || mask.back().first != block_index)
+            mask.emplace_back(block_index, BitsetMath::zeros);
+        mask.back().second |= BitsetMath::bit_mask(id);
+    }
+    return mask;
 }
 
 BitsetView LandmarkStatusManager::get_reached_landmarks(const GlobalState &state) {
     return reached_lms[state];
 }
 
+void LandmarkStatusManager::compute_true_landmarks(
+    const GlobalState &global_state) {
+    fill(true_lms.begin(), true_lms.end(), BitsetMath::zeros);
+    int num_vars = landmarks_by_fact.size();
+    for (int var = 0; var < num_vars; ++var) {
+        const vector<SparseMask> &masks_by_value = landmarks_by_fact[var];
+        int value = global_state[var];
+        if (value < static_cast<int>(masks_by_value.size())) {
+            for (const auto &block : masks_by_value[value]) {
+                true_lms[block.first] |= block.second;
+            }
+        }
+    }
+    for (const LandmarkNode *node : conjunctive_landmarks) {
+        if (node->is_true_in_state(global_state)) {
+            int id = node->get_id();
+            true_lms[BitsetMath::block_index(id)] |= BitsetMath::bit_mask(id);
+        }
+    }
+}
+
+int LandmarkStatusManager::get_cost(const BitsetView &lms) const {
+    int cost = 0;
+    for (const auto &cost_and_mask : landmarks_by_cost) {
+        int num_lms = 0;
+        for (const auto &block : cost_and_mask.second) {
+            num_lms += BitsetMath::popcount(
+                lms.get_block(block.first) & block.second);
+        }
+        cost += cost_and_mask.first * num_lms;
+    }
+    return cost;
+}
+
+int LandmarkStatusManager::get_cost(const vector<Block> &lms) const {
+    int cost = 0;
+    for (const auto &cost_and_mask : landmarks_by_cost) {
+        int num_lms = 0;
+        for (const auto &block : cost_and_mask.second) {
+            num_lms += BitsetMath::popcount(lms[block.first] & block.second);
+        }
+        cost += cost_and_mask.first * num_lms;
+    }
+    return cost;
+}
+
 void LandmarkStatusManager::set_landmarks_for_initial_state(
     const GlobalState &initial_state) {
     BitsetView reached = get_reached_landmarks(initial_state);
@@ -72,9 +207,8 @@ bool LandmarkStatusManager::update_reached_lms(const GlobalState &parent_global_
     const BitsetView parent_reached = get_reached_landmarks(parent_global_state);
     BitsetView reached = get_reached_landmarks(global_state);
 
-    int num_landmarks = lm_graph.number_of_landmarks();
-    assert(reached.size() == num_landmarks);
-    assert(parent_reached.size() == num_landmarks);
+    assert(reached.size() == lm_graph.number_of_landmarks());
+    assert(parent_reached.size() == lm_graph.number_of_landmarks());
 
     /*
        Set all landmarks not reached by this parent as "not reached".
@@ -89,15 +223,23 @@ bool LandmarkStatusManager::update_reached_lms(const GlobalState &parent_global_
     reached.intersect(parent_reached);
 
 
-    // Mark landmarks reached right now as "reached" (if they are "leaves").
-    for (int id = 0; id < num_landmarks; ++id) {
-        if (!reached.test(id)) {
-            LandmarkNode *node = lm_graph.get_lm_for_index(id);
-            if (node->is_true_in_state(global_state)) {
-                if (landmark_is_leaf(*node, reached)) {
-                    reached.set(id);
-                }
+    /*
+      Mark landmarks reached right now as "reached" (if they are "leaves").
+      We visit the candidates in order of their IDs and update "reached"
+      immediately, so a landmark can become a leaf because a parent with
+      a smaller ID has been reached in the same step.
+    */
+    compute_true_landmarks(global_state);
+    for (int block_index = 0; block_index < num_blocks; ++block_index) {
+        Block &reached_block = reached.get_block(block_index);
+        Block candidates = true_lms[block_index] & ~reached_block;
+        while (candidates != BitsetMath::zeros) {
+            int bit_index = BitsetMath::lowest_bit_index(candidates);
+            int id = block_index * BitsetMath::bits_per_block + bit_index;
+            if (landmark_is_leaf(id, reached)) {
+                reached_block |= BitsetMath::bit_mask(id);
             }
+            candidates &= candidates - 1;
         }
     }
 
@@ -106,31 +248,31 @@ bool LandmarkStatusManager::update_reached_lms(const GlobalState &parent_global_
 
 bool LandmarkStatusManager::update_lm_status(const GlobalState &global_state) {
     const BitsetView reached = get_reached_landmarks(global_state);
+    compute_true_landmarks(global_state);
 
-    const LandmarkGraph::Nodes &nodes = lm_graph.get_nodes();
-    // initialize all nodes to not reached and not effect of unused ALM
-    for (auto &node : nodes) {
-        node->status = lm_not_reached;
-        if (reached.test(node->get_id())) {
-            node->status = lm_reached;
-        }
-    }
-
+    /*
+      A reached landmark that is false now is needed again if it is a
+      goal or if it has a greedy-necessary child that has not been
+      reached.
+    */
     bool dead_end_found = false;
-
-    // mark reached and find needed again landmarks
-    for (auto &node : nodes) {
-        if (node->status == lm_reached) {
-            if (!node->is_true_in_state(global_state)) {
-                if (node->is_goal()) {
-                    node->status = lm_needed_again;
-                } else {
-                    if (check_lost_landmark_children_needed_again(*node)) {
-                        node->status = lm_needed_again;
-                    }
+    for (int block_index = 0; block_index < num_blocks; ++block_index) {
+        Block reached_block = reached.get_block(block_index);
+        Block lost = reached_block & ~true_lms[block_index];
+        Block needed_again = lost & goal_landmarks[block_index];
+        Block candidates = lost & ~goal_landmarks[block_index];
+        while (candidates != BitsetMath::zeros) {
+            int bit_index = BitsetMath::lowest_bit_index(candidates);
+            int id = block_index * BitsetMath::bits_per_block + bit_index;
+            for (const auto &block : greedy_necessary_children[id]) {
+                if (block.second & ~reached.get_block(block.first)) {
+                    needed_again |= BitsetMath::bit_mask(id);
+                    break;
                 }
             }
+            candidates &= candidates - 1;
         }
+        needed_again_lms[block_index] = needed_again;
 
         // This dead-end detection works for the following case:
         // X is a goal, it is true in the initial state, and has no achievers.
@@ -140,38 +282,38 @@ bool LandmarkStatusManager::update_lm_status(const GlobalState &global_state) {
         // Note: this only tests for reachability of the landmark from the initial state.
         // A (possibly) more effective option would be to test reachability of the landmark
         // from the current state.
-
-        if (!node->is_derived) {
-            if ((node->status == lm_not_reached) &&
-                node->first_achievers.empty()) {
-                dead_end_found = true;
-            }
-            if ((node->status == lm_needed_again) &&
-                node->possible_achievers.empty()) {
-                dead_end_found = true;
-            }
+        if ((~reached_block & no_first_achievers[block_index]) ||
+            (needed_again & no_possible_achievers[block_index])) {
+            dead_end_found = true;
         }
     }
 
+    reached_cost = get_cost(reached);
+    needed_cost = get_cost(needed_again_lms);
     return dead_end_found;
 }
 
-
-bool LandmarkStatusManager::check_lost_landmark_children_needed_again(const LandmarkNode &node) const {
-    for (const auto &child : node.children) {
-        LandmarkNode *child_node = child.first;
-        if (child.second >= EdgeType::greedy_necessary && child_node->status == lm_not_reached)
-            return true;
+void LandmarkStatusManager::set_landmark_statuses(
+    const GlobalState &global_state) {
+    const BitsetView reached = get_reached_landmarks(global_state);
+    for (auto &node : lm_graph.get_nodes()) {
+        int id = node->get_id();
+        if (!reached.test(id)) {
+            node->status = lm_not_reached;
+        } else if (needed_again_lms[BitsetMath::block_index(id)] &
+                   BitsetMath::bit_mask(id)) {
+            node->status = lm_needed_again;
+        } else {
+            node->status = lm_reached;
+        }
     }
-    return false;
 }
 
-bool LandmarkStatusManager::landmark_is_leaf(const LandmarkNode &node, const BitsetView &reached) const {
+bool LandmarkStatusManager::landmark_is_leaf(int id, const BitsetView &reached) const {
     //Note: this is the same as !check_node_orders_disobeyed
-    for (const auto &parent : node.parents) {
-        LandmarkNode *parent_node = parent.first;
-        // Note: no condition on edge type here
-        if (!reached.test(parent_node->get_id())) {
+    // Note: no condition on edge type here
+    for (const auto &block : parents[id]) {
+        if (block.second & ~reached.get_block(block.first)) {
             return false;
         }
     }
@@ -3,23 +3,79 @@
 
 #include "../per_state_bitset.h"
 
+#include <utility>
+#include <vector>
+
 namespace landmarks {
 class LandmarkGraph;
 class LandmarkNode;
 
+/*
+  All status computations work on blocks of the landmark bitsets. Sets
+  of landmarks that are known in advance (e.g., the parents of a
+  landmark) are stored as sparse masks, i.e., as the list of their
+  non-zero blocks. This way, a status update costs a few operations per
+  block of landmarks plus a few operations per landmark whose status is
+  not determined by the blocks alone.
+*/
 class LandmarkStatusManager {
+    using Block = BitsetMath::Block;
+    // Pairs of block index and block.
+    using SparseMask = std::vector<std::pair<int, Block>>;
+
     PerStateBitset reached_lms;
 
     LandmarkGraph &lm_graph;
+    const int num_blocks;
+
+    /*
+      Simple and disjunctive landmarks containing a given fact, indexed
+      by variable and value. Conjunctive landmarks are tested
+      separately.
+    */
+    std::vector<std::vector<SparseMask>> landmarks_by_fact;
+    std::vector<LandmarkNode *> conjunctive_landmarks;
 
-    bool landmark_is_leaf(const LandmarkNode &node, const BitsetView &reached) const;
-    bool check_lost_landmark_children_needed_again(const LandmarkNode &node) const;
+    std::vector<SparseMask> parents;
+    std::vector<SparseMask> greedy_necessary_children;
+    std::vector<Block> goal_landmarks;
+    // Non-derived landmarks without first or possible achievers.
+    std::vector<Block> no_first_achievers;
+    std::vector<Block> no_possible_achievers;
+    // Landmarks grouped by their minimal achiever cost.
+    std::vector<std::pair<int, SparseMask>> landmarks_by_cost;
+
+    std::vector<Block> true_lms;
+    // Status of the state last passed to update_lm_status.
+    std::vector<Block> needed_again_lms;
+    int reached_cost;
+    int needed_cost;
+
+    static SparseMask make_sparse_mask(std::vector<int> &&ids);
+    void compute_true_landmarks(const GlobalState &global_state);
+    int get_cost(const BitsetView &lms) const;
+    int get_cost(const std::vector<Block> &lms) const;
 public:
     explicit LandmarkStatusManager(LandmarkGraph &graph);
 
     BitsetView get_reached_landmarks(const GlobalState &state);
 
+    /*
+      Compute the reached and needed-again landmarks of the given state
+      and return true if the state is recognized as a dead end. Costs
+      and statuses refer to the last state passed to this function.
+    */
     bool update_lm_status(const GlobalState &global_state);
+    int get_reached_cost() const {
+        return reached_cost;
+    }
+    int get_needed_cost() const {
+        return needed_cost;
+    }
+    // Store the status of each landmark in its node.
+    void set_landmark_statuses(const GlobalState &global_state);
+
+    bool landmark_is_leaf(int id, const BitsetView &reached) const;
 
     void set_landmarks_for_initial_state(const GlobalState &initial_state);
     bool update_reached_lms(const GlobalState &parent_global_state,
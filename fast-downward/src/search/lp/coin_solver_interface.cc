@@ -0,0 +1,395 @@
+#include "coin_solver_interface.h"
+
+#ifdef USE_LP
+#include "lp_internals.h"
+#include "lp_solver.h"
+
+#include "../utils/system.h"
+
+#ifdef __GNUG__
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+#endif
+#include <OsiSolverInterface.hpp>
+#include <CoinPackedMatrix.hpp>
+#include <CoinPackedVector.hpp>
+#include <CoinWarmStartBasis.hpp>
+#ifdef __GNUG__
+#pragma GCC diagnostic pop
+#endif
+
+#include <algorithm>
+#include <cassert>
+#include <numeric>
+
+using namespace std;
+using utils::ExitCode;
+
+namespace lp {
+CoinSolverInterface::CoinSolverInterface(LPSolverType solver_type)
+    : is_initialized(false),
+      is_solved(false),
+      num_permanent_constraints(0),
+      has_temporary_constraints_(false) {
+    lp_solver = create_lp_solver(solver_type);
+}
+
+CoinSolverInterface::~CoinSolverInterface() {
+}
+
+void CoinSolverInterface::clear_temporary_data() {
+    elements.clear();
+    indices.clear();
+    starts.clear();
+    col_lb.clear();
+    col_ub.clear();
+    objective.clear();
+    row_lb.clear();
+    row_ub.clear();
+    rows.clear();
+}
+
+void CoinSolverInterface::load_problem(LPObjectiveSense sense,
+                            const vector<LPVariable> &variables,
+                            const vector<LPConstraint> &constraints) {
+    clear_temporary_data();
+    is_initialized = false;
+    num_permanent_constraints = constraints.size();
+
+    for (const LPVariable &var : variables) {
+        col_lb.push_back(var.lower_bound);
+        col_ub.push_back(var.upper_bound);
+        objective.push_back(var.objective_coefficient);
+    }
+    for (const LPConstraint &constraint : constraints) {
+        row_lb.push_back(constraint.get_lower_bound());
+        row_ub.push_back(constraint.get_upper_bound());
+    }
+
+    if (sense == LPObjectiveSense::MINIMIZE) {
+        lp_solver->setObjSense(1);
+    } else {
+        lp_solver->setObjSense(-1);
+    }
+
+    for (const LPConstraint &constraint : constraints) {
+        const vector<int> &vars = constraint.get_variables();
+        const vector<double> &coeffs = constraint.get_coefficients();
+        assert(vars.size() == coeffs.size());
+        starts.push_back(elements.size());
+        indices.insert(indices.end(), vars.begin(), vars.end());
+        elements.insert(elements.end(), coeffs.begin(), coeffs.end());
+    }
+    /*
+      There are two ways to pass the lengths of vectors to a CoinMatrix:
+      1) 'starts' contains one entry per vector and we pass a separate array
+         of vector 'lengths' to the constructor.
+      2) If there are no gaps in the elements, we can also add elements.size()
+         as a last entry in the vector 'starts' and leave the parameter for
+         'lengths' at its default (0).
+      OSI recreates the 'lengths' array in any case and uses optimized code
+      for the second case, so we use it here.
+     */
+    starts.push_back(elements.size());
+
+    try {
+        CoinPackedMatrix matrix(false,
+                                variables.size(),
+                                constraints.size(),
+                                elements.size(),
+                                elements.data(),
+                                indices.data(),
+                                starts.data(),
+                                0);
+        lp_solver->loadProblem(matrix,
+                               col_lb.data(),
+                               col_ub.data(),
+                               objective.data(),
+                               row_lb.data(),
+                               row_ub.data());
+    } catch (CoinError &error) {
+        handle_coin_error(error);
+    }
+
+    clear_temporary_data();
+}
+
+void CoinSolverInterface::add_temporary_constraints(const vector<LPConstraint> &constraints) {
+    if (!constraints.empty()) {
+        clear_temporary_data();
+        int num_rows = constraints.size();
+        for (const LPConstraint &constraint : constraints) {
+            row_lb.push_back(constraint.get_lower_bound());
+            row_ub.push_back(constraint.get_upper_bound());
+            rows.push_back(new CoinShallowPackedVector(
+                               constraint.get_variables().size(),
+                               constraint.get_variables().data(),
+                               constraint.get_coefficients().data(),
+                               false));
+        }
+
+        try {
+            lp_solver->addRows(num_rows,
+                               rows.data(), row_lb.data(), row_ub.data());
+        } catch (CoinError &error) {
+            handle_coin_error(error);
+        }
+        for (CoinPackedVectorBase *row : rows) {
+            delete row;
+        }
+        clear_temporary_data();
+        has_temporary_constraints_ = true;
+        is_solved = false;
+    }
+}
+
+void CoinSolverInterface::clear_temporary_constraints() {
+    if (has_temporary_constraints_) {
+        try {
+            lp_solver->restoreBaseModel(num_permanent_constraints);
+        } catch (CoinError &error) {
+            handle_coin_error(error);
+        }
+        has_temporary_constraints_ = false;
+        is_solved = false;
+    }
+}
+
+double CoinSolverInterface::get_infinity() const {
+    try {
+        return lp_solver->getInfinity();
+    } catch (CoinError &error) {
+        handle_coin_error(error);
+    }
+}
+
+void CoinSolverInterface::set_objective_coefficients(const vector<double> &coefficients) {
+    assert(static_cast<int>(coefficients.size()) == get_num_variables());
+    vector<int> indices(coefficients.size());
+    iota(indices.begin(), indices.end(), 0);
+    try {
+        lp_solver->setObjCoeffSet(indices.data(),
+                                  indices.data() + indices.size(),
+                                  coefficients.data());
+    } catch (CoinError &error) {
+        handle_coin_error(error);
+    }
+    is_solved = false;
+}
+
+void CoinSolverInterface::set_objective_coefficient(int index, double coefficient) {
+    assert(index < get_num_variables());
+    try {
+        lp_solver->setObjCoeff(index, coefficient);
+    } catch (CoinError &error) {
+        handle_coin_error(error);
+    }
+    is_solved = false;
+}
+
+void CoinSolverInterface::set_constraint_lower_bound(int index, double bound) {
+    assert(index < get_num_constraints());
+    try {
+        lp_solver->setRowLower(index, bound);
+    } catch (CoinError &error) {
+        handle_coin_error(error);
+    }
+    is_solved = false;
+}
+
+void CoinSolverInterface::set_constraint_upper_bound(int index, double bound) {
+    assert(index < get_num_constraints());
+    try {
+        lp_solver->setRowUpper(index, bound);
+    } catch (CoinError &error) {
+        handle_coin_error(error);
+    }
+    is_solved = false;
+}
+
+void CoinSolverInterface::set_variable_lower_bound(int index, double bound) {
+    assert(index < get_num_variables());
+    try {
+        lp_solver->setColLower(index, bound);
+    } catch (CoinError &error) {
+        handle_coin_error(error);
+    }
+    is_solved = false;
+}
+
+void CoinSolverInterface::set_variable_upper_bound(int index, double bound) {
+    assert(index < get_num_variables());
+    try {
+        lp_solver->setColUpper(index, bound);
+    } catch (CoinError &error) {
+        handle_coin_error(error);
+    }
+    is_solved = false;
+}
+
+void CoinSolverInterface::solve() {
+    try {
+        if (is_initialized) {
+            lp_solver->resolve();
+        } else {
+            lp_solver->initialSolve();
+            is_initialized = true;
+        }
+        if (lp_solver->isAbandoned()) {
+            // The documentation of OSI is not very clear here but memory seems
+            // to be the most common cause for this in our case.
+            cerr << "Abandoned LP during resolve. "
+                 << "Reasons include \"numerical difficulties\" and running out of memory." << endl;
+            utils::exit_with(ExitCode::SEARCH_CRITICAL_ERROR);
+        }
+        is_solved = true;
+    } catch (CoinError &error) {
+        handle_coin_error(error);
+    }
+}
+
+static CoinWarmStartBasis::Status get_coin_status(BasisStatus status) {
+    switch (status) {
+    case BasisStatus::BASIC:
+        return CoinWarmStartBasis::basic;
+    case BasisStatus::AT_LOWER:
+        return CoinWarmStartBasis::atLowerBound;
+    case BasisStatus::AT_UPPER:
+        return CoinWarmStartBasis::atUpperBound;
+    case BasisStatus::FREE:
+        return CoinWarmStartBasis::isFree;
+    }
+    ABORT("Unknown basis status.");
+}
+
+static BasisStatus get_basis_status(CoinWarmStartBasis::Status status) {
+    switch (status) {
+    case CoinWarmStartBasis::basic:
+        return BasisStatus::BASIC;
+    case CoinWarmStartBasis::atLowerBound:
+        return BasisStatus::AT_LOWER;
+    case CoinWarmStartBasis::atUpperBound:
+        return BasisStatus::AT_UPPER;
+    case CoinWarmStartBasis::isFree:
+        return BasisStatus::FREE;
+    }
+    ABORT("Unknown basis status.");
+}
+
+/*
+  We store the status of the artificial variables as reported by OSI,
+  so the status of constraints only has the meaning documented in
+  LPBasis if the solver follows the same convention. This is enough
+  for passing bases back to the same solver.
+*/
+void CoinSolverInterface::get_basis(LPBasis &basis) const {
+    assert(is_initialized);
+    basis.variable_status.clear();
+    basis.constraint_status.clear();
+    try {
+        unique_ptr<CoinWarmStart> warm_start(lp_solver->getWarmStart());
+        const CoinWarmStartBasis *coin_basis =
+            dynamic_cast<const CoinWarmStartBasis *>(warm_start.get());
+        if (!coin_basis)
+            return;
+        for (int i = 0; i < coin_basis->getNumStructural(); ++i) {
+            basis.variable_status.push_back(
+                get_basis_status(coin_basis->getStructStatus(i)));
+        }
+        for (int i = 0; i < coin_basis->getNumArtificial(); ++i) {
+            basis.constraint_status.push_back(
+                get_basis_status(coin_basis->getArtifStatus(i)));
+        }
+    } catch (CoinError &error) {
+        handle_coin_error(error);
+    }
+}
+
+void CoinSolverInterface::set_basis(const LPBasis &basis) {
+    if (!is_initialized) {
+        // The first LP is always solved from scratch.
+        return;
+    }
+    try {
+        int num_cols = lp_solver->getNumCols();
+        int num_rows = lp_solver->getNumRows();
+        int num_known_cols = min<int>(num_cols, basis.variable_status.size());
+        int num_known_rows = min<int>(num_rows, basis.constraint_status.size());
+        CoinWarmStartBasis coin_basis;
+        coin_basis.setSize(num_cols, num_rows);
+        for (int i = 0; i < num_known_cols; ++i) {
+            coin_basis.setStructStatus(
+                i, get_coin_status(basis.variable_status[i]));
+        }
+        for (int i = 0; i < num_rows; ++i) {
+            CoinWarmStartBasis::Status status = CoinWarmStartBasis::basic;
+            if (i < num_known_rows)
+                status = get_coin_status(basis.constraint_status[i]);
+            coin_basis.setArtifStatus(i, status);
+        }
+        lp_solver->setWarmStart(&coin_basis);
+    } catch (CoinError &error) {
+        handle_coin_error(error);
+    }
+    is_solved = false;
+}
+
+bool CoinSolverInterface::has_optimal_solution() const {
+    assert(is_solved);
+    try {
+        return !lp_solver->isProvenPrimalInfeasible() &&
+               !lp_solver->isProvenDualInfeasible() &&
+               lp_solver->isProvenOptimal();
+    } catch (CoinError &error) {
+        handle_coin_error(error);
+    }
+}
+
+double CoinSolverInterface::get_objective_value() const {
+    assert(has_optimal_solution());
+    try {
+        return lp_solver->getObjValue();
+    } catch (CoinError &error) {
+        handle_coin_error(error);
+    }
+}
+
+vector<double> CoinSolverInterface::extract_solution() const {
+    assert(has_optimal_solution());
+    try {
+        const double *sol = lp_solver->getColSolution();
+        return vector<double>(sol, sol + get_num_variables());
+    } catch (CoinError &error) {
+        handle_coin_error(error);
+    }
+}
+
+int CoinSolverInterface::get_num_variables() const {
+    try {
+        return lp_solver->getNumCols();
+    } catch (CoinError &error) {
+        handle_coin_error(error);
+    }
+}
+
+int CoinSolverInterface::get_num_constraints() const {
+    try {
+        return lp_solver->getNumRows();
+    } catch (CoinError &error) {
+        handle_coin_error(error);
+    }
+}
+
+bool CoinSolverInterface::has_temporary_constraints() const {
+    return has_temporary_constraints_;
+}
+
+int CoinSolverInterface::get_num_iterations() const {
+    try {
+        return lp_solver->getIterationCount();
+    } catch (CoinError &error) {
+        handle_coin_error(error);
+    }
+}
+}
+#endif
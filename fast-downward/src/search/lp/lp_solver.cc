@@ -1,36 +1,25 @@
 #include "lp_solver.h"
 
-#include "lp_internals.h"
+#include "coin_solver_interface.h"
+#include "simplex_solver.h"
 
 #include "../option_parser.h"
 
+#include "../utils/memory.h"
 #include "../utils/system.h"
 
-#ifdef USE_LP
-#ifdef __GNUG__
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wunused-parameter"
-#endif
-#include <OsiSolverInterface.hpp>
-#include <CoinPackedMatrix.hpp>
-#include <CoinPackedVector.hpp>
-#ifdef __GNUG__
-#pragma GCC diagnostic pop
-#endif
-#endif
-
+#include <algorithm>
 #include <cassert>
-#include <numeric>
 
 using namespace std;
-using utils::ExitCode;
 
 namespace lp {
 void add_lp_solver_option_to_parser(OptionParser &parser) {
     parser.document_note(
         "Note",
-        "to use an LP solver, you must build the planner with LP support. "
-        "See LPBuildInstructions.");
+        "to use an external LP solver, you must build the planner with LP "
+        "support. See LPBuildInstructions. The embedded solver is always "
+        "available and is the default in builds without LP support.");
     vector<string> lp_solvers;
     vector<string> lp_solvers_doc;
     lp_solvers.push_back("CLP");
@@ -39,11 +28,18 @@ void add_lp_solver_option_to_parser(OptionParser &parser) {
     lp_solvers_doc.push_back("commercial solver by IBM");
     lp_solvers.push_back("GUROBI");
     lp_solvers_doc.push_back("commercial solver");
+    lp_solvers.push_back("EMBEDDED");
+    lp_solvers_doc.push_back("simplex solver shipped with the planner");
+#ifdef USE_LP
+    string default_lp_solver = "CPLEX";
+#else
+    string default_lp_solver = "EMBEDDED";
+#endif
     parser.add_enum_option(
         "lpsolver",
         lp_solvers,
-        "external solver that should be used to solve linear programs",
-        "CPLEX",
+        "solver that should be used to solve linear programs",
+        default_lp_solver,
         lp_solvers_doc);
 }
 
@@ -73,284 +69,144 @@ LPVariable::LPVariable(double lower_bound, double upper_bound,
       objective_coefficient(objective_coefficient) {
 }
 
-LPSolver::~LPSolver() {
-}
-
-#ifdef USE_LP
-
 LPSolver::LPSolver(LPSolverType solver_type)
-    : is_initialized(false),
-      is_solved(false),
-      num_permanent_constraints(0),
-      has_temporary_constraints_(false) {
-    lp_solver = create_lp_solver(solver_type);
+    : num_solves(0),
+      num_warm_starts(0),
+      last_num_iterations(0),
+      total_num_iterations(0),
+      max_num_iterations(0),
+      last_solve_time(0),
+      max_solve_time(0) {
+    if (solver_type == LPSolverType::EMBEDDED) {
+        pimpl = utils::make_unique_ptr<SimplexSolver>();
+    } else {
+#ifdef USE_LP
+        pimpl = utils::make_unique_ptr<CoinSolverInterface>(solver_type);
+#else
+        ABORT("External LP solver requested but the planner was compiled "
+              "without LP support.\n"
+              "See http://www.fast-downward.org/LPBuildInstructions\n"
+              "to install an LP solver and use it in the planner, or use "
+              "lpsolver=embedded.");
+#endif
+    }
+    solve_timer.stop();
+    solve_timer.reset();
 }
 
-void LPSolver::clear_temporary_data() {
-    elements.clear();
-    indices.clear();
-    starts.clear();
-    col_lb.clear();
-    col_ub.clear();
-    objective.clear();
-    row_lb.clear();
-    row_ub.clear();
-    rows.clear();
+LPSolver::~LPSolver() {
 }
 
 void LPSolver::load_problem(LPObjectiveSense sense,
                             const vector<LPVariable> &variables,
                             const vector<LPConstraint> &constraints) {
-    clear_temporary_data();
-    is_initialized = false;
-    num_permanent_constraints = constraints.size();
-
-    for (const LPVariable &var : variables) {
-        col_lb.push_back(var.lower_bound);
-        col_ub.push_back(var.upper_bound);
-        objective.push_back(var.objective_coefficient);
-    }
-    for (const LPConstraint &constraint : constraints) {
-        row_lb.push_back(constraint.get_lower_bound());
-        row_ub.push_back(constraint.get_upper_bound());
-    }
-
-    if (sense == LPObjectiveSense::MINIMIZE) {
-        lp_solver->setObjSense(1);
-    } else {
-        lp_solver->setObjSense(-1);
-    }
-
-    for (const LPConstraint &constraint : constraints) {
-        const vector<int> &vars = constraint.get_variables();
-        const vector<double> &coeffs = constraint.get_coefficients();
-        assert(vars.size() == coeffs.size());
-        starts.push_back(elements.size());
-        indices.insert(indices.end(), vars.begin(), vars.end());
-        elements.insert(elements.end(), coeffs.begin(), coeffs.end());
-    }
-    /*
-      There are two ways to pass the lengths of vectors to a CoinMatrix:
-      1) 'starts' contains one entry per vector and we pass a separate array
-         of vector 'lengths' to the constructor.
-      2) If there are no gaps in the elements, we can also add elements.size()
-         as a last entry in the vector 'starts' and leave the parameter for
-         'lengths' at its default (0).
-      OSI recreates the 'lengths' array in any case and uses optimized code
-      for the second case, so we use it here.
-     */
-    starts.push_back(elements.size());
-
-    try {
-        CoinPackedMatrix matrix(false,
-                                variables.size(),
-                                constraints.size(),
-                                elements.size(),
-                                elements.data(),
-                                indices.data(),
-                                starts.data(),
-                                0);
-        lp_solver->loadProblem(matrix,
-                               col_lb.data(),
-                               col_ub.data(),
-                               objective.data(),
-                               row_lb.data(),
-                               row_ub.data());
-    } catch (CoinError &error) {
-        handle_coin_error(error);
-    }
-
-    clear_temporary_data();
+    pimpl->load_problem(sense, variables, constraints);
 }
 
 void LPSolver::add_temporary_constraints(const vector<LPConstraint> &constraints) {
-    if (!constraints.empty()) {
-        clear_temporary_data();
-        int num_rows = constraints.size();
-        for (const LPConstraint &constraint : constraints) {
-            row_lb.push_back(constraint.get_lower_bound());
-            row_ub.push_back(constraint.get_upper_bound());
-            rows.push_back(new CoinShallowPackedVector(
-                               constraint.get_variables().size(),
-                               constraint.get_variables().data(),
-                               constraint.get_coefficients().data(),
-                               false));
-        }
-
-        try {
-            lp_solver->addRows(num_rows,
-                               rows.data(), row_lb.data(), row_ub.data());
-        } catch (CoinError &error) {
-            handle_coin_error(error);
-        }
-        for (CoinPackedVectorBase *row : rows) {
-            delete row;
-        }
-        clear_temporary_data();
-        has_temporary_constraints_ = true;
-        is_solved = false;
-    }
+    pimpl->add_temporary_constraints(constraints);
 }
 
 void LPSolver::clear_temporary_constraints() {
-    if (has_temporary_constraints_) {
-        try {
-            lp_solver->restoreBaseModel(num_permanent_constraints);
-        } catch (CoinError &error) {
-            handle_coin_error(error);
-        }
-        has_temporary_constraints_ = false;
-        is_solved = false;
-    }
+    pimpl->clear_temporary_constraints();
 }
 
 double LPSolver::get_infinity() const {
-    try {
-        return lp_solver->getInfinity();
-    } catch (CoinError &error) {
-        handle_coin_error(error);
-    }
+    return pimpl->get_infinity();
 }
 
 void LPSolver::set_objective_coefficients(const vector<double> &coefficients) {
     assert(static_cast<int>(coefficients.size()) == get_num_variables());
-    vector<int> indices(coefficients.size());
-    iota(indices.begin(), indices.end(), 0);
-    try {
-        lp_solver->setObjCoeffSet(indices.data(),
-                                  indices.data() + indices.size(),
-                                  coefficients.data());
-    } catch (CoinError &error) {
-        handle_coin_error(error);
-    }
-    is_solved = false;
+    pimpl->set_objective_coefficients(coefficients);
 }
 
 void LPSolver::set_objective_coefficient(int index, double coefficient) {
     assert(index < get_num_variables());
-    try {
-        lp_solver->setObjCoeff(index, coefficient);
-    } catch (CoinError &error) {
-        handle_coin_error(error);
-    }
-    is_solved = false;
+    pimpl->set_objective_coefficient(index, coefficient);
 }
 
 void LPSolver::set_constraint_lower_bound(int index, double bound) {
     assert(index < get_num_constraints());
-    try {
-        lp_solver->setRowLower(index, bound);
-    } catch (CoinError &error) {
-        handle_coin_error(error);
-    }
-    is_solved = false;
+    pimpl->set_constraint_lower_bound(index, bound);
 }
 
 void LPSolver::set_constraint_upper_bound(int index, double bound) {
     assert(index < get_num_constraints());
-    try {
-        lp_solver->setRowUpper(index, bound);
-    } catch (CoinError &error) {
-        handle_coin_error(error);
-    }
-    is_solved = false;
+    pimpl->set_constraint_upper_bound(index, bound);
 }
 
 void LPSolver::set_variable_lower_bound(int index, double bound) {
     assert(index < get_num_variables());
-    try {
-        lp_solver->setColLower(index, bound);
-    } catch (CoinError &error) {
-        handle_coin_error(error);
-    }
-    is_solved = false;
+    pimpl->set_variable_lower_bound(index, bound);
 }
 
 void LPSolver::set_variable_upper_bound(int index, double bound) {
     assert(index < get_num_variables());
-    try {
-        lp_solver->setColUpper(index, bound);
-    } catch (CoinError &error) {
-        handle_coin_error(error);
-    }
-    is_solved = false;
+    pimpl->set_variable_upper_bound(index, bound);
 }
 
 void LPSolver::solve() {
-    try {
-        if (is_initialized) {
-            lp_solver->resolve();
-        } else {
-            lp_solver->initialSolve();
-            is_initialized = true;
-        }
-        if (lp_solver->isAbandoned()) {
-            // The documentation of OSI is not very clear here but memory seems
-            // to be the most common cause for this in our case.
-            cerr << "Abandoned LP during resolve. "
-                 << "Reasons include \"numerical difficulties\" and running out of memory." << endl;
-            utils::exit_with(ExitCode::SEARCH_CRITICAL_ERROR);
-        }
-        is_solved = true;
-    } catch (CoinError &error) {
-        handle_coin_error(error);
-    }
+    double time_before = solve_timer();
+    solve_timer.resume();
+    pimpl->solve();
+    solve_timer.stop();
+    last_solve_time = solve_timer() - time_before;
+    last_num_iterations = pimpl->get_num_iterations();
+    ++num_solves;
+    total_num_iterations += last_num_iterations;
+    max_num_iterations = max(max_num_iterations, last_num_iterations);
+    max_solve_time = max(max_solve_time, last_solve_time);
+}
+
+shared_ptr<LPBasis> LPSolver::get_basis() const {
+    shared_ptr<LPBasis> basis = make_shared<LPBasis>();
+    pimpl->get_basis(*basis);
+    return basis;
+}
+
+void LPSolver::set_basis(const LPBasis &basis) {
+    pimpl->set_basis(basis);
+    ++num_warm_starts;
 }
 
 bool LPSolver::has_optimal_solution() const {
-    assert(is_solved);
-    try {
-        return !lp_solver->isProvenPrimalInfeasible() &&
-               !lp_solver->isProvenDualInfeasible() &&
-               lp_solver->isProvenOptimal();
-    } catch (CoinError &error) {
-        handle_coin_error(error);
-    }
+    return pimpl->has_optimal_solution();
 }
 
 double LPSolver::get_objective_value() const {
-    assert(has_optimal_solution());
-    try {
-        return lp_solver->getObjValue();
-    } catch (CoinError &error) {
-        handle_coin_error(error);
-    }
+    return pimpl->get_objective_value();
 }
 
 vector<double> LPSolver::extract_solution() const {
-    assert(has_optimal_solution());
-    try {
-        const double *sol = lp_solver->getColSolution();
-        return vector<double>(sol, sol + get_num_variables());
-    } catch (CoinError &error) {
-        handle_coin_error(error);
-    }
+    return pimpl->extract_solution();
 }
 
 int LPSolver::get_num_variables() const {
-    try {
-        return lp_solver->getNumCols();
-    } catch (CoinError &error) {
-        handle_coin_error(error);
-    }
+    return pimpl->get_num_variables();
 }
 
 int LPSolver::get_num_constraints() const {
-    try {
-        return lp_solver->getNumRows();
-    } catch (CoinError &error) {
-        handle_coin_error(error);
-    }
+    return pimpl->get_num_constraints();
 }
 
-int LPSolver::has_temporary_constraints() const {
-    return has_temporary_constraints_;
+bool LPSolver::has_temporary_constraints() const {
+    return pimpl->has_temporary_constraints();
 }
 
 void LPSolver::print_statistics() const {
     cout << "LP variables: " << get_num_variables() << endl;
     cout << "LP constraints: " << get_num_constraints() << endl;
+    cout << "LP solves: " << num_solves << endl;
+    cout << "LP solves started from a given basis: " << num_warm_starts << endl;
+    if (num_solves > 0) {
+        cout << "LP iterations: " << total_num_iterations
+             << " (average per solve: "
+             << static_cast<double>(total_num_iterations) / num_solves
+             << ", max: " << max_num_iterations << ")" << endl;
+        double total_solve_time = solve_timer();
+        cout << "LP solve time: " << total_solve_time << "s"
+             << " (average per solve: " << total_solve_time / num_solves
+             << "s, max: " << max_solve_time << "s)" << endl;
+    }
 }
-
-#endif
 }
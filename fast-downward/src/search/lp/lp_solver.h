@@ -1,38 +1,26 @@
 #ifndef LP_LP_SOLVER_H
 #define LP_LP_SOLVER_H
 
-#include "../utils/language.h"
-#include "../utils/system.h"
+#include "../utils/timer.h"
 
-#include <functional>
 #include <memory>
 #include <vector>
 
-/*
-  All methods that use COIN specific classes only do something useful
-  if the planner is compiled with USE_LP. Otherwise, they just print
-  an error message and abort.
-*/
-#ifdef USE_LP
-#define LP_METHOD(X) X;
-#else
-#define LP_METHOD(X) NO_RETURN X { \
-        ABORT("LP method called but the planner was compiled without LP support.\n" \
-              "See http://www.fast-downward.org/LPBuildInstructions\n" \
-              "to install an LP solver and use it in the planner."); \
-}
-#endif
-
-class CoinPackedVectorBase;
-class OsiSolverInterface;
-
 namespace options {
 class OptionParser;
 }
 
 namespace lp {
+class SolverInterface;
+
+/*
+  CLP, CPLEX and GUROBI are accessed through OSI and are only available
+  if the planner is compiled with USE_LP. The embedded solver is always
+  available and is the default if the planner is compiled without
+  USE_LP. misc/lp-solver-benchmark.py compares it to the OSI solvers.
+*/
 enum class LPSolverType {
-    CLP, CPLEX, GUROBI
+    CLP, CPLEX, GUROBI, EMBEDDED
 };
 
 enum class LPObjectiveSense {
@@ -73,59 +61,81 @@ struct LPVariable {
                double objective_coefficient);
 };
 
-#ifdef __GNUG__
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wunused-parameter"
-#endif
-class LPSolver {
-    bool is_initialized;
-    bool is_solved;
-    int num_permanent_constraints;
-    bool has_temporary_constraints_;
-#ifdef USE_LP
-    std::unique_ptr<OsiSolverInterface> lp_solver;
-#endif
+enum class BasisStatus {
+    BASIC, AT_LOWER, AT_UPPER, FREE
+};
 
+/*
+  Solver-independent representation of a basis. The status of a
+  constraint refers to its activity, e.g., AT_LOWER means that the
+  constraint is tight at its lower bound.
+*/
+struct LPBasis {
+    std::vector<BasisStatus> variable_status;
+    std::vector<BasisStatus> constraint_status;
+};
+
+class LPSolver {
+    std::unique_ptr<SolverInterface> pimpl;
+
+    // Statistics over all calls to solve().
+    int num_solves;
+    int num_warm_starts;
+    int last_num_iterations;
+    long long total_num_iterations;
+    int max_num_iterations;
+    utils::Timer solve_timer;
+    double last_solve_time;
+    double max_solve_time;
+public:
     /*
-      Temporary data for assigning a new problem. We keep the vectors
-      around to avoid recreating them in every assignment.
+      Solvers accessed through OSI abort with an error message if the
+      planner is compiled without USE_LP.
     */
-    std::vector<double> elements;
-    std::vector<int> indices;
-    std::vector<int> starts;
-    std::vector<double> col_lb;
-    std::vector<double> col_ub;
-    std::vector<double> objective;
-    std::vector<double> row_lb;
-    std::vector<double> row_ub;
-    std::vector<CoinPackedVectorBase *> rows;
-    void clear_temporary_data();
-public:
-    LP_METHOD(explicit LPSolver(LPSolverType solver_type))
+    explicit LPSolver(LPSolverType solver_type);
     /*
-      Note that the destructor does not use LP_METHOD because it should not
-      have the attribute NO_RETURN. It also cannot be set to the default
-      destructor here (~LPSolver() = default;) because OsiSolverInterface
-      is a forward declaration and the incomplete type cannot be destroyed.
+      The destructor cannot be set to the default destructor here
+      (~LPSolver() = default;) because SolverInterface is a forward
+      declaration and the incomplete type cannot be destroyed.
     */
     ~LPSolver();
 
-    LP_METHOD(void load_problem(
-                  LPObjectiveSense sense,
-                  const std::vector<LPVariable> &variables,
-                  const std::vector<LPConstraint> &constraints))
-    LP_METHOD(void add_temporary_constraints(const std::vector<LPConstraint> &constraints))
-    LP_METHOD(void clear_temporary_constraints())
-    LP_METHOD(double get_infinity() const)
+    void load_problem(
+        LPObjectiveSense sense,
+        const std::vector<LPVariable> &variables,
+        const std::vector<LPConstraint> &constraints);
+    void add_temporary_constraints(const std::vector<LPConstraint> &constraints);
+    void clear_temporary_constraints();
+    double get_infinity() const;
+
+    void set_objective_coefficients(const std::vector<double> &coefficients);
+    void set_objective_coefficient(int index, double coefficient);
+    void set_constraint_lower_bound(int index, double bound);
+    void set_constraint_upper_bound(int index, double bound);
+    void set_variable_lower_bound(int index, double bound);
+    void set_variable_upper_bound(int index, double bound);
+
+    void solve();
 
-    LP_METHOD(void set_objective_coefficients(const std::vector<double> &coefficients))
-    LP_METHOD(void set_objective_coefficient(int index, double coefficient))
-    LP_METHOD(void set_constraint_lower_bound(int index, double bound))
-    LP_METHOD(void set_constraint_upper_bound(int index, double bound))
-    LP_METHOD(void set_variable_lower_bound(int index, double bound))
-    LP_METHOD(void set_variable_upper_bound(int index, double bound))
+    /*
+      By default, each solve() starts from the basis of the previously
+      solved LP. get_basis() returns the basis of the last solved LP and
+      set_basis() makes the next solve() start from a given basis
+      instead. Bases stay usable after the temporary constraints
+      change: rows that the basis does not know are treated as basic
+      and superfluous rows are dropped. The solver repairs the basis if
+      this leaves it singular.
+    */
+    std::shared_ptr<LPBasis> get_basis() const;
+    void set_basis(const LPBasis &basis);
 
-    LP_METHOD(void solve())
+    // Simplex iterations and time used by the last call to solve().
+    int get_num_iterations() const {
+        return last_num_iterations;
+    }
+    double get_solve_time() const {
+        return last_solve_time;
+    }
 
     /*
       Return true if the solving the LP showed that it is bounded feasible and
@@ -134,14 +144,14 @@ public:
       solutions due to numerical difficulties.
       The LP has to be solved with a call to solve() before calling this method.
     */
-    LP_METHOD(bool has_optimal_solution() const)
+    bool has_optimal_solution() const;
 
     /*
       Return the objective value found after solving an LP.
       The LP has to be solved with a call to solve() and has to have an optimal
       solution before calling this method.
     */
-    LP_METHOD(double get_objective_value() const)
+    double get_objective_value() const;
 
     /*
       Return the solution found after solving an LP as a vector with one entry
@@ -149,16 +159,13 @@ public:
       The LP has to be solved with a call to solve() and has to have an optimal
       solution before calling this method.
     */
-    LP_METHOD(std::vector<double> extract_solution() const)
+    std::vector<double> extract_solution() const;
 
-    LP_METHOD(int get_num_variables() const)
-    LP_METHOD(int get_num_constraints() const)
-    LP_METHOD(int has_temporary_constraints() const)
-    LP_METHOD(void print_statistics() const)
+    int get_num_variables() const;
+    int get_num_constraints() const;
+    bool has_temporary_constraints() const;
+    void print_statistics() const;
 };
-#ifdef __GNUG__
-#pragma GCC diagnostic pop
-#endif
 }
 
 #endif
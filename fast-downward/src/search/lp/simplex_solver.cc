@@ -0,0 +1,890 @@
+#include "simplex_solver.h"
+
+#include "lp_solver.h"
+
+#include "../utils/system.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <limits>
+
+using namespace std;
+using utils::ExitCode;
+
+namespace lp {
+static const double PRIMAL_TOLERANCE = 1e-7;
+static const double DUAL_TOLERANCE = 1e-7;
+static const double PIVOT_TOLERANCE = 1e-9;
+// Eta entries below this value are dropped.
+static const double DROP_TOLERANCE = 1e-13;
+/*
+  Compute the pivot row row-wise if at most this fraction of the entries
+  of the btran'ed unit vector is nonzero and column-wise otherwise.
+*/
+static const double MAX_ROW_WISE_PRICING_DENSITY = 0.1;
+static const int REFACTOR_FREQUENCY = 100;
+// Use Bland's rule after this many consecutive degenerate primal steps.
+static const int MAX_DEGENERATE_STEPS = 50;
+
+static BasisStatus get_constraint_status(BasisStatus logical_status) {
+    // The logical variable of a constraint is the negated activity.
+    if (logical_status == BasisStatus::AT_LOWER)
+        return BasisStatus::AT_UPPER;
+    else if (logical_status == BasisStatus::AT_UPPER)
+        return BasisStatus::AT_LOWER;
+    return logical_status;
+}
+
+SimplexSolver::SimplexSolver()
+    : infinity(numeric_limits<double>::infinity()),
+      is_maximization(false),
+      num_cols(0),
+      num_rows(0),
+      num_permanent_rows(0),
+      columns_are_outdated(true),
+      num_pivots_since_refactor(0),
+      result(Result::UNSOLVED),
+      num_iterations(0),
+      max_iterations(0) {
+}
+
+void SimplexSolver::load_problem(
+    LPObjectiveSense sense,
+    const vector<LPVariable> &variables,
+    const vector<LPConstraint> &constraints) {
+    is_maximization = (sense == LPObjectiveSense::MAXIMIZE);
+    num_cols = variables.size();
+    num_rows = 0;
+    num_permanent_rows = constraints.size();
+
+    objective.clear();
+    lower.clear();
+    upper.clear();
+    cost.clear();
+    status.clear();
+    value.clear();
+    for (const LPVariable &var : variables) {
+        objective.push_back(var.objective_coefficient);
+        lower.push_back(var.lower_bound);
+        upper.push_back(var.upper_bound);
+        cost.push_back(is_maximization ? -var.objective_coefficient
+                       : var.objective_coefficient);
+        status.push_back(BasisStatus::AT_LOWER);
+        value.push_back(0);
+    }
+    for (int var = 0; var < num_cols; ++var) {
+        set_nonbasic_status(var);
+    }
+
+    row_starts.assign(1, 0);
+    row_cols.clear();
+    row_coefficients.clear();
+    add_rows(constraints);
+    result = Result::UNSOLVED;
+}
+
+void SimplexSolver::add_rows(const vector<LPConstraint> &constraints) {
+    for (const LPConstraint &constraint : constraints) {
+        const vector<int> &vars = constraint.get_variables();
+        const vector<double> &coeffs = constraint.get_coefficients();
+        row_cols.insert(row_cols.end(), vars.begin(), vars.end());
+        row_coefficients.insert(row_coefficients.end(), coeffs.begin(), coeffs.end());
+        row_starts.push_back(row_cols.size());
+
+        lower.push_back(-constraint.get_upper_bound());
+        upper.push_back(-constraint.get_lower_bound());
+        cost.push_back(0);
+        status.push_back(BasisStatus::BASIC);
+        value.push_back(0);
+        ++num_rows;
+    }
+    columns_are_outdated = true;
+}
+
+void SimplexSolver::add_temporary_constraints(
+    const vector<LPConstraint> &constraints) {
+    add_rows(constraints);
+    result = Result::UNSOLVED;
+}
+
+void SimplexSolver::clear_temporary_constraints() {
+    if (has_temporary_constraints()) {
+        num_rows = num_permanent_rows;
+        row_starts.resize(num_rows + 1);
+        row_cols.resize(row_starts.back());
+        row_coefficients.resize(row_starts.back());
+        int num_vars = get_num_vars();
+        lower.resize(num_vars);
+        upper.resize(num_vars);
+        cost.resize(num_vars);
+        status.resize(num_vars);
+        value.resize(num_vars);
+        columns_are_outdated = true;
+        result = Result::UNSOLVED;
+    }
+}
+
+double SimplexSolver::get_infinity() const {
+    return infinity;
+}
+
+void SimplexSolver::set_objective_coefficients(const vector<double> &coefficients) {
+    for (int var = 0; var < num_cols; ++var) {
+        set_objective_coefficient(var, coefficients[var]);
+    }
+}
+
+void SimplexSolver::set_objective_coefficient(int index, double coefficient) {
+    objective[index] = coefficient;
+    cost[index] = is_maximization ? -coefficient : coefficient;
+    result = Result::UNSOLVED;
+}
+
+void SimplexSolver::set_constraint_lower_bound(int index, double bound) {
+    upper[num_cols + index] = -bound;
+    result = Result::UNSOLVED;
+}
+
+void SimplexSolver::set_constraint_upper_bound(int index, double bound) {
+    lower[num_cols + index] = -bound;
+    result = Result::UNSOLVED;
+}
+
+void SimplexSolver::set_variable_lower_bound(int index, double bound) {
+    lower[index] = bound;
+    result = Result::UNSOLVED;
+}
+
+void SimplexSolver::set_variable_upper_bound(int index, double bound) {
+    upper[index] = bound;
+    result = Result::UNSOLVED;
+}
+
+void SimplexSolver::build_columns() {
+    col_starts.assign(num_cols + 1, 0);
+    for (int col : row_cols) {
+        ++col_starts[col + 1];
+    }
+    for (int col = 0; col < num_cols; ++col) {
+        col_starts[col + 1] += col_starts[col];
+    }
+    col_rows.resize(row_cols.size());
+    col_coefficients.resize(row_cols.size());
+    vector<int> next_entry(col_starts.begin(), col_starts.end() - 1);
+    for (int row_id = 0; row_id < num_rows; ++row_id) {
+        for (int i = row_starts[row_id]; i < row_starts[row_id + 1]; ++i) {
+            int entry = next_entry[row_cols[i]]++;
+            col_rows[entry] = row_id;
+            col_coefficients[entry] = row_coefficients[i];
+        }
+    }
+    columns_are_outdated = false;
+}
+
+/*
+  Make the variable nonbasic at its bound closest to its current value.
+*/
+void SimplexSolver::set_nonbasic_status(int var) {
+    bool has_lower = lower[var] > -infinity;
+    bool has_upper = upper[var] < infinity;
+    if (has_lower && has_upper) {
+        if (value[var] - lower[var] <= upper[var] - value[var]) {
+            status[var] = BasisStatus::AT_LOWER;
+            value[var] = lower[var];
+        } else {
+            status[var] = BasisStatus::AT_UPPER;
+            value[var] = upper[var];
+        }
+    } else if (has_lower) {
+        status[var] = BasisStatus::AT_LOWER;
+        value[var] = lower[var];
+    } else if (has_upper) {
+        status[var] = BasisStatus::AT_UPPER;
+        value[var] = upper[var];
+    } else {
+        status[var] = BasisStatus::FREE;
+        value[var] = 0;
+    }
+}
+
+/*
+  Bounds may have changed since the last solve. Move nonbasic variables
+  to their (new) bounds.
+*/
+void SimplexSolver::synchronize_nonbasic_values() {
+    int num_vars = get_num_vars();
+    for (int var = 0; var < num_vars; ++var) {
+        switch (status[var]) {
+        case BasisStatus::BASIC:
+            break;
+        case BasisStatus::AT_LOWER:
+            if (lower[var] > -infinity)
+                value[var] = lower[var];
+            else
+                set_nonbasic_status(var);
+            break;
+        case BasisStatus::AT_UPPER:
+            if (upper[var] < infinity)
+                value[var] = upper[var];
+            else
+                set_nonbasic_status(var);
+            break;
+        case BasisStatus::FREE:
+            set_nonbasic_status(var);
+            break;
+        }
+    }
+}
+
+void SimplexSolver::load_column(int var, vector<double> &vec) const {
+    fill(vec.begin(), vec.end(), 0);
+    if (is_logical(var)) {
+        vec[var - num_cols] = 1;
+    } else {
+        for (int i = col_starts[var]; i < col_starts[var + 1]; ++i) {
+            vec[col_rows[i]] = col_coefficients[i];
+        }
+    }
+}
+
+double SimplexSolver::dot_column(int var, const vector<double> &vec) const {
+    if (is_logical(var))
+        return vec[var - num_cols];
+    double result = 0;
+    for (int i = col_starts[var]; i < col_starts[var + 1]; ++i) {
+        result += col_coefficients[i] * vec[col_rows[i]];
+    }
+    return result;
+}
+
+// Compute B^-1 vec.
+void SimplexSolver::ftran(vector<double> &vec) const {
+    int num_etas = eta_pivots.size();
+    for (int eta = 0; eta < num_etas; ++eta) {
+        int pivot_row = eta_pivots[eta];
+        double pivot_value = vec[pivot_row];
+        if (pivot_value == 0)
+            continue;
+        int start = eta_starts[eta];
+        vec[pivot_row] = eta_values[start] * pivot_value;
+        for (int i = start + 1; i < eta_starts[eta + 1]; ++i) {
+            vec[eta_rows[i]] += eta_values[i] * pivot_value;
+        }
+    }
+}
+
+// Compute vec^T B^-1.
+void SimplexSolver::btran(vector<double> &vec) const {
+    for (int eta = eta_pivots.size() - 1; eta >= 0; --eta) {
+        double sum = 0;
+        for (int i = eta_starts[eta]; i < eta_starts[eta + 1]; ++i) {
+            sum += eta_values[i] * vec[eta_rows[i]];
+        }
+        vec[eta_pivots[eta]] = sum;
+    }
+}
+
+void SimplexSolver::add_to_pivot_row(int var, double alpha) {
+    if (status[var] == BasisStatus::BASIC)
+        return;
+    if (!is_in_pivot_row[var]) {
+        is_in_pivot_row[var] = true;
+        pivot_row_vars.push_back(var);
+    }
+    pivot_row[var] += alpha;
+}
+
+/*
+  Compute the entries of row^T B^-1 A for all nonbasic variables, where
+  row already holds e_r^T B^-1. If this vector is sparse, which is the
+  common case, we only visit the constraint rows with nonzero entries.
+  Otherwise, we compute the dot product with every nonbasic column.
+*/
+void SimplexSolver::compute_pivot_row() {
+    for (int var : pivot_row_vars) {
+        pivot_row[var] = 0;
+        is_in_pivot_row[var] = false;
+    }
+    pivot_row_vars.clear();
+
+    int num_nonzeros = count_if(row.begin(), row.end(), [](double entry) {
+                                    return entry != 0;
+                                });
+    if (num_nonzeros <= MAX_ROW_WISE_PRICING_DENSITY * num_rows) {
+        for (int row_id = 0; row_id < num_rows; ++row_id) {
+            double multiplier = row[row_id];
+            if (multiplier == 0)
+                continue;
+            add_to_pivot_row(num_cols + row_id, multiplier);
+            for (int i = row_starts[row_id]; i < row_starts[row_id + 1]; ++i) {
+                add_to_pivot_row(row_cols[i], multiplier * row_coefficients[i]);
+            }
+        }
+    } else {
+        int num_vars = get_num_vars();
+        for (int var = 0; var < num_vars; ++var) {
+            if (status[var] == BasisStatus::BASIC)
+                continue;
+            double alpha = dot_column(var, row);
+            if (alpha != 0)
+                add_to_pivot_row(var, alpha);
+        }
+    }
+}
+
+/*
+  Replace the basis column in position pivot by the column whose
+  representation in the current basis is alpha.
+*/
+void SimplexSolver::add_eta(int pivot, const vector<double> &alpha) {
+    double pivot_value = alpha[pivot];
+    assert(fabs(pivot_value) >= PIVOT_TOLERANCE);
+    eta_pivots.push_back(pivot);
+    eta_rows.push_back(pivot);
+    eta_values.push_back(1 / pivot_value);
+    for (int row_id = 0; row_id < num_rows; ++row_id) {
+        if (row_id != pivot && fabs(alpha[row_id]) > DROP_TOLERANCE) {
+            eta_rows.push_back(row_id);
+            eta_values.push_back(-alpha[row_id] / pivot_value);
+        }
+    }
+    eta_starts.push_back(eta_rows.size());
+}
+
+/*
+  Compute the product form of the basis inverse from scratch. Basic
+  logicals stay in the position of their row. Basic structurals are
+  pivoted into the remaining positions, sparsest column first, each
+  into the free position with the largest entry. Structurals without
+  a suitable position (because the basis is singular or has too many
+  columns) become nonbasic and free positions are filled with logicals.
+*/
+void SimplexSolver::refactor() {
+    eta_pivots.clear();
+    eta_starts.assign(1, 0);
+    eta_rows.clear();
+    eta_values.clear();
+    num_pivots_since_refactor = 0;
+
+    basic_vars.assign(num_rows, -1);
+    vector<int> basic_structurals;
+    for (int var = 0; var < num_cols; ++var) {
+        if (status[var] == BasisStatus::BASIC)
+            basic_structurals.push_back(var);
+    }
+    for (int row_id = 0; row_id < num_rows; ++row_id) {
+        if (status[num_cols + row_id] == BasisStatus::BASIC)
+            basic_vars[row_id] = num_cols + row_id;
+    }
+    stable_sort(basic_structurals.begin(), basic_structurals.end(),
+                [this](int var1, int var2) {
+                    return col_starts[var1 + 1] - col_starts[var1] <
+                           col_starts[var2 + 1] - col_starts[var2];
+                });
+    for (int var : basic_structurals) {
+        load_column(var, column);
+        ftran(column);
+        int best_position = -1;
+        double best_value = PIVOT_TOLERANCE;
+        for (int position = 0; position < num_rows; ++position) {
+            if (basic_vars[position] == -1 && fabs(column[position]) > best_value) {
+                best_position = position;
+                best_value = fabs(column[position]);
+            }
+        }
+        if (best_position == -1) {
+            set_nonbasic_status(var);
+        } else {
+            add_eta(best_position, column);
+            basic_vars[best_position] = var;
+        }
+    }
+    for (int row_id = 0; row_id < num_rows; ++row_id) {
+        if (basic_vars[row_id] == -1) {
+            basic_vars[row_id] = num_cols + row_id;
+            status[num_cols + row_id] = BasisStatus::BASIC;
+        }
+    }
+}
+
+void SimplexSolver::pivot(int position, int entering, const vector<double> &alpha) {
+    add_eta(position, alpha);
+    basic_vars[position] = entering;
+    status[entering] = BasisStatus::BASIC;
+    ++num_pivots_since_refactor;
+    ++num_iterations;
+}
+
+double SimplexSolver::get_infeasibility(int var) const {
+    if (value[var] < lower[var])
+        return lower[var] - value[var];
+    else if (value[var] > upper[var])
+        return value[var] - upper[var];
+    return 0;
+}
+
+bool SimplexSolver::is_primal_feasible() const {
+    for (int var : basic_vars) {
+        if (get_infeasibility(var) > PRIMAL_TOLERANCE)
+            return false;
+    }
+    return true;
+}
+
+void SimplexSolver::compute_basic_values() {
+    fill(column.begin(), column.end(), 0);
+    int num_vars = get_num_vars();
+    for (int var = 0; var < num_vars; ++var) {
+        if (status[var] == BasisStatus::BASIC || value[var] == 0)
+            continue;
+        if (is_logical(var)) {
+            column[var - num_cols] -= value[var];
+        } else {
+            for (int i = col_starts[var]; i < col_starts[var + 1]; ++i) {
+                column[col_rows[i]] -= col_coefficients[i] * value[var];
+            }
+        }
+    }
+    ftran(column);
+    for (int position = 0; position < num_rows; ++position) {
+        value[basic_vars[position]] = column[position];
+    }
+}
+
+void SimplexSolver::compute_reduced_costs(const vector<double> &costs) {
+    for (int position = 0; position < num_rows; ++position) {
+        duals[position] = costs[basic_vars[position]];
+    }
+    btran(duals);
+    int num_vars = get_num_vars();
+    for (int var = 0; var < num_vars; ++var) {
+        if (status[var] == BasisStatus::BASIC)
+            reduced_costs[var] = 0;
+        else
+            reduced_costs[var] = costs[var] - dot_column(var, duals);
+    }
+}
+
+/*
+  Return true if the basis is dual feasible after moving boxed nonbasic
+  variables with the wrong sign of reduced costs to their other bound.
+*/
+bool SimplexSolver::make_dual_feasible() {
+    bool is_dual_feasible = true;
+    bool flipped = false;
+    int num_vars = get_num_vars();
+    for (int var = 0; var < num_vars; ++var) {
+        if (status[var] == BasisStatus::BASIC || lower[var] == upper[var])
+            continue;
+        double reduced_cost = reduced_costs[var];
+        if (status[var] == BasisStatus::AT_LOWER && reduced_cost < -DUAL_TOLERANCE) {
+            if (upper[var] < infinity) {
+                status[var] = BasisStatus::AT_UPPER;
+                value[var] = upper[var];
+                flipped = true;
+            } else {
+                is_dual_feasible = false;
+            }
+        } else if (status[var] == BasisStatus::AT_UPPER && reduced_cost > DUAL_TOLERANCE) {
+            if (lower[var] > -infinity) {
+                status[var] = BasisStatus::AT_LOWER;
+                value[var] = lower[var];
+                flipped = true;
+            } else {
+                is_dual_feasible = false;
+            }
+        } else if (status[var] == BasisStatus::FREE && fabs(reduced_cost) > DUAL_TOLERANCE) {
+            is_dual_feasible = false;
+        }
+    }
+    if (flipped)
+        compute_basic_values();
+    return is_dual_feasible;
+}
+
+/*
+  Dual simplex for a dual feasible basis. The leaving variable is the
+  basic variable with the largest bound violation, the entering
+  variable is chosen with Harris' two-pass ratio test. Both passes and
+  the update of the reduced costs only visit the nonzero entries of the
+  pivot row.
+*/
+SimplexSolver::Result SimplexSolver::run_dual_simplex() {
+    while (true) {
+        if (num_iterations >= max_iterations)
+            return Result::ITERATION_LIMIT;
+        if (num_pivots_since_refactor >= REFACTOR_FREQUENCY)
+            return Result::UNSOLVED;
+
+        int leaving_position = -1;
+        double max_infeasibility = PRIMAL_TOLERANCE;
+        for (int position = 0; position < num_rows; ++position) {
+            double infeasibility = get_infeasibility(basic_vars[position]);
+            if (infeasibility > max_infeasibility) {
+                leaving_position = position;
+                max_infeasibility = infeasibility;
+            }
+        }
+        if (leaving_position == -1)
+            return Result::OPTIMAL;
+        int leaving = basic_vars[leaving_position];
+        bool leaves_at_lower = value[leaving] < lower[leaving];
+
+        fill(row.begin(), row.end(), 0);
+        row[leaving_position] = 1;
+        btran(row);
+        compute_pivot_row();
+
+        // The leaving variable increases if it leaves at its lower bound.
+        double max_ratio = infinity;
+        for (int var : pivot_row_vars) {
+            double alpha = pivot_row[var];
+            if (lower[var] == upper[var])
+                continue;
+            double directed_alpha = leaves_at_lower ? -alpha : alpha;
+            double reduced_cost = reduced_costs[var];
+            if (status[var] == BasisStatus::AT_LOWER && directed_alpha > PIVOT_TOLERANCE) {
+                max_ratio = min(max_ratio, (reduced_cost + DUAL_TOLERANCE) / fabs(alpha));
+            } else if (status[var] == BasisStatus::AT_UPPER &&
+                       directed_alpha < -PIVOT_TOLERANCE) {
+                max_ratio = min(max_ratio, (-reduced_cost + DUAL_TOLERANCE) / fabs(alpha));
+            } else if (status[var] == BasisStatus::FREE && fabs(alpha) > PIVOT_TOLERANCE) {
+                max_ratio = min(max_ratio, (fabs(reduced_cost) + DUAL_TOLERANCE) / fabs(alpha));
+            }
+        }
+        if (max_ratio == infinity)
+            return Result::INFEASIBLE;
+
+        int entering = -1;
+        double max_alpha = 0;
+        for (int var : pivot_row_vars) {
+            if (lower[var] == upper[var])
+                continue;
+            double alpha = pivot_row[var];
+            double directed_alpha = leaves_at_lower ? -alpha : alpha;
+            double ratio;
+            if (status[var] == BasisStatus::AT_LOWER && directed_alpha > PIVOT_TOLERANCE)
+                ratio = reduced_costs[var] / fabs(alpha);
+            else if (status[var] == BasisStatus::AT_UPPER && directed_alpha < -PIVOT_TOLERANCE)
+                ratio = -reduced_costs[var] / fabs(alpha);
+            else if (status[var] == BasisStatus::FREE && fabs(alpha) > PIVOT_TOLERANCE)
+                ratio = fabs(reduced_costs[var]) / fabs(alpha);
+            else
+                continue;
+            /*
+              The pivot row lists its variables in the order in which
+              pricing reached them. Break ties by the variable index so
+              that the choice does not depend on this order.
+            */
+            if (ratio <= max_ratio && (fabs(alpha) > max_alpha ||
+                                       (fabs(alpha) == max_alpha && var < entering))) {
+                entering = var;
+                max_alpha = fabs(alpha);
+            }
+        }
+        assert(entering != -1);
+
+        load_column(entering, column);
+        ftran(column);
+        double pivot_value = column[leaving_position];
+        if (fabs(pivot_value) < PIVOT_TOLERANCE) {
+            // The column and the row disagree. Refactor and try again.
+            return Result::UNSOLVED;
+        }
+
+        double dual_step = reduced_costs[entering] / pivot_row[entering];
+        for (int var : pivot_row_vars) {
+            reduced_costs[var] -= dual_step * pivot_row[var];
+        }
+        reduced_costs[entering] = 0;
+        reduced_costs[leaving] = -dual_step;
+
+        double target = leaves_at_lower ? lower[leaving] : upper[leaving];
+        double primal_step = (value[leaving] - target) / pivot_value;
+        for (int position = 0; position < num_rows; ++position) {
+            value[basic_vars[position]] -= column[position] * primal_step;
+        }
+        value[entering] += primal_step;
+        value[leaving] = target;
+        status[leaving] = leaves_at_lower ? BasisStatus::AT_LOWER : BasisStatus::AT_UPPER;
+        pivot(leaving_position, entering, column);
+    }
+}
+
+/*
+  Primal simplex with Dantzig's pricing rule. While the basis is
+  infeasible, we minimize the sum of infeasibilities (phase 1), after
+  that the objective (phase 2). The ratio test stops at the first
+  breakpoint, i.e., where a basic variable reaches one of its bounds.
+*/
+SimplexSolver::Result SimplexSolver::run_primal_simplex() {
+    int num_vars = get_num_vars();
+    int num_degenerate_steps = 0;
+    vector<double> phase_one_costs;
+    while (true) {
+        if (num_iterations >= max_iterations)
+            return Result::ITERATION_LIMIT;
+        if (num_pivots_since_refactor >= REFACTOR_FREQUENCY)
+            return Result::UNSOLVED;
+
+        bool is_phase_one = !is_primal_feasible();
+        if (is_phase_one) {
+            phase_one_costs.assign(num_vars, 0);
+            for (int var : basic_vars) {
+                if (value[var] < lower[var] - PRIMAL_TOLERANCE)
+                    phase_one_costs[var] = -1;
+                else if (value[var] > upper[var] + PRIMAL_TOLERANCE)
+                    phase_one_costs[var] = 1;
+            }
+            compute_reduced_costs(phase_one_costs);
+        } else {
+            compute_reduced_costs(cost);
+        }
+
+        bool use_blands_rule = num_degenerate_steps > MAX_DEGENERATE_STEPS;
+        int entering = -1;
+        double max_reduced_cost = DUAL_TOLERANCE;
+        for (int var = 0; var < num_vars; ++var) {
+            if (status[var] == BasisStatus::BASIC || lower[var] == upper[var])
+                continue;
+            double reduced_cost = reduced_costs[var];
+            bool improves =
+                (status[var] == BasisStatus::AT_LOWER && reduced_cost < -DUAL_TOLERANCE) ||
+                (status[var] == BasisStatus::AT_UPPER && reduced_cost > DUAL_TOLERANCE) ||
+                (status[var] == BasisStatus::FREE && fabs(reduced_cost) > DUAL_TOLERANCE);
+            if (improves && fabs(reduced_cost) > max_reduced_cost) {
+                entering = var;
+                max_reduced_cost = fabs(reduced_cost);
+                if (use_blands_rule)
+                    break;
+            }
+        }
+        if (entering == -1)
+            return is_phase_one ? Result::INFEASIBLE : Result::OPTIMAL;
+        double direction = (reduced_costs[entering] < 0) ? 1 : -1;
+
+        load_column(entering, column);
+        ftran(column);
+
+        /*
+          Harris' ratio test: find the largest step that violates no
+          bound by more than the tolerance, then choose the blocking
+          variable with the largest pivot element within this step.
+        */
+        double max_step = infinity;
+        for (int position = 0; position < num_rows; ++position) {
+            double alpha = column[position];
+            if (fabs(alpha) < PIVOT_TOLERANCE)
+                continue;
+            int var = basic_vars[position];
+            double rate = -alpha * direction;
+            if (rate < 0) {
+                if (value[var] > upper[var] + PRIMAL_TOLERANCE)
+                    max_step = min(max_step, (value[var] - upper[var] + PRIMAL_TOLERANCE) / -rate);
+                else if (lower[var] > -infinity && value[var] >= lower[var] - PRIMAL_TOLERANCE)
+                    max_step = min(max_step, (value[var] - lower[var] + PRIMAL_TOLERANCE) / -rate);
+            } else {
+                if (value[var] < lower[var] - PRIMAL_TOLERANCE)
+                    max_step = min(max_step, (lower[var] - value[var] + PRIMAL_TOLERANCE) / rate);
+                else if (upper[var] < infinity && value[var] <= upper[var] + PRIMAL_TOLERANCE)
+                    max_step = min(max_step, (upper[var] - value[var] + PRIMAL_TOLERANCE) / rate);
+            }
+        }
+
+        int leaving_position = -1;
+        double leaving_target = 0;
+        double step = infinity;
+        double max_alpha = 0;
+        for (int position = 0; position < num_rows; ++position) {
+            double alpha = column[position];
+            if (fabs(alpha) < PIVOT_TOLERANCE)
+                continue;
+            int var = basic_vars[position];
+            double rate = -alpha * direction;
+            double target;
+            if (rate < 0) {
+                if (value[var] > upper[var] + PRIMAL_TOLERANCE)
+                    target = upper[var];
+                else if (lower[var] > -infinity && value[var] >= lower[var] - PRIMAL_TOLERANCE)
+                    target = lower[var];
+                else
+                    continue;
+            } else {
+                if (value[var] < lower[var] - PRIMAL_TOLERANCE)
+                    target = lower[var];
+                else if (upper[var] < infinity && value[var] <= upper[var] + PRIMAL_TOLERANCE)
+                    target = upper[var];
+                else
+                    continue;
+            }
+            double var_step = max(0.0, (target - value[var]) / rate);
+            if (var_step <= max_step &&
+                (use_blands_rule ? (leaving_position == -1 ||
+                                    var < basic_vars[leaving_position])
+                 : fabs(alpha) > max_alpha)) {
+                leaving_position = position;
+                leaving_target = target;
+                step = var_step;
+                max_alpha = fabs(alpha);
+            }
+        }
+
+        double bound_flip_step = upper[entering] - lower[entering];
+        if (leaving_position == -1 && bound_flip_step == infinity) {
+            if (is_phase_one) {
+                // Only possible due to numerical errors.
+                return Result::UNSOLVED;
+            }
+            return Result::UNBOUNDED;
+        }
+
+        if (bound_flip_step <= step) {
+            for (int position = 0; position < num_rows; ++position) {
+                value[basic_vars[position]] -= column[position] * direction * bound_flip_step;
+            }
+            if (status[entering] == BasisStatus::AT_LOWER) {
+                status[entering] = BasisStatus::AT_UPPER;
+                value[entering] = upper[entering];
+            } else {
+                status[entering] = BasisStatus::AT_LOWER;
+                value[entering] = lower[entering];
+            }
+            num_degenerate_steps = 0;
+            ++num_iterations;
+            continue;
+        }
+
+        for (int position = 0; position < num_rows; ++position) {
+            value[basic_vars[position]] -= column[position] * direction * step;
+        }
+        value[entering] += direction * step;
+        int leaving = basic_vars[leaving_position];
+        value[leaving] = leaving_target;
+        if (leaving_target == lower[leaving])
+            status[leaving] = BasisStatus::AT_LOWER;
+        else
+            status[leaving] = BasisStatus::AT_UPPER;
+        pivot(leaving_position, entering, column);
+
+        if (step < PRIMAL_TOLERANCE)
+            ++num_degenerate_steps;
+        else
+            num_degenerate_steps = 0;
+    }
+}
+
+void SimplexSolver::solve() {
+    if (columns_are_outdated)
+        build_columns();
+    int num_vars = get_num_vars();
+    column.resize(num_rows);
+    row.resize(num_rows);
+    duals.resize(num_rows);
+    reduced_costs.resize(num_vars);
+    pivot_row.assign(num_vars, 0);
+    pivot_row_vars.clear();
+    is_in_pivot_row.assign(num_vars, false);
+    num_iterations = 0;
+    max_iterations = max(100000, 20 * num_vars);
+    synchronize_nonbasic_values();
+
+    /*
+      Each round refactors the basis, recomputes all values from
+      scratch and continues with the simplex variant that fits the
+      basis. Optimality reported by a round is confirmed by the next.
+    */
+    result = Result::UNSOLVED;
+    int num_rounds_without_progress = 0;
+    while (result == Result::UNSOLVED) {
+        refactor();
+        compute_basic_values();
+        compute_reduced_costs(cost);
+        bool is_dual_feasible = make_dual_feasible();
+        if (is_dual_feasible && is_primal_feasible()) {
+            result = Result::OPTIMAL;
+            break;
+        }
+
+        int num_iterations_before = num_iterations;
+        Result round_result = is_dual_feasible ? run_dual_simplex()
+            : run_primal_simplex();
+        if (round_result == Result::INFEASIBLE ||
+            round_result == Result::UNBOUNDED ||
+            round_result == Result::ITERATION_LIMIT) {
+            result = round_result;
+        } else if (num_iterations == num_iterations_before &&
+                   ++num_rounds_without_progress > 3) {
+            result = Result::ITERATION_LIMIT;
+        } else if (num_iterations != num_iterations_before) {
+            num_rounds_without_progress = 0;
+        }
+    }
+
+    if (result == Result::ITERATION_LIMIT) {
+        cerr << "Abandoned LP after " << num_iterations << " iterations. "
+             << "Reasons include \"numerical difficulties\" and cycling." << endl;
+        utils::exit_with(ExitCode::SEARCH_CRITICAL_ERROR);
+    }
+}
+
+bool SimplexSolver::has_optimal_solution() const {
+    assert(result != Result::UNSOLVED);
+    return result == Result::OPTIMAL;
+}
+
+double SimplexSolver::get_objective_value() const {
+    assert(has_optimal_solution());
+    double objective_value = 0;
+    for (int var = 0; var < num_cols; ++var) {
+        objective_value += objective[var] * value[var];
+    }
+    return objective_value;
+}
+
+vector<double> SimplexSolver::extract_solution() const {
+    assert(has_optimal_solution());
+    return vector<double>(value.begin(), value.begin() + num_cols);
+}
+
+void SimplexSolver::get_basis(LPBasis &basis) const {
+    basis.variable_status.assign(status.begin(), status.begin() + num_cols);
+    basis.constraint_status.resize(num_rows);
+    for (int row_id = 0; row_id < num_rows; ++row_id) {
+        basis.constraint_status[row_id] =
+            get_constraint_status(status[num_cols + row_id]);
+    }
+}
+
+void SimplexSolver::set_basis(const LPBasis &basis) {
+    int num_known_cols = min<int>(num_cols, basis.variable_status.size());
+    for (int var = 0; var < num_known_cols; ++var) {
+        status[var] = basis.variable_status[var];
+    }
+    int num_known_rows = min<int>(num_rows, basis.constraint_status.size());
+    for (int row_id = 0; row_id < num_rows; ++row_id) {
+        BasisStatus row_status = BasisStatus::BASIC;
+        if (row_id < num_known_rows)
+            row_status = get_constraint_status(basis.constraint_status[row_id]);
+        status[num_cols + row_id] = row_status;
+    }
+    result = Result::UNSOLVED;
+}
+
+int SimplexSolver::get_num_variables() const {
+    return num_cols;
+}
+
+int SimplexSolver::get_num_constraints() const {
+    return num_rows;
+}
+
+bool SimplexSolver::has_temporary_constraints() const {
+    return num_rows > num_permanent_rows;
+}
+
+int SimplexSolver::get_num_iterations() const {
+    return num_iterations;
+}
+}
@@ -0,0 +1,150 @@
+#ifndef LP_SIMPLEX_SOLVER_H
+#define LP_SIMPLEX_SOLVER_H
+
+#include "solver_interface.h"
+
+#include <vector>
+
+namespace lp {
+enum class BasisStatus;
+
+/*
+  Dependency-free LP solver based on the bounded revised simplex method.
+
+  Every constraint lb <= a^T x <= ub is turned into the equation
+  a^T x + s = 0 with a logical variable s in [-ub, -lb], so the
+  constraint matrix is [A | I] and the slack basis is the identity.
+  The constraint matrix is stored sparsely by rows and by columns. The
+  basis inverse is kept in product form: each pivot appends an "eta"
+  column and the product is recomputed from the slack basis at the
+  start of each solve and after a fixed number of pivots.
+
+  solve() starts from the basis of the previous solve (or the one
+  passed to set_basis()). It runs the dual simplex if that basis is
+  dual feasible, after flipping boxed variables to their other bound
+  where this helps, and the primal simplex with a composite phase 1
+  otherwise. LPs in which only bounds change between solves, like
+  those of operator-counting heuristics with non-negative costs, stay
+  dual feasible and typically need few dual iterations.
+*/
+class SimplexSolver : public SolverInterface {
+    enum class Result {
+        UNSOLVED, OPTIMAL, INFEASIBLE, UNBOUNDED, ITERATION_LIMIT
+    };
+
+    const double infinity;
+    bool is_maximization;
+
+    int num_cols;
+    int num_rows;
+    int num_permanent_rows;
+
+    // Structural variables come first, then one logical per row.
+    std::vector<double> objective;
+    std::vector<double> lower;
+    std::vector<double> upper;
+    std::vector<double> cost;
+    std::vector<BasisStatus> status;
+    std::vector<double> value;
+
+    // Constraint matrix by rows and (rebuilt when rows change) by columns.
+    std::vector<int> row_starts;
+    std::vector<int> row_cols;
+    std::vector<double> row_coefficients;
+    bool columns_are_outdated;
+    std::vector<int> col_starts;
+    std::vector<int> col_rows;
+    std::vector<double> col_coefficients;
+
+    // basic_vars[p] is the variable in position p of the basis.
+    std::vector<int> basic_vars;
+    // Eta columns of the basis inverse. The pivot entry comes first.
+    std::vector<int> eta_pivots;
+    std::vector<int> eta_starts;
+    std::vector<int> eta_rows;
+    std::vector<double> eta_values;
+    int num_pivots_since_refactor;
+
+    std::vector<double> reduced_costs;
+    Result result;
+    int num_iterations;
+    int max_iterations;
+
+    // Scratch vectors of size num_rows.
+    std::vector<double> column;
+    std::vector<double> row;
+    std::vector<double> duals;
+    /*
+      Entries of the pivot row for the nonbasic variables. Only the
+      entries of the variables in pivot_row_vars are nonzero.
+    */
+    std::vector<double> pivot_row;
+    std::vector<int> pivot_row_vars;
+    std::vector<bool> is_in_pivot_row;
+
+    int get_num_vars() const {
+        return num_cols + num_rows;
+    }
+    bool is_logical(int var) const {
+        return var >= num_cols;
+    }
+
+    void add_rows(const std::vector<LPConstraint> &constraints);
+    void build_columns();
+    void set_nonbasic_status(int var);
+    void synchronize_nonbasic_values();
+
+    void load_column(int var, std::vector<double> &vec) const;
+    double dot_column(int var, const std::vector<double> &vec) const;
+    void ftran(std::vector<double> &vec) const;
+    void btran(std::vector<double> &vec) const;
+    void add_to_pivot_row(int var, double alpha);
+    void compute_pivot_row();
+    void add_eta(int pivot, const std::vector<double> &alpha);
+    void refactor();
+    void pivot(int position, int entering, const std::vector<double> &alpha);
+
+    double get_infeasibility(int var) const;
+    bool is_primal_feasible() const;
+    void compute_basic_values();
+    void compute_reduced_costs(const std::vector<double> &costs);
+    bool make_dual_feasible();
+
+    Result run_dual_simplex();
+    Result run_primal_simplex();
+public:
+    SimplexSolver();
+
+    virtual void load_problem(
+        LPObjectiveSense sense,
+        const std::vector<LPVariable> &variables,
+        const std::vector<LPConstraint> &constraints) override;
+    virtual void add_temporary_constraints(
+        const std::vector<LPConstraint> &constraints) override;
+    virtual void clear_temporary_constraints() override;
+    virtual double get_infinity() const override;
+
+    virtual void set_objective_coefficients(
+        const std::vector<double> &coefficients) override;
+    virtual void set_objective_coefficient(int index, double coefficient) override;
+    virtual void set_constraint_lower_bound(int index, double bound) override;
+    virtual void set_constraint_upper_bound(int index, double bound) override;
+    virtual void set_variable_lower_bound(int index, double bound) override;
+    virtual void set_variable_upper_bound(int index, double bound) override;
+
+    virtual void solve() override;
+    virtual bool has_optimal_solution() const override;
+    virtual double get_objective_value() const override;
+    virtual std::vector<double> extract_solution() const override;
+
+    virtual void get_basis(LPBasis &basis) const override;
+    virtual void set_basis(const LPBasis &basis) override;
+
+    virtual int get_num_variables() const override;
+    virtual int get_num_constraints() const override;
+    virtual bool has_temporary_constraints() const override;
+    virtual int get_num_iterations() const override;
+};
+}
+
+#endif
@@ -0,0 +1,53 @@
+#ifndef LP_SOLVER_INTERFACE_H
+#define LP_SOLVER_INTERFACE_H
+
+#include <vector>
+
+namespace lp {
+class LPConstraint;
+struct LPBasis;
+struct LPVariable;
+enum class LPObjectiveSense;
+
+/*
+  Interface for the backends of LPSolver. See lp_solver.h for the
+  documentation of the methods.
+*/
+class SolverInterface {
+public:
+    virtual ~SolverInterface() = default;
+
+    virtual void load_problem(
+        LPObjectiveSense sense,
+        const std::vector<LPVariable> &variables,
+        const std::vector<LPConstraint> &constraints) = 0;
+    virtual void add_temporary_constraints(
+        const std::vector<LPConstraint> &constraints) = 0;
+    virtual void clear_temporary_constraints() = 0;
+    virtual double get_infinity() const = 0;
+
+    virtual void set_objective_coefficients(
+        const std::vector<double> &coefficients) = 0;
+    virtual void set_objective_coefficient(int index, double coefficient) = 0;
+    virtual void set_constraint_lower_bound(int index, double bound) = 0;
+    virtual void set_constraint_upper_bound(int index, double bound) = 0;
+    virtual void set_variable_lower_bound(int index, double bound) = 0;
+    virtual void set_variable_upper_bound(int index, double bound) = 0;
+
+    virtual void solve() = 0;
+    virtual bool has_optimal_solution() const = 0;
+    virtual double get_objective_value() const = 0;
+    virtual std::vector<double> extract_solution() const = 0;
+
+    virtual void get_basis(LPBasis &basis) const = 0;
+    virtual void set_basis(const LPBasis &basis) = 0;
+
+    virtual int get_num_variables() const = 0;
+    virtual int get_num_constraints() const = 0;
+    virtual bool has_temporary_constraints() const = 0;
+    // Number of simplex iterations of the last call to solve().
+    virtual int get_num_iterations() const = 0;
+};
+}
+
+#endif
@@ -7,7 +7,6 @@
 #include "../utils/logging.h"
 
 #include <cassert>
-#include <deque>
 
 using namespace std;
 
@@ -47,60 +46,71 @@ bool Distances::is_unit_cost() const {
     return true;
 }
 
-static void breadth_first_search(
-    const vector<vector<int>> &graph, deque<int> &queue,
-    vector<int> &distances) {
-    while (!queue.empty()) {
-        int state = queue.front();
-        queue.pop_front();
-        for (size_t i = 0; i < graph[state].size(); ++i) {
-            int successor = graph[state][i];
-            if (distances[successor] > distances[state] + 1) {
-                distances[successor] = distances[state] + 1;
-                queue.push_back(successor);
-            }
-        }
-    }
-}
-
-void Distances::compute_init_distances_unit_cost() {
-    vector<vector<int>> forward_graph(get_num_states());
+void Distances::build_adjacency(bool backward, bool with_costs) {
+    /*
+      Build the forward (backward) graph in compressed sparse row format:
+      the successors (predecessors) of state s are stored at positions
+      adjacency_offsets[s], ..., adjacency_offsets[s + 1] - 1 of
+      adjacency_states and, if needed, adjacency_costs.
+    */
+    int num_states = get_num_states();
+    adjacency_offsets.assign(num_states + 1, 0);
+    int num_transitions = 0;
     for (const GroupAndTransitions &gat : transition_system) {
-        const vector<Transition> &transitions = gat.transitions;
-        for (const Transition &transition : transitions) {
-            forward_graph[transition.src].push_back(transition.target);
+        for (const Transition &transition : gat.transitions) {
+            int state = backward ? transition.target : transition.src;
+            ++adjacency_offsets[state + 1];
         }
+        num_transitions += gat.transitions.size();
     }
+    for (int state = 0; state < num_states; ++state) {
+        adjacency_offsets[state + 1] += adjacency_offsets[state];
+    }
+    assert(adjacency_offsets[num_states] == num_transitions);
 
-    deque<int> queue;
-    queue.push_back(transition_system.get_init_state());
-    init_distances[transition_system.get_init_state()] = 0;
-    breadth_first_search(forward_graph, queue, init_distances);
-}
-
-void Distances::compute_goal_distances_unit_cost() {
-    vector<vector<int>> backward_graph(get_num_states());
+    adjacency_states.resize(num_transitions);
+    if (with_costs) {
+        adjacency_costs.resize(num_transitions);
+    }
+    /* We use adjacency_offsets[s] as the insertion position for state s,
+       which shifts all offsets by one position. This is undone below. */
     for (const GroupAndTransitions &gat : transition_system) {
-        const vector<Transition> &transitions = gat.transitions;
-        for (const Transition &transition : transitions) {
-            backward_graph[transition.target].push_back(transition.src);
+        int cost = gat.label_group.get_cost();
+        for (const Transition &transition : gat.transitions) {
+            int state = backward ? transition.target : transition.src;
+            int neighbor = backward ? transition.src : transition.target;
+            int pos = adjacency_offsets[state]++;
+            adjacency_states[pos] = neighbor;
+            if (with_costs) {
+                adjacency_costs[pos] = cost;
+            }
         }
     }
+    for (int state = num_states; state > 0; --state) {
+        adjacency_offsets[state] = adjacency_offsets[state - 1];
+    }
+    adjacency_offsets[0] = 0;
+}
 
-    deque<int> queue;
-    for (int state = 0; state < get_num_states(); ++state) {
-        if (transition_system.is_goal_state(state)) {
-            goal_distances[state] = 0;
-            queue.push_back(state);
+void Distances::breadth_first_search(vector<int> &distances) {
+    // fifo_queue contains the start states with distance 0.
+    for (size_t head = 0; head < fifo_queue.size(); ++head) {
+        int state = fifo_queue[head];
+        int successor_distance = distances[state] + 1;
+        for (int pos = adjacency_offsets[state];
+             pos < adjacency_offsets[state + 1]; ++pos) {
+            int successor = adjacency_states[pos];
+            if (distances[successor] > successor_distance) {
+                distances[successor] = successor_distance;
+                fifo_queue.push_back(successor);
+            }
         }
     }
-    breadth_first_search(backward_graph, queue, goal_distances);
+    fifo_queue.clear();
 }
 
-static void dijkstra_search(
-    const vector<vector<pair<int, int>>> &graph,
-    priority_queues::AdaptiveQueue<int> &queue,
-    vector<int> &distances) {
+void Distances::dijkstra_search(vector<int> &distances) {
+    // queue contains the start states with distance 0.
     while (!queue.empty()) {
         pair<int, int> top_pair = queue.pop();
         int distance = top_pair.first;
@@ -109,61 +119,51 @@ static void dijkstra_search(
         assert(state_distance <= distance);
         if (state_distance < distance)
             continue;
-        for (size_t i = 0; i < graph[state].size(); ++i) {
-            const pair<int, int> &transition = graph[state][i];
-            int successor = transition.first;
-            int cost = transition.second;
-            int successor_cost = state_distance + cost;
+        for (int pos = adjacency_offsets[state];
+             pos < adjacency_offsets[state + 1]; ++pos) {
+            int successor = adjacency_states[pos];
+            int successor_cost = state_distance + adjacency_costs[pos];
             if (distances[successor] > successor_cost) {
                 distances[successor] = successor_cost;
                 queue.push(successor_cost, successor);
             }
         }
     }
+    queue.clear();
 }
 
-void Distances::compute_init_distances_general_cost() {
-    vector<vector<pair<int, int>>> forward_graph(get_num_states());
-    for (const GroupAndTransitions &gat : transition_system) {
-        const LabelGroup &label_group = gat.label_group;
-        const vector<Transition> &transitions = gat.transitions;
-        int cost = label_group.get_cost();
-        for (const Transition &transition : transitions) {
-            forward_graph[transition.src].push_back(
-                make_pair(transition.target, cost));
-        }
+void Distances::search_init_distances(bool unit_cost) {
+    assert(static_cast<int>(init_distances.size()) == get_num_states());
+    build_adjacency(false, !unit_cost);
+    int init_state = transition_system.get_init_state();
+    init_distances[init_state] = 0;
+    if (unit_cost) {
+        fifo_queue.push_back(init_state);
+        breadth_first_search(init_distances);
+    } else {
+        queue.push(0, init_state);
+        dijkstra_search(init_distances);
     }
-
-    // TODO: Reuse the same queue for multiple computations to save speed?
-    //       Also see compute_goal_distances_general_cost.
-    priority_queues::AdaptiveQueue<int> queue;
-    init_distances[transition_system.get_init_state()] = 0;
-    queue.push(0, transition_system.get_init_state());
-    dijkstra_search(forward_graph, queue, init_distances);
 }
 
-void Distances::compute_goal_distances_general_cost() {
-    vector<vector<pair<int, int>>> backward_graph(get_num_states());
-    for (const GroupAndTransitions &gat : transition_system) {
-        const LabelGroup &label_group = gat.label_group;
-        const vector<Transition> &transitions = gat.transitions;
-        int cost = label_group.get_cost();
-        for (const Transition &transition : transitions) {
-            backward_graph[transition.target].push_back(
-                make_pair(transition.src, cost));
-        }
-    }
-
-    // TODO: Reuse the same queue for multiple computations to save speed?
-    //       Also see compute_init_distances_general_cost.
-    priority_queues::AdaptiveQueue<int> queue;
+void Distances::search_goal_distances(bool unit_cost) {
+    assert(static_cast<int>(goal_distances.size()) == get_num_states());
+    build_adjacency(true, !unit_cost);
     for (int state = 0; state < get_num_states(); ++state) {
         if (transition_system.is_goal_state(state)) {
             goal_distances[state] = 0;
-            queue.push(0, state);
+            if (unit_cost) {
+                fifo_queue.push_back(state);
+            } else {
+                queue.push(0, state);
+            }
         }
     }
-    dijkstra_search(backward_graph, queue, goal_distances);
+    if (unit_cost) {
+        breadth_first_search(goal_distances);
+    } else {
+        dijkstra_search(goal_distances);
+    }
 }
 
 void Distances::compute_distances(
@@ -229,29 +229,16 @@ void Distances::compute_distances(
         }
         cout << " distances using ";
     }
-    if (is_unit_cost()) {
-        if (verbosity >= utils::Verbosity::VERBOSE) {
-            cout << "unit-cost";
-        }
-        if (compute_init_distances) {
-            compute_init_distances_unit_cost();
-        }
-        if (compute_goal_distances) {
-            compute_goal_distances_unit_cost();
-        }
-    } else {
-        if (verbosity >= utils::Verbosity::VERBOSE) {
-            cout << "general-cost";
-        }
-        if (compute_init_distances) {
-            compute_init_distances_general_cost();
-        }
-        if (compute_goal_distances) {
-            compute_goal_distances_general_cost();
-        }
-    }
+    bool unit_cost = is_unit_cost();
     if (verbosity >= utils::Verbosity::VERBOSE) {
-        cout << " algorithm" << endl;
+        cout << (unit_cost ? "unit-cost" : "general-cost") << " algorithm"
+             << endl;
+    }
+    if (compute_init_distances) {
+        search_init_distances(unit_cost);
+    }
+    if (compute_goal_distances) {
+        search_goal_distances(unit_cost);
     }
 
     if (compute_init_distances) {
@@ -286,7 +273,14 @@ void Distances::apply_abstraction(
         new_goal_distances.resize(new_num_states, DISTANCE_UNKNOWN);
     }
 
-    bool must_recompute = false;
+    /*
+      Init and goal distances are checked separately: a shrink step that
+      combines states with different init distances but equal goal
+      distances only requires recomputing the init distances, and vice
+      versa.
+    */
+    bool must_recompute_init = false;
+    bool must_recompute_goal = false;
     for (int new_state = 0; new_state < new_num_states; ++new_state) {
         const StateEquivalenceClass &state_equivalence_class =
             state_equivalence_relation[new_state];
@@ -305,16 +299,15 @@ void Distances::apply_abstraction(
         ++pos;
         for (; pos != state_equivalence_class.end(); ++pos) {
             if (compute_init_distances && init_distances[*pos] != new_init_dist) {
-                must_recompute = true;
-                break;
+                must_recompute_init = true;
             }
             if (compute_goal_distances && goal_distances[*pos] != new_goal_dist) {
-                must_recompute = true;
-                break;
+                must_recompute_goal = true;
             }
         }
 
-        if (must_recompute)
+        if ((must_recompute_init || !compute_init_distances) &&
+            (must_recompute_goal || !compute_goal_distances))
             break;
 
         if (compute_init_distances) {
@@ -325,17 +318,27 @@ void Distances::apply_abstraction(
         }
     }
 
-    if (must_recompute) {
-        if (verbosity >= utils::Verbosity::VERBOSE) {
-            cout << transition_system.tag()
-                 << "simplification was not f-preserving!" << endl;
-        }
-        clear_distances();
-        compute_distances(
-            compute_init_distances, compute_goal_distances, verbosity);
-    } else {
+    if ((must_recompute_init || must_recompute_goal) &&
+        verbosity >= utils::Verbosity::VERBOSE) {
+        cout << transition_system.tag()
+             << "simplification was not f-preserving!" << endl;
+    }
+
+    bool unit_cost = (must_recompute_init || must_recompute_goal) &&
+        is_unit_cost();
+    if (compute_init_distances) {
         init_distances = move(new_init_distances);
+        if (must_recompute_init) {
+            init_distances.assign(new_num_states, INF);
+            search_init_distances(unit_cost);
+        }
+    }
+    if (compute_goal_distances) {
         goal_distances = move(new_goal_distances);
+        if (must_recompute_goal) {
+            goal_distances.assign(new_num_states, INF);
+            search_goal_distances(unit_cost);
+        }
     }
 }
 
@@ -3,6 +3,8 @@
 
 #include "types.h"
 
+#include "../algorithms/priority_queues.h"
+
 #include <cassert>
 #include <vector>
 
@@ -29,14 +31,29 @@ class Distances {
     bool init_distances_computed;
     bool goal_distances_computed;
 
+    /*
+      Forward or backward graph of the transition system in compressed
+      sparse row format, together with the queues used by the searches.
+      We keep them as members so that repeated distance computations for
+      the same transition system (e.g., after a shrink step that is not
+      f-preserving) reuse the allocated memory.
+    */
+    std::vector<int> adjacency_offsets;
+    std::vector<int> adjacency_states;
+    std::vector<int> adjacency_costs;
+    std::vector<int> fifo_queue;
+    priority_queues::AdaptiveQueue<int> queue;
+
     void clear_distances();
     int get_num_states() const;
     bool is_unit_cost() const;
 
-    void compute_init_distances_unit_cost();
-    void compute_goal_distances_unit_cost();
-    void compute_init_distances_general_cost();
-    void compute_goal_distances_general_cost();
+    void build_adjacency(bool backward, bool with_costs);
+    void breadth_first_search(std::vector<int> &distances);
+    void dijkstra_search(std::vector<int> &distances);
+
+    void search_init_distances(bool unit_cost);
+    void search_goal_distances(bool unit_cost);
 public:
     explicit Distances(const TransitionSystem &transition_system);
     ~Distances() = default;
@@ -56,7 +73,9 @@ public:
 
     /*
       Update distances according to the given abstraction. If the abstraction
-      is not f-preserving, distances are directly recomputed.
+      does not preserve init (goal) distances, init (goal) distances are
+      directly recomputed. Distances of the other direction are carried over
+      from the old states if they are preserved.
 
       It is OK for the abstraction to drop states, but then all
       dropped states must be unreachable or irrelevant. (Otherwise,
@@ -5,8 +5,7 @@
 
 #include "evaluation_context.h"
 #include "operator_id.h"
-
-class StateID;
+#include "state_id.h"
 
 
 template<class Entry>
@@ -133,6 +132,35 @@ using StateOpenList = OpenList<StateOpenListEntry>;
 using EdgeOpenList = OpenList<EdgeOpenListEntry>;
 
 
+/*
+  Open lists that index their entries identify state entries by the ID
+  of their state, so inserting a state again can update its entry. Edge
+  entries are never inserted twice and need no IDs.
+*/
+template<class Entry>
+class OpenListEntryIDs;
+
+template<>
+class OpenListEntryIDs<StateOpenListEntry> {
+public:
+    static const bool identifies_states = true;
+
+    static int get_id(const StateOpenListEntry &entry) {
+        return entry.value;
+    }
+};
+
+template<>
+class OpenListEntryIDs<EdgeOpenListEntry> {
+public:
+    static const bool identifies_states = false;
+
+    static int get_id(const EdgeOpenListEntry &) {
+        return -1;
+    }
+};
+
+
 template<class Entry>
 OpenList<Entry>::OpenList(bool only_preferred)
     : only_preferred(only_preferred) {
@@ -5,40 +5,38 @@
 #include "../option_parser.h"
 #include "../plugin.h"
 
-#include "../utils/collections.h"
+#include "../algorithms/indexed_heap.h"
+
 #include "../utils/markup.h"
 #include "../utils/memory.h"
 #include "../utils/rng.h"
 #include "../utils/rng_options.h"
 
-#include <functional>
+#include <cassert>
 #include <memory>
+#include <utility>
+#include <vector>
 
 using namespace std;
 
 namespace epsilon_greedy_open_list {
+/*
+  Entries are kept in a heap ordered by heuristic value and insertion
+  time. For state entries, the heap is indexed by state, and inserting
+  a state that is already contained keeps only the entry with the
+  smaller key, so reopened states don't leave stale duplicates behind.
+*/
 template<class Entry>
 class EpsilonGreedyOpenList : public OpenList<Entry> {
     shared_ptr<utils::RandomNumberGenerator> rng;
 
-    struct HeapNode {
-        int id;
-        int h;
-        Entry entry;
-        HeapNode(int id, int h, const Entry &entry)
-            : id(id), h(h), entry(entry) {
-        }
-
-        bool operator>(const HeapNode &other) const {
-            return make_pair(h, id) > make_pair(other.h, other.id);
-        }
-    };
-
-    vector<HeapNode> heap;
+    // Heuristic value and insertion time.
+    using Key = pair<int, int>;
+    vector<int> heap_positions;
+    indexed_heap::IndexedHeap<Key, Entry, OpenListEntryIDs<Entry>> heap;
     shared_ptr<Evaluator> evaluator;
 
     double epsilon;
-    int size;
     int next_id;
 
 protected:
@@ -59,51 +57,33 @@ public:
     virtual void clear() override;
 };
 
-template<class HeapNode>
-static void adjust_heap_up(vector<HeapNode> &heap, size_t pos) {
-    assert(utils::in_bounds(pos, heap));
-    while (pos != 0) {
-        size_t parent_pos = (pos - 1) / 2;
-        if (heap[pos] > heap[parent_pos]) {
-            break;
-        }
-        swap(heap[pos], heap[parent_pos]);
-        pos = parent_pos;
-    }
-}
-
 template<class Entry>
 void EpsilonGreedyOpenList<Entry>::do_insertion(
     EvaluationContext &eval_context, const Entry &entry) {
-    heap.emplace_back(
-        next_id++, eval_context.get_evaluator_value(evaluator.get()), entry);
-    push_heap(heap.begin(), heap.end(), greater<HeapNode>());
-    ++size;
+    Key key(eval_context.get_evaluator_value(evaluator.get()), next_id++);
+    if (OpenListEntryIDs<Entry>::identifies_states)
+        heap.push_or_decrease(key, entry);
+    else
+        heap.push(key, entry);
 }
 
 template<class Entry>
 EpsilonGreedyOpenList<Entry>::EpsilonGreedyOpenList(const Options &opts)
     : OpenList<Entry>(opts.get<bool>("pref_only")),
       rng(utils::parse_rng_from_options(opts)),
+      heap(OpenListEntryIDs<Entry>::identifies_states ? &heap_positions : nullptr),
       evaluator(opts.get<shared_ptr<Evaluator>>("eval")),
       epsilon(opts.get<double>("epsilon")),
-      size(0),
       next_id(0) {
 }
 
 template<class Entry>
 Entry EpsilonGreedyOpenList<Entry>::remove_min() {
-    assert(size > 0);
-    if ((*rng)() < epsilon) {
-        int pos = (*rng)(size);
-        heap[pos].h = numeric_limits<int>::min();
-        adjust_heap_up(heap, pos);
-    }
-    pop_heap(heap.begin(), heap.end(), greater<HeapNode>());
-    HeapNode heap_node = heap.back();
-    heap.pop_back();
-    --size;
-    return heap_node.entry;
+    assert(!heap.empty());
+    int pos = 0;
+    if ((*rng)() < epsilon)
+        pos = (*rng)(heap.size());
+    return heap.remove_at(pos);
 }
 
 template<class Entry>
@@ -126,13 +106,13 @@ void EpsilonGreedyOpenList<Entry>::get_path_dependent_evaluators(
 
 template<class Entry>
 bool EpsilonGreedyOpenList<Entry>::empty() const {
-    return size == 0;
+    return heap.empty();
 }
 
 template<class Entry>
 void EpsilonGreedyOpenList<Entry>::clear() {
     heap.clear();
-    size = 0;
+    heap_positions.clear();
     next_id = 0;
 }
 
@@ -20,11 +20,26 @@
 using namespace std;
 
 namespace pareto_open_list {
+/*
+  If a state is inserted again while it is in the open list, the new
+  entry is dropped if the key didn't change. Otherwise, the state moves
+  to the bucket of the new key, and entries for it in other buckets
+  become invalid. Invalid entries stay in their bucket until they reach
+  the front, but they don't count towards the size of the bucket, so a
+  bucket with only invalid entries is removed right away.
+*/
 template<class Entry>
 class ParetoOpenList : public OpenList<Entry> {
     shared_ptr<utils::RandomNumberGenerator> rng;
 
-    using Bucket = deque<Entry>;
+    struct Bucket {
+        deque<Entry> entries;
+        int num_valid_entries;
+
+        Bucket()
+            : num_valid_entries(0) {
+        }
+    };
     using KeyType = vector<int>;
     using BucketMap = utils::HashMap<KeyType, Bucket>;
     using KeySet = set<KeyType>;
@@ -34,6 +49,15 @@ class ParetoOpenList : public OpenList<Entry> {
     bool state_uniform_selection;
     vector<shared_ptr<Evaluator>> evaluators;
 
+    /*
+      Bucket of every state in the open list. Elements of the bucket
+      map keep their addresses until they are erased. Only used for
+      state entries because edge entries are never inserted twice.
+    */
+    vector<typename BucketMap::value_type *> state_buckets;
+
+    bool is_valid(const Entry &entry, const Bucket &bucket) const;
+
     bool dominates(const KeyType &v1, const KeyType &v2) const;
     bool is_nondominated(
         const KeyType &vec, KeySet &domination_candidates) const;
@@ -128,9 +152,27 @@ void ParetoOpenList<Entry>::do_insertion(
     for (const shared_ptr<Evaluator> &evaluator : evaluators)
         key.push_back(eval_context.get_evaluator_value_or_infinity(evaluator.get()));
 
-    Bucket &bucket = buckets[key];
-    bool newkey = bucket.empty();
-    bucket.push_back(entry);
+    bool track_states = OpenListEntryIDs<Entry>::identifies_states;
+    int state_id = OpenListEntryIDs<Entry>::get_id(entry);
+    if (track_states) {
+        if (state_id >= static_cast<int>(state_buckets.size()))
+            state_buckets.resize(state_id + 1, nullptr);
+        auto *old_key_and_bucket = state_buckets[state_id];
+        if (old_key_and_bucket) {
+            if (old_key_and_bucket->first == key)
+                return;
+            if (--old_key_and_bucket->second.num_valid_entries == 0)
+                remove_key(old_key_and_bucket->first);
+        }
+    }
+
+    auto &key_and_bucket = *buckets.emplace(key, Bucket()).first;
+    Bucket &bucket = key_and_bucket.second;
+    bool newkey = bucket.num_valid_entries == 0;
+    bucket.entries.push_back(entry);
+    ++bucket.num_valid_entries;
+    if (track_states)
+        state_buckets[state_id] = &key_and_bucket;
 
     if (newkey && is_nondominated(key, nondominated)) {
         /*
@@ -156,6 +198,21 @@ void ParetoOpenList<Entry>::do_insertion(
     }
 }
 
+/*
+  A state entry is valid if the state is in the open list with the key
+  of the bucket. If the bucket contains several entries for the state
+  (because it moved to another bucket and back), the first one is used.
+  All edge entries are valid.
+*/
+template<class Entry>
+bool ParetoOpenList<Entry>::is_valid(
+    const Entry &entry, const Bucket &bucket) const {
+    if (!OpenListEntryIDs<Entry>::identifies_states)
+        return true;
+    auto *key_and_bucket = state_buckets[OpenListEntryIDs<Entry>::get_id(entry)];
+    return key_and_bucket && &key_and_bucket->second == &bucket;
+}
+
 template<class Entry>
 Entry ParetoOpenList<Entry>::remove_min() {
     typename KeySet::iterator selected = nondominated.begin();
@@ -172,9 +229,13 @@ Entry ParetoOpenList<Entry>::remove_min() {
             selected = it;
     }
     Bucket &bucket = buckets[*selected];
-    Entry result = bucket.front();
-    bucket.pop_front();
-    if (bucket.empty())
+    while (!is_valid(bucket.entries.front(), bucket))
+        bucket.entries.pop_front();
+    Entry result = bucket.entries.front();
+    bucket.entries.pop_front();
+    if (OpenListEntryIDs<Entry>::identifies_states)
+        state_buckets[OpenListEntryIDs<Entry>::get_id(result)] = nullptr;
+    if (--bucket.num_valid_entries == 0)
         remove_key(*selected);
     return result;
 }
@@ -188,6 +249,7 @@ template<class Entry>
 void ParetoOpenList<Entry>::clear() {
     buckets.clear();
     nondominated.clear();
+    state_buckets.clear();
 }
 
 template<class Entry>
@@ -7,20 +7,50 @@
 
 #include "../utils/memory.h"
 
+#include <algorithm>
 #include <cassert>
+#include <cstdint>
 #include <deque>
-#include <map>
 #include <utility>
 #include <vector>
 
 using namespace std;
 
 namespace tiebreaking_open_list {
+/*
+  Entries are stored in two levels of buckets: the first level groups
+  them by the value of the first evaluator, the second level by the
+  values of the remaining evaluators. Within a bucket, entries are
+  removed in FIFO order.
+
+  The values of the remaining evaluators are packed into 64-bit words
+  (two values per word) such that comparing the words as unsigned
+  integers orders the keys lexicographically. Levels and buckets are
+  kept in vectors sorted by decreasing key, so the minimum is always at
+  the back. Since only few keys are in use at the same time, finding
+  the bucket of a key and removing the minimum take (amortized)
+  constant time in practice. Empty levels and buckets are recycled, so
+  insertions don't allocate memory once the open list has warmed up.
+*/
 template<class Entry>
 class TieBreakingOpenList : public OpenList<Entry> {
     using Bucket = deque<Entry>;
 
-    map<const vector<int>, Bucket> buckets;
+    struct Level {
+        int value;
+        // Bucket IDs, sorted by decreasing remaining key.
+        vector<int> bucket_ids;
+    };
+
+    // Levels in use, sorted by decreasing value.
+    vector<Level> levels;
+    vector<Level> unused_levels;
+
+    vector<Bucket> buckets;
+    // The remaining key of bucket i is stored at i * key_size.
+    vector<uint64_t> bucket_keys;
+    vector<int> unused_bucket_ids;
+
     int size;
 
     vector<shared_ptr<Evaluator>> evaluators;
@@ -31,7 +61,16 @@ class TieBreakingOpenList : public OpenList<Entry> {
     */
     bool allow_unsafe_pruning;
 
+    // Number of words of the packed key of all evaluators but the first.
+    const int key_size;
+    // Remaining key of the entry that is being inserted.
+    vector<uint64_t> key;
+
     int dimension() const;
+    bool key_is_less(int bucket_id) const;
+    bool key_is_equal(int bucket_id) const;
+    Level &get_level(int value);
+    int get_bucket_id(Level &level);
 
 protected:
     virtual void do_insertion(EvaluationContext &eval_context,
@@ -56,33 +95,118 @@ template<class Entry>
 TieBreakingOpenList<Entry>::TieBreakingOpenList(const Options &opts)
     : OpenList<Entry>(opts.get<bool>("pref_only")),
       size(0), evaluators(opts.get_list<shared_ptr<Evaluator>>("evals")),
-      allow_unsafe_pruning(opts.get<bool>("unsafe_pruning")) {
+      allow_unsafe_pruning(opts.get<bool>("unsafe_pruning")),
+      key_size(evaluators.size() / 2),
+      key(key_size) {
+}
+
+// Map signed values to unsigned values with the same order.
+static inline uint64_t encode_value(int value) {
+    return static_cast<uint32_t>(value) ^ 0x80000000u;
+}
+
+template<class Entry>
+bool TieBreakingOpenList<Entry>::key_is_less(int bucket_id) const {
+    const uint64_t *bucket_key = &bucket_keys[bucket_id * key_size];
+    for (int i = 0; i < key_size; ++i) {
+        if (key[i] != bucket_key[i])
+            return key[i] < bucket_key[i];
+    }
+    return false;
+}
+
+template<class Entry>
+bool TieBreakingOpenList<Entry>::key_is_equal(int bucket_id) const {
+    return equal(key.begin(), key.end(), bucket_keys.begin() + bucket_id * key_size);
+}
+
+template<class Entry>
+typename TieBreakingOpenList<Entry>::Level &
+TieBreakingOpenList<Entry>::get_level(int value) {
+    // Most insertions go to the level with the minimal value.
+    if (!levels.empty() && levels.back().value == value)
+        return levels.back();
+    auto it = lower_bound(
+        levels.begin(), levels.end(), value,
+        [](const Level &level, int value) {
+            return level.value > value;
+        });
+    if (it != levels.end() && it->value == value)
+        return *it;
+
+    Level level;
+    if (!unused_levels.empty()) {
+        level = move(unused_levels.back());
+        unused_levels.pop_back();
+    }
+    level.value = value;
+    return *levels.insert(it, move(level));
+}
+
+template<class Entry>
+int TieBreakingOpenList<Entry>::get_bucket_id(Level &level) {
+    vector<int> &bucket_ids = level.bucket_ids;
+    if (!bucket_ids.empty() && key_is_equal(bucket_ids.back()))
+        return bucket_ids.back();
+    auto it = partition_point(
+        bucket_ids.begin(), bucket_ids.end(),
+        [this](int bucket_id) {
+            return key_is_less(bucket_id);
+        });
+    if (it != bucket_ids.end() && key_is_equal(*it))
+        return *it;
+
+    int bucket_id;
+    if (unused_bucket_ids.empty()) {
+        bucket_id = buckets.size();
+        buckets.emplace_back();
+        bucket_keys.resize(bucket_keys.size() + key_size);
+    } else {
+        bucket_id = unused_bucket_ids.back();
+        unused_bucket_ids.pop_back();
+    }
+    copy(key.begin(), key.end(), bucket_keys.begin() + bucket_id * key_size);
+    bucket_ids.insert(it, bucket_id);
+    return bucket_id;
 }
 
 template<class Entry>
 void TieBreakingOpenList<Entry>::do_insertion(
     EvaluationContext &eval_context, const Entry &entry) {
-    vector<int> key;
-    key.reserve(evaluators.size());
-    for (const shared_ptr<Evaluator> &evaluator : evaluators)
-        key.push_back(eval_context.get_evaluator_value_or_infinity(evaluator.get()));
+    int value = eval_context.get_evaluator_value_or_infinity(evaluators[0].get());
+    fill(key.begin(), key.end(), 0);
+    for (int i = 1; i < dimension(); ++i) {
+        int h = eval_context.get_evaluator_value_or_infinity(evaluators[i].get());
+        // Components 1 and 2 go to the upper and lower half of word 0, etc.
+        int shift = (i % 2) ? 32 : 0;
+        key[(i - 1) / 2] |= encode_value(h) << shift;
+    }
 
-    buckets[key].push_back(entry);
+    int bucket_id = get_bucket_id(get_level(value));
+    buckets[bucket_id].push_back(entry);
     ++size;
 }
 
 template<class Entry>
 Entry TieBreakingOpenList<Entry>::remove_min() {
     assert(size > 0);
-    typename map<const vector<int>, Bucket>::iterator it;
-    it = buckets.begin();
-    assert(it != buckets.end());
-    assert(!it->second.empty());
+    assert(!levels.empty());
+    Level &level = levels.back();
+    assert(!level.bucket_ids.empty());
+    int bucket_id = level.bucket_ids.back();
+    Bucket &bucket = buckets[bucket_id];
+    assert(!bucket.empty());
     --size;
-    Entry result = it->second.front();
-    it->second.pop_front();
-    if (it->second.empty())
-        buckets.erase(it);
+    Entry result = bucket.front();
+    bucket.pop_front();
+    if (bucket.empty()) {
+        unused_bucket_ids.push_back(bucket_id);
+        level.bucket_ids.pop_back();
+        if (level.bucket_ids.empty()) {
+            unused_levels.push_back(move(level));
+            levels.pop_back();
+        }
+    }
     return result;
 }
 
@@ -93,7 +217,11 @@ bool TieBreakingOpenList<Entry>::empty() const {
 
 template<class Entry>
 void TieBreakingOpenList<Entry>::clear() {
+    levels.clear();
+    unused_levels.clear();
     buckets.clear();
+    bucket_keys.clear();
+    unused_bucket_ids.clear();
     size = 0;
 }
 
@@ -12,22 +12,50 @@
 #include "../utils/rng.h"
 #include "../utils/rng_options.h"
 
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
 #include <memory>
-#include <unordered_map>
 #include <vector>
 
 using namespace std;
 
 namespace type_based_open_list {
+static const int EMPTY_SLOT = -1;
+static const int INITIAL_INDEX_CAPACITY = 16;
+
+/*
+  Buckets are stored in a vector in which the first num_buckets entries
+  are in use. The keys of all buckets have the same length and are
+  stored consecutively in a flat vector. An open-addressing hash table
+  with linear probing maps keys to bucket IDs. Empty buckets are swapped
+  behind the used ones, where they keep their memory for later use.
+*/
 template<class Entry>
 class TypeBasedOpenList : public OpenList<Entry> {
     shared_ptr<utils::RandomNumberGenerator> rng;
     vector<shared_ptr<Evaluator>> evaluators;
 
-    using Key = vector<int>;
     using Bucket = vector<Entry>;
-    vector<pair<Key, Bucket>> keys_and_buckets;
-    utils::HashMap<Key, int> key_to_bucket_index;
+    const int key_size;
+    int num_buckets;
+    vector<Bucket> buckets;
+    // The key of bucket i is stored at keys[i * key_size].
+    vector<int> keys;
+    vector<uint32_t> key_hashes;
+    // Hash table of bucket IDs. Its capacity is a power of two.
+    vector<int> bucket_index;
+    // Key of the entry that is being inserted.
+    vector<int> key;
+
+    uint32_t compute_key_hash() const;
+    bool bucket_has_key(int bucket_id) const;
+    size_t find_slot(uint32_t hash) const;
+    size_t find_slot_of_bucket(int bucket_id) const;
+    void erase_slot(size_t slot);
+    void resize_index(size_t capacity);
+    int add_bucket(uint32_t hash);
+    void remove_bucket(int bucket_id);
 
 protected:
     virtual void do_insertion(
@@ -46,60 +74,172 @@ public:
     virtual void get_path_dependent_evaluators(set<Evaluator *> &evals) override;
 };
 
+template<class Entry>
+uint32_t TypeBasedOpenList<Entry>::compute_key_hash() const {
+    utils::HashState hash_state;
+    for (int value : key) {
+        utils::feed(hash_state, value);
+    }
+    return hash_state.get_hash32();
+}
+
+template<class Entry>
+bool TypeBasedOpenList<Entry>::bucket_has_key(int bucket_id) const {
+    return equal(key.begin(), key.end(), keys.begin() + bucket_id * key_size);
+}
+
+/*
+  Return the slot that contains the bucket with the current key or the
+  empty slot where this bucket belongs.
+*/
+template<class Entry>
+size_t TypeBasedOpenList<Entry>::find_slot(uint32_t hash) const {
+    size_t mask = bucket_index.size() - 1;
+    size_t slot = hash & mask;
+    while (true) {
+        int bucket_id = bucket_index[slot];
+        if (bucket_id == EMPTY_SLOT ||
+            (key_hashes[bucket_id] == hash && bucket_has_key(bucket_id)))
+            return slot;
+        slot = (slot + 1) & mask;
+    }
+}
+
+template<class Entry>
+size_t TypeBasedOpenList<Entry>::find_slot_of_bucket(int bucket_id) const {
+    size_t mask = bucket_index.size() - 1;
+    size_t slot = key_hashes[bucket_id] & mask;
+    while (bucket_index[slot] != bucket_id) {
+        assert(bucket_index[slot] != EMPTY_SLOT);
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+/*
+  Remove the bucket in the given slot from the hash table and move later
+  buckets of the same probe sequence back, so no tombstones are needed.
+*/
+template<class Entry>
+void TypeBasedOpenList<Entry>::erase_slot(size_t slot) {
+    size_t mask = bucket_index.size() - 1;
+    size_t hole = slot;
+    size_t current = slot;
+    while (true) {
+        current = (current + 1) & mask;
+        int bucket_id = bucket_index[current];
+        if (bucket_id == EMPTY_SLOT)
+            break;
+        size_t home = key_hashes[bucket_id] & mask;
+        // Move the bucket unless its home slot lies between hole and current.
+        if (((current - home) & mask) >= ((current - hole) & mask)) {
+            bucket_index[hole] = bucket_id;
+            hole = current;
+        }
+    }
+    bucket_index[hole] = EMPTY_SLOT;
+}
+
+template<class Entry>
+void TypeBasedOpenList<Entry>::resize_index(size_t capacity) {
+    bucket_index.assign(capacity, EMPTY_SLOT);
+    size_t mask = capacity - 1;
+    for (int bucket_id = 0; bucket_id < num_buckets; ++bucket_id) {
+        size_t slot = key_hashes[bucket_id] & mask;
+        while (bucket_index[slot] != EMPTY_SLOT)
+            slot = (slot + 1) & mask;
+        bucket_index[slot] = bucket_id;
+    }
+}
+
+template<class Entry>
+int TypeBasedOpenList<Entry>::add_bucket(uint32_t hash) {
+    int bucket_id = num_buckets++;
+    if (bucket_id == static_cast<int>(buckets.size())) {
+        buckets.emplace_back();
+        keys.resize(keys.size() + key_size);
+        key_hashes.push_back(0);
+    }
+    assert(buckets[bucket_id].empty());
+    copy(key.begin(), key.end(), keys.begin() + bucket_id * key_size);
+    key_hashes[bucket_id] = hash;
+    return bucket_id;
+}
+
+/*
+  Swap the (empty) bucket with the last used bucket and mark it unused.
+*/
+template<class Entry>
+void TypeBasedOpenList<Entry>::remove_bucket(int bucket_id) {
+    assert(buckets[bucket_id].empty());
+    erase_slot(find_slot_of_bucket(bucket_id));
+    int last_bucket_id = --num_buckets;
+    if (bucket_id != last_bucket_id) {
+        bucket_index[find_slot_of_bucket(last_bucket_id)] = bucket_id;
+        swap(buckets[bucket_id], buckets[last_bucket_id]);
+        copy(keys.begin() + last_bucket_id * key_size,
+             keys.begin() + (last_bucket_id + 1) * key_size,
+             keys.begin() + bucket_id * key_size);
+        key_hashes[bucket_id] = key_hashes[last_bucket_id];
+    }
+}
+
 template<class Entry>
 void TypeBasedOpenList<Entry>::do_insertion(
     EvaluationContext &eval_context, const Entry &entry) {
-    vector<int> key;
-    key.reserve(evaluators.size());
-    for (const shared_ptr<Evaluator> &evaluator : evaluators) {
-        key.push_back(
-            eval_context.get_evaluator_value_or_infinity(evaluator.get()));
+    for (int i = 0; i < key_size; ++i) {
+        key[i] = eval_context.get_evaluator_value_or_infinity(
+            evaluators[i].get());
     }
 
-    auto it = key_to_bucket_index.find(key);
-    if (it == key_to_bucket_index.end()) {
-        key_to_bucket_index[key] = keys_and_buckets.size();
-        keys_and_buckets.push_back(make_pair(move(key), Bucket({entry})));
-    } else {
-        size_t bucket_index = it->second;
-        assert(utils::in_bounds(bucket_index, keys_and_buckets));
-        keys_and_buckets[bucket_index].second.push_back(entry);
+    uint32_t hash = compute_key_hash();
+    size_t slot = find_slot(hash);
+    int bucket_id = bucket_index[slot];
+    if (bucket_id == EMPTY_SLOT) {
+        bucket_id = add_bucket(hash);
+        bucket_index[slot] = bucket_id;
+        // Keep the load factor at most 1/2.
+        if (2 * static_cast<size_t>(num_buckets) > bucket_index.size())
+            resize_index(2 * bucket_index.size());
     }
+    buckets[bucket_id].push_back(entry);
 }
 
 template<class Entry>
 TypeBasedOpenList<Entry>::TypeBasedOpenList(const Options &opts)
     : rng(utils::parse_rng_from_options(opts)),
-      evaluators(opts.get_list<shared_ptr<Evaluator>>("evaluators")) {
+      evaluators(opts.get_list<shared_ptr<Evaluator>>("evaluators")),
+      key_size(evaluators.size()),
+      num_buckets(0),
+      bucket_index(INITIAL_INDEX_CAPACITY, EMPTY_SLOT),
+      key(key_size) {
 }
 
 template<class Entry>
 Entry TypeBasedOpenList<Entry>::remove_min() {
-    size_t bucket_id = (*rng)(keys_and_buckets.size());
-    auto &key_and_bucket = keys_and_buckets[bucket_id];
-    const Key &min_key = key_and_bucket.first;
-    Bucket &bucket = key_and_bucket.second;
+    int bucket_id = (*rng)(num_buckets);
+    Bucket &bucket = buckets[bucket_id];
     int pos = (*rng)(bucket.size());
     Entry result = utils::swap_and_pop_from_vector(bucket, pos);
 
     if (bucket.empty()) {
-        // Swap the empty bucket with the last bucket, then delete it.
-        key_to_bucket_index[keys_and_buckets.back().first] = bucket_id;
-        key_to_bucket_index.erase(min_key);
-        utils::swap_and_pop_from_vector(keys_and_buckets, bucket_id);
+        remove_bucket(bucket_id);
     }
     return result;
 }
 
 template<class Entry>
 bool TypeBasedOpenList<Entry>::empty() const {
-    return keys_and_buckets.empty();
+    return num_buckets == 0;
 }
 
 template<class Entry>
 void TypeBasedOpenList<Entry>::clear() {
-    keys_and_buckets.clear();
-    key_to_bucket_index.clear();
+    num_buckets = 0;
+    buckets.clear();
+    keys.clear();
+    key_hashes.clear();
+    bucket_index.assign(INITIAL_INDEX_CAPACITY, EMPTY_SLOT);
 }
 
 template<class Entry>
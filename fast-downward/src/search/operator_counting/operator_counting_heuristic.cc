@@ -8,15 +8,29 @@
 #include "../utils/markup.h"
 
 #include <cmath>
+#include <iostream>
 
 using namespace std;
 
 namespace operator_counting {
+/*
+  If the basis of the parent state is no longer cached, we compare the
+  state to this many of the most recently cached states.
+*/
+static const int NUM_SIMILAR_STATE_CANDIDATES = 16;
+
+
 OperatorCountingHeuristic::OperatorCountingHeuristic(const Options &opts)
     : Heuristic(opts),
       constraint_generators(
           opts.get_list<shared_ptr<ConstraintGenerator>>("constraint_generators")),
-      lp_solver(lp::LPSolverType(opts.get_enum("lpsolver"))) {
+      lp_solver(lp::LPSolverType(opts.get_enum("lpsolver"))),
+      basis_cache_size(opts.get<int>("basis_cache_size")),
+      successor_id(StateID::no_state),
+      start_basis_source(BasisSource::PREVIOUS_LP),
+      verbosity(static_cast<utils::Verbosity>(opts.get_enum("verbosity"))),
+      num_solves_from_parent_basis(0),
+      num_solves_from_similar_basis(0) {
     vector<lp::LPVariable> variables;
     double infinity = lp_solver.get_infinity();
     for (OperatorProxy op : task_proxy.get_operators()) {
@@ -31,11 +45,132 @@ OperatorCountingHeuristic::OperatorCountingHeuristic(const Options &opts)
 }
 
 OperatorCountingHeuristic::~OperatorCountingHeuristic() {
+    // The statistics show how much warm-starting from cached bases helps.
+    if (basis_cache_size > 0 || verbosity >= utils::Verbosity::VERBOSE)
+        print_statistics();
+}
+
+void OperatorCountingHeuristic::print_statistics() const {
+    lp_solver.print_statistics();
+    if (basis_cache_size > 0) {
+        cout << "LP solves started from the basis of the parent state: "
+             << num_solves_from_parent_basis << endl;
+        cout << "LP solves started from the basis of a similar state: "
+             << num_solves_from_similar_basis << endl;
+    }
+    cout << "LP solves by simplex iterations:";
+    for (size_t i = 0; i < num_solves_by_iterations.size(); ++i) {
+        if (num_solves_by_iterations[i] == 0)
+            continue;
+        cout << " ";
+        if (i <= 1) {
+            cout << i;
+        } else {
+            cout << (1 << (i - 1)) << "-" << (1 << i) - 1;
+        }
+        cout << ": " << num_solves_by_iterations[i];
+    }
+    cout << endl;
+}
+
+void OperatorCountingHeuristic::get_path_dependent_evaluators(
+    set<Evaluator *> &evals) {
+    // We only need to know the parents of states to reuse their bases.
+    if (basis_cache_size > 0)
+        evals.insert(this);
+}
+
+void OperatorCountingHeuristic::notify_state_transition(
+    const GlobalState &parent_state, OperatorID, const GlobalState &state) {
+    /*
+      Search engines evaluate a new state directly after notifying us
+      about the transition that reached it.
+    */
+    parent_basis = cached_bases[parent_state];
+    successor_id = state.get_id();
+}
+
+void OperatorCountingHeuristic::cache_basis(const GlobalState &global_state) {
+    shared_ptr<lp::LPBasis> &basis = cached_bases[global_state];
+    if (!basis) {
+        states_with_cached_basis.push_back(global_state);
+        if (static_cast<int>(states_with_cached_basis.size()) > basis_cache_size) {
+            cached_bases[states_with_cached_basis.front()] = nullptr;
+            states_with_cached_basis.pop_front();
+        }
+    }
+    basis = move(last_basis);
+}
+
+shared_ptr<lp::LPBasis> OperatorCountingHeuristic::find_similar_basis(
+    const GlobalState &global_state) const {
+    int num_variables = task_proxy.get_variables().size();
+    int min_distance = num_variables + 1;
+    shared_ptr<lp::LPBasis> similar_basis;
+    int num_candidates = 0;
+    for (auto it = states_with_cached_basis.rbegin();
+         it != states_with_cached_basis.rend() &&
+         num_candidates < NUM_SIMILAR_STATE_CANDIDATES;
+         ++it, ++num_candidates) {
+        const GlobalState &cached_state = *it;
+        int distance = 0;
+        for (int var = 0; var < num_variables && distance < min_distance; ++var) {
+            if (cached_state[var] != global_state[var])
+                ++distance;
+        }
+        if (distance < min_distance) {
+            min_distance = distance;
+            similar_basis = cached_bases[cached_state];
+        }
+    }
+    return similar_basis;
+}
+
+void OperatorCountingHeuristic::record_solve() {
+    int num_iterations = lp_solver.get_num_iterations();
+    size_t bucket = 0;
+    while (num_iterations >> bucket)
+        ++bucket;
+    if (bucket >= num_solves_by_iterations.size())
+        num_solves_by_iterations.resize(bucket + 1, 0);
+    ++num_solves_by_iterations[bucket];
+    if (start_basis_source == BasisSource::PARENT_STATE)
+        ++num_solves_from_parent_basis;
+    else if (start_basis_source == BasisSource::SIMILAR_STATE)
+        ++num_solves_from_similar_basis;
+
+    if (verbosity >= utils::Verbosity::DEBUG) {
+        cout << "LP solved with " << num_iterations << " iterations in "
+             << lp_solver.get_solve_time() << "s starting from ";
+        if (start_basis_source == BasisSource::PARENT_STATE)
+            cout << "the basis of the parent state";
+        else if (start_basis_source == BasisSource::SIMILAR_STATE)
+            cout << "the basis of a similar state";
+        else
+            cout << "the previous LP";
+        cout << endl;
+    }
 }
 
 int OperatorCountingHeuristic::compute_heuristic(const GlobalState &global_state) {
     State state = convert_global_state(global_state);
-    return compute_heuristic(state);
+    if (global_state.get_id() != successor_id)
+        parent_basis = nullptr;
+    if (parent_basis) {
+        start_basis = move(parent_basis);
+        start_basis_source = BasisSource::PARENT_STATE;
+    } else if (basis_cache_size > 0) {
+        start_basis = find_similar_basis(global_state);
+        if (start_basis)
+            start_basis_source = BasisSource::SIMILAR_STATE;
+    }
+    int result = compute_heuristic(state);
+    parent_basis = nullptr;
+    start_basis = nullptr;
+    start_basis_source = BasisSource::PREVIOUS_LP;
+    if (last_basis)
+        cache_basis(global_state);
+    return result;
 }
 
 int OperatorCountingHeuristic::compute_heuristic(const State &state) {
@@ -48,7 +183,12 @@ int OperatorCountingHeuristic::compute_heuristic(const State &state) {
         }
     }
     int result;
+    if (start_basis)
+        lp_solver.set_basis(*start_basis);
     lp_solver.solve();
+    record_solve();
+    if (basis_cache_size > 0)
+        last_basis = lp_solver.get_basis();
     if (lp_solver.has_optimal_solution()) {
         double epsilon = 0.01;
         double objective_value = lp_solver.get_objective_value();
@@ -102,7 +242,25 @@ static shared_ptr<Heuristic> _parse(OptionParser &parser) {
     parser.add_list_option<shared_ptr<ConstraintGenerator>>(
         "constraint_generators",
         "methods that generate constraints over operator counting variables");
+    parser.add_option<int>(
+        "basis_cache_size",
+        "number of evaluated states whose final LP basis is kept to start "
+        "solving the LPs of their successors. With 0, every LP starts "
+        "from the basis of the previously solved LP. With a positive "
+        "value, successors whose parent basis is no longer cached start "
+        "from the basis of the most similar of the last "
+        + to_string(NUM_SIMILAR_STATE_CANDIDATES) + " cached states, "
+        "and LP statistics are printed when the heuristic is destroyed.",
+        "0",
+        Bounds("0", "infinity"));
     lp::add_lp_solver_option_to_parser(parser);
+    parser.document_note(
+        "Verbosity",
+        "With verbosity=verbose, LP statistics including a histogram of "
+        "the simplex iterations per evaluated state are printed when the "
+        "heuristic is destroyed. With verbosity=debug, the iterations and "
+        "solve time of every LP are printed as well.");
+    utils::add_verbosity_option_to_parser(parser);
     Heuristic::add_options_to_parser(parser);
     Options opts = parser.parse();
     if (parser.help_mode())
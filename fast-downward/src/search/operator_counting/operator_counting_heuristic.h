@@ -2,9 +2,12 @@
 #define OPERATOR_COUNTING_OPERATOR_COUNTING_HEURISTIC_H
 
 #include "../heuristic.h"
+#include "../per_state_information.h"
 
 #include "../lp/lp_solver.h"
+#include "../utils/logging.h"
 
+#include <deque>
 #include <memory>
 #include <vector>
 
@@ -15,15 +18,58 @@ class Options;
 namespace operator_counting {
 class ConstraintGenerator;
 
+enum class BasisSource {
+    PREVIOUS_LP, PARENT_STATE, SIMILAR_STATE
+};
+
 class OperatorCountingHeuristic : public Heuristic {
     std::vector<std::shared_ptr<ConstraintGenerator>> constraint_generators;
     lp::LPSolver lp_solver;
+
+    /*
+      If basis_cache_size > 0, we store the final LP bases of the last
+      basis_cache_size evaluated states and start the LP of a successor
+      state from the basis of its parent. If the parent's basis is no
+      longer cached, we start from the basis of the most similar of the
+      most recently cached states. Otherwise, each LP starts from the
+      basis of the previously solved LP.
+    */
+    const int basis_cache_size;
+    PerStateInformation<std::shared_ptr<lp::LPBasis>> cached_bases;
+    std::deque<GlobalState> states_with_cached_basis;
+    std::shared_ptr<lp::LPBasis> parent_basis;
+    StateID successor_id;
+    std::shared_ptr<lp::LPBasis> start_basis;
+    BasisSource start_basis_source;
+    std::shared_ptr<lp::LPBasis> last_basis;
+
+    const utils::Verbosity verbosity;
+    /*
+      num_solves_by_iterations[0] counts the LPs solved without simplex
+      iterations, num_solves_by_iterations[i] for i > 0 those solved
+      with 2^(i-1) to 2^i - 1 iterations.
+    */
+    std::vector<int> num_solves_by_iterations;
+    int num_solves_from_parent_basis;
+    int num_solves_from_similar_basis;
+
+    void cache_basis(const GlobalState &global_state);
+    std::shared_ptr<lp::LPBasis> find_similar_basis(
+        const GlobalState &global_state) const;
+    void record_solve();
+    void print_statistics() const;
 protected:
     virtual int compute_heuristic(const GlobalState &global_state) override;
     int compute_heuristic(const State &state);
 public:
     explicit OperatorCountingHeuristic(const options::Options &opts);
     ~OperatorCountingHeuristic();
+
+    virtual void get_path_dependent_evaluators(
+        std::set<Evaluator *> &evals) override;
+    virtual void notify_state_transition(
+        const GlobalState &parent_state, OperatorID op_id,
+        const GlobalState &state) override;
 };
 }
 
@@ -7,6 +7,7 @@
 #include "../option_parser.h"
 #include "../plugin.h"
 
+#include "../tasks/frozen_task.h"
 #include "../utils/timer.h"
 
 #include <iostream>
@@ -22,8 +23,10 @@ CanonicalPDBs get_canonical_pdbs_from_options(
         opts.get<shared_ptr<PatternCollectionGenerator>>("patterns");
     utils::Timer timer;
     cout << "Initializing canonical PDB heuristic..." << endl;
+    // Pattern generators and PDBs access the operators many times.
+    shared_ptr<AbstractTask> frozen_task = tasks::get_frozen_task(task);
     PatternCollectionInformation pattern_collection_info =
-        pattern_generator->generate(task);
+        pattern_generator->generate(frozen_task);
     shared_ptr<PatternCollection> patterns =
         pattern_collection_info.get_patterns();
     /*
@@ -6,6 +6,8 @@
 #include "../option_parser.h"
 #include "../plugin.h"
 
+#include "../tasks/frozen_task.h"
+
 #include <limits>
 #include <memory>
 
@@ -16,7 +18,8 @@ shared_ptr<PatternDatabase> get_pdb_from_options(const shared_ptr<AbstractTask>
                                                  const Options &opts) {
     shared_ptr<PatternGenerator> pattern_generator =
         opts.get<shared_ptr<PatternGenerator>>("pattern");
-    PatternInformation pattern_info = pattern_generator->generate(task);
+    shared_ptr<AbstractTask> frozen_task = tasks::get_frozen_task(task);
+    PatternInformation pattern_info = pattern_generator->generate(frozen_task);
     return pattern_info.get_pdb();
 }
 
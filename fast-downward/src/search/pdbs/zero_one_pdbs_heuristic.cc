@@ -5,6 +5,8 @@
 #include "../option_parser.h"
 #include "../plugin.h"
 
+#include "../tasks/frozen_task.h"
+
 using namespace std;
 
 namespace pdbs {
@@ -12,11 +14,12 @@ ZeroOnePDBs get_zero_one_pdbs_from_options(
     const shared_ptr<AbstractTask> &task, const Options &opts) {
     shared_ptr<PatternCollectionGenerator> pattern_generator =
         opts.get<shared_ptr<PatternCollectionGenerator>>("patterns");
+    shared_ptr<AbstractTask> frozen_task = tasks::get_frozen_task(task);
     PatternCollectionInformation pattern_collection_info =
-        pattern_generator->generate(task);
+        pattern_generator->generate(frozen_task);
     shared_ptr<PatternCollection> patterns =
         pattern_collection_info.get_patterns();
-    TaskProxy task_proxy(*task);
+    TaskProxy task_proxy(*frozen_task);
     return ZeroOnePDBs(task_proxy, *patterns);
 }
 
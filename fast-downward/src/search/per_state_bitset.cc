@@ -3,6 +3,10 @@
 using namespace std;
 
 
+const BitsetMath::Block BitsetMath::zeros;
+const BitsetMath::Block BitsetMath::ones;
+const int BitsetMath::bits_per_block;
+
 int BitsetMath::compute_num_blocks(size_t num_bits) {
     return (num_bits + bits_per_block - 1) / bits_per_block;
 }
@@ -3,12 +3,14 @@
 
 #include "per_state_array.h"
 
+#include <bitset>
+#include <cstdint>
 #include <vector>
 
 
 class BitsetMath {
 public:
-    using Block = unsigned int;
+    using Block = std::uint64_t;
     static_assert(
         !std::numeric_limits<Block>::is_signed,
         "Block type must be unsigned");
@@ -22,6 +24,17 @@ public:
     static std::size_t block_index(std::size_t pos);
     static std::size_t bit_index(std::size_t pos);
     static Block bit_mask(std::size_t pos);
+
+    static int popcount(Block block) {
+        return std::bitset<bits_per_block>(block).count();
+    }
+
+    // Index of the lowest set bit. The block must not be zero.
+    static int lowest_bit_index(Block block) {
+        assert(block != zeros);
+        // block ^ (block - 1) has ones exactly up to the lowest set bit.
+        return popcount(block ^ (block - 1)) - 1;
+    }
 };
 
 
@@ -40,6 +53,18 @@ public:
     bool test(int index) const;
     void intersect(const BitsetView &other);
     int size() const;
+
+    int num_blocks() const {
+        return data.size();
+    }
+
+    BitsetMath::Block &get_block(int block_index) {
+        return data[block_index];
+    }
+
+    BitsetMath::Block get_block(int block_index) const {
+        return data[block_index];
+    }
 };
 
 
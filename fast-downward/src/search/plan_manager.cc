@@ -1,14 +1,14 @@
 #include "plan_manager.h"
 
+#include "plan_stream.h"
 #include "task_proxy.h"
 
 #include "task_utils/task_properties.h"
+#include "utils/timer.h"
 
-#include <fstream>
 #include <iostream>
 #include <sstream>
 
-
 using namespace std;
 
 int calculate_plan_cost(const Plan &plan, const TaskProxy &task_proxy) {
@@ -20,10 +20,27 @@ int calculate_plan_cost(const Plan &plan, const TaskProxy &task_proxy) {
     return plan_cost;
 }
 
+static void write_json_string(ostream &out, const string &str) {
+    out << '"';
+    for (char c : str) {
+        if (c == '"' || c == '\\') {
+            out << '\\' << c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            static const char *hex_digits = "0123456789abcdef";
+            out << "\\u00" << hex_digits[c >> 4] << hex_digits[c & 0xf];
+        } else {
+            out << c;
+        }
+    }
+    out << '"';
+}
+
 PlanManager::PlanManager()
     : plan_filename("sas_plan"),
       num_previously_generated_plans(0),
-      is_part_of_anytime_portfolio(false) {
+      is_part_of_anytime_portfolio(false),
+      use_atomic_plan_files(false),
+      sync_plan_files(false) {
 }
 
 void PlanManager::set_plan_filename(const string &plan_filename_) {
@@ -38,6 +55,18 @@ void PlanManager::set_is_part_of_anytime_portfolio(bool is_part_of_anytime_portf
     is_part_of_anytime_portfolio = is_part_of_anytime_portfolio_;
 }
 
+void PlanManager::set_use_atomic_plan_files(bool use_atomic_plan_files_) {
+    use_atomic_plan_files = use_atomic_plan_files_;
+}
+
+void PlanManager::set_sync_plan_files(bool sync_plan_files_) {
+    sync_plan_files = sync_plan_files_;
+}
+
+void PlanManager::set_plan_stream(const shared_ptr<PlanStream> &plan_stream_) {
+    plan_stream = plan_stream_;
+}
+
 void PlanManager::save_plan(
     const Plan &plan, const TaskProxy &task_proxy,
     bool generates_multiple_plan_files) {
@@ -49,11 +78,7 @@ void PlanManager::save_plan(
     } else {
         assert(plan_number == 1);
     }
-    ofstream outfile(filename.str());
-    if (outfile.rdstate() & ofstream::failbit) {
-        cerr << "Failed to open plan file: " << filename.str() << endl;
-        utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
-    }
+    ostringstream outfile;
     OperatorsProxy operators = task_proxy.get_operators();
     for (OperatorID op_id : plan) {
         cout << operators[op_id].get_name() << " (" << operators[op_id].get_cost() << ")" << endl;
@@ -63,8 +88,25 @@ void PlanManager::save_plan(
     bool is_unit_cost = task_properties::is_unit_cost(task_proxy);
     outfile << "; cost = " << plan_cost << " ("
             << (is_unit_cost ? "unit cost" : "general cost") << ")" << endl;
-    outfile.close();
+    write_plan_file(filename.str(), outfile.str(),
+                    use_atomic_plan_files, sync_plan_files);
     cout << "Plan length: " << plan.size() << " step(s)." << endl;
     cout << "Plan cost: " << plan_cost << endl;
+
+    if (plan_stream) {
+        ostringstream line;
+        line << "{\"plan_number\": " << plan_number
+             << ", \"cost\": " << plan_cost
+             << ", \"length\": " << plan.size()
+             << ", \"time\": " << static_cast<double>(utils::g_timer())
+             << ", \"plan\": [";
+        for (size_t i = 0; i < plan.size(); ++i) {
+            if (i > 0)
+                line << ", ";
+            write_json_string(line, "(" + operators[plan[i]].get_name() + ")");
+        }
+        line << "]}";
+        plan_stream->write_line(line.str());
+    }
     ++num_previously_generated_plans;
 }
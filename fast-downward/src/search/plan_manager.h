@@ -1,10 +1,12 @@
 #ifndef PLAN_MANAGER_H
 #define PLAN_MANAGER_H
 
+#include <memory>
 #include <string>
 #include <vector>
 
 class OperatorID;
+class PlanStream;
 class TaskProxy;
 
 using Plan = std::vector<OperatorID>;
@@ -13,12 +15,19 @@ class PlanManager {
     std::string plan_filename;
     int num_previously_generated_plans;
     bool is_part_of_anytime_portfolio;
+    bool use_atomic_plan_files;
+    bool sync_plan_files;
+    std::shared_ptr<PlanStream> plan_stream;
 public:
     PlanManager();
 
     void set_plan_filename(const std::string &plan_filename);
     void set_num_previously_generated_plans(int num_previously_generated_plans);
     void set_is_part_of_anytime_portfolio(bool is_part_of_anytime_portfolio);
+    void set_use_atomic_plan_files(bool use_atomic_plan_files);
+    void set_sync_plan_files(bool sync_plan_files);
+    // Also report every saved plan to the given stream (see plan_stream.h).
+    void set_plan_stream(const std::shared_ptr<PlanStream> &plan_stream);
 
     /*
       Set generates_multiple_plan_files to true if the planner can find more than
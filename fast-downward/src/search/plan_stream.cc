@@ -0,0 +1,182 @@
+#include "plan_stream.h"
+
+#include "utils/system.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+#if OPERATING_SYSTEM == WINDOWS
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+#else
+#include <csignal>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+static const string UNIX_SOCKET_PREFIX = "unix:";
+
+#if OPERATING_SYSTEM == WINDOWS
+static int open_for_writing(const string &filename, bool append) {
+    int flags = _O_WRONLY | _O_CREAT | _O_BINARY | (append ? _O_APPEND : _O_TRUNC);
+    return _open(filename.c_str(), flags, _S_IREAD | _S_IWRITE);
+}
+
+static int write_some(int fd, const char *data, size_t size) {
+    return _write(fd, data, static_cast<unsigned int>(size));
+}
+
+static int sync_file(int fd) {
+    return _commit(fd);
+}
+
+static int close_file(int fd) {
+    return _close(fd);
+}
+
+static int replace_file(const string &from, const string &to) {
+    // rename() does not replace existing files on Windows.
+    remove(to.c_str());
+    return rename(from.c_str(), to.c_str());
+}
+
+static int connect_to_unix_socket(const string &) {
+    cerr << "Plan streams to Unix domain sockets are not supported on Windows."
+         << endl;
+    utils::exit_with(utils::ExitCode::SEARCH_UNSUPPORTED);
+}
+#else
+static int open_for_writing(const string &filename, bool append) {
+    int flags = O_WRONLY | O_CREAT | (append ? O_APPEND : O_TRUNC);
+    return open(filename.c_str(), flags, 0666);
+}
+
+static ssize_t write_some(int fd, const char *data, size_t size) {
+    return write(fd, data, size);
+}
+
+static int sync_file(int fd) {
+    return fsync(fd);
+}
+
+static int close_file(int fd) {
+    return close(fd);
+}
+
+static int replace_file(const string &from, const string &to) {
+    return rename(from.c_str(), to.c_str());
+}
+
+static int connect_to_unix_socket(const string &path) {
+    sockaddr_un address;
+    if (path.size() >= sizeof(address.sun_path)) {
+        cerr << "Socket path is too long: " << path << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
+    }
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strcpy(address.sun_path, path.c_str());
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd != -1 &&
+        connect(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) == -1) {
+        int connect_errno = errno;
+        close(fd);
+        errno = connect_errno;
+        fd = -1;
+    }
+    return fd;
+}
+#endif
+
+static bool write_all(int fd, const string &data) {
+    const char *pos = data.data();
+    size_t remaining = data.size();
+    while (remaining > 0) {
+        auto written = write_some(fd, pos, remaining);
+        if (written < 0) {
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+        pos += written;
+        remaining -= written;
+    }
+    return true;
+}
+
+PlanStream::PlanStream(const string &target, bool sync)
+    : target(target),
+      sync(sync),
+      fd(-1) {
+#if OPERATING_SYSTEM != WINDOWS
+    /*
+      Writing to a FIFO or socket whose reader has gone away raises
+      SIGPIPE, which would terminate the planner before it saves the
+      remaining plans. We handle the resulting EPIPE errors instead.
+    */
+    signal(SIGPIPE, SIG_IGN);
+#endif
+    if (target.compare(0, UNIX_SOCKET_PREFIX.size(), UNIX_SOCKET_PREFIX) == 0) {
+        fd = connect_to_unix_socket(target.substr(UNIX_SOCKET_PREFIX.size()));
+    } else {
+        fd = open_for_writing(target, true);
+    }
+    if (fd == -1) {
+        cerr << "Failed to open plan stream " << target << ": "
+             << strerror(errno) << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
+    }
+}
+
+PlanStream::~PlanStream() {
+    close();
+}
+
+void PlanStream::close() {
+    if (fd != -1) {
+        close_file(fd);
+        fd = -1;
+    }
+}
+
+void PlanStream::write_line(const string &line) {
+    if (fd == -1)
+        return;
+    if (!write_all(fd, line + "\n")) {
+        cerr << "Failed to write to plan stream " << target << ": "
+             << strerror(errno) << ". Stopped streaming plans." << endl;
+        close();
+        return;
+    }
+    // FIFOs and sockets cannot be synced and report EINVAL.
+    if (sync && sync_file(fd) == -1 && errno != EINVAL) {
+        cerr << "Failed to sync plan stream " << target << ": "
+             << strerror(errno) << endl;
+    }
+}
+
+void write_plan_file(
+    const string &filename, const string &contents, bool atomic, bool sync) {
+    string written_filename = atomic ? filename + ".tmp" : filename;
+    int fd = open_for_writing(written_filename, false);
+    if (fd == -1) {
+        cerr << "Failed to open plan file: " << written_filename << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
+    }
+    bool success = write_all(fd, contents) && (!sync || sync_file(fd) == 0);
+    success = (close_file(fd) == 0) && success;
+    if (success && atomic)
+        success = (replace_file(written_filename, filename) == 0);
+    if (!success) {
+        cerr << "Failed to write plan file " << filename << ": "
+             << strerror(errno) << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_CRITICAL_ERROR);
+    }
+}
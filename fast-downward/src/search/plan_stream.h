@@ -0,0 +1,52 @@
+#ifndef PLAN_STREAM_H
+#define PLAN_STREAM_H
+
+#include <string>
+
+/*
+  Channel to which the planner reports every plan as soon as it is saved,
+  so that other processes can use the plans of an anytime search before
+  the search ends. Every plan is written as one line of JSON:
+
+    {"plan_number": 2, "cost": 10, "length": 3, "time": 1.52,
+     "plan": ["(pick ball1 rooma left)", ...]}
+
+  The target is either a path or "unix:PATH". Paths are opened for
+  appending, which works for regular files and named pipes (FIFOs).
+  Opening a FIFO blocks until a reader opens it. With "unix:PATH", the
+  planner connects to the Unix domain stream socket at PATH, which must
+  already be listening.
+
+  If sync is true, every line written to a file is flushed to disk with
+  fsync before write_line() returns. If the reader of a FIFO or socket
+  goes away, the planner prints a warning and stops streaming instead of
+  terminating.
+*/
+class PlanStream {
+    std::string target;
+    bool sync;
+    int fd;
+
+    void close();
+public:
+    PlanStream(const std::string &target, bool sync);
+    ~PlanStream();
+
+    PlanStream(const PlanStream &) = delete;
+    PlanStream &operator=(const PlanStream &) = delete;
+
+    void write_line(const std::string &line);
+};
+
+/*
+  Write contents to the file with the given name. With atomic = true, the
+  contents are first written to FILENAME.tmp, which is then renamed to
+  FILENAME, so readers never see a partially written file. With
+  sync = true, the file is flushed to disk with fsync before it is
+  renamed or closed.
+*/
+extern void write_plan_file(
+    const std::string &filename, const std::string &contents,
+    bool atomic, bool sync);
+
+#endif
@@ -10,6 +10,7 @@
 
 #include "planopt_heuristics/and_or_graph.h"
 
+#include <fstream>
 #include <iostream>
 
 using namespace std;
@@ -28,6 +29,23 @@ int main(int argc, const char **argv) {
         exit(0);
     }
 
+    if (static_cast<string>(argv[1]) == "--write-binary-task") {
+        if (argc != 3) {
+            cerr << "missing argument after --write-binary-task" << endl;
+            utils::exit_with(ExitCode::SEARCH_INPUT_ERROR);
+        }
+        ofstream out(argv[2], ios::binary);
+        tasks::write_binary_root_task(cin, out);
+        out.close();
+        if (out.fail()) {
+            cerr << "Failed to write binary task file: " << argv[2] << endl;
+            utils::exit_with(ExitCode::SEARCH_CRITICAL_ERROR);
+        }
+        cout << "Wrote binary task file " << argv[2]
+             << " [t=" << utils::g_timer << "]" << endl;
+        exit(0);
+    }
+
     bool unit_cost = false;
     if (static_cast<string>(argv[1]) != "--help") {
         cout << "reading input... [t=" << utils::g_timer << "]" << endl;
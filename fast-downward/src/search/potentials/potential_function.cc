@@ -2,26 +2,31 @@
 
 #include "../task_proxy.h"
 
-#include "../utils/collections.h"
-
+#include <cassert>
 #include <cmath>
 
 using namespace std;
 
 namespace potentials {
 PotentialFunction::PotentialFunction(
-    const vector<vector<double>> &fact_potentials)
-    : fact_potentials(fact_potentials) {
+    const vector<vector<double>> &fact_potentials) {
+    fact_offsets.reserve(fact_potentials.size() + 1);
+    for (const vector<double> &var_potentials : fact_potentials) {
+        fact_offsets.push_back(potentials.size());
+        potentials.insert(
+            potentials.end(), var_potentials.begin(), var_potentials.end());
+    }
+    fact_offsets.push_back(potentials.size());
 }
 
 int PotentialFunction::get_value(const State &state) const {
+    const vector<int> &values = state.get_values();
+    int num_variables = values.size();
+    assert(num_variables == get_num_variables());
     double heuristic_value = 0.0;
-    for (FactProxy fact : state) {
-        int var_id = fact.get_variable().get_id();
-        int value = fact.get_value();
-        assert(utils::in_bounds(var_id, fact_potentials));
-        assert(utils::in_bounds(value, fact_potentials[var_id]));
-        heuristic_value += fact_potentials[var_id][value];
+    for (int var = 0; var < num_variables; ++var) {
+        assert(values[var] >= 0 && values[var] < get_domain_size(var));
+        heuristic_value += potentials[fact_offsets[var] + values[var]];
     }
     const double epsilon = 0.01;
     return static_cast<int>(ceil(heuristic_value - epsilon));
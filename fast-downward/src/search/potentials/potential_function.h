@@ -13,7 +13,11 @@ namespace potentials {
   overhead that is induced by evaluating heuristics whenever possible.
 */
 class PotentialFunction {
-    const std::vector<std::vector<double>> fact_potentials;
+    /* The potential of fact (var, value) is stored at
+       potentials[fact_offsets[var] + value]. fact_offsets has an additional
+       entry for the end of the last variable. */
+    std::vector<int> fact_offsets;
+    std::vector<double> potentials;
 
 public:
     explicit PotentialFunction(
@@ -21,6 +25,18 @@ public:
     ~PotentialFunction() = default;
 
     int get_value(const State &state) const;
+
+    int get_num_variables() const {
+        return fact_offsets.size() - 1;
+    }
+
+    int get_domain_size(int var) const {
+        return fact_offsets[var + 1] - fact_offsets[var];
+    }
+
+    double get_potential(int var, int value) const {
+        return potentials[fact_offsets[var] + value];
+    }
 };
 }
 
@@ -1,9 +1,12 @@
 #include "potential_max_heuristic.h"
 
 #include "potential_function.h"
+#include "quantized_potentials.h"
 
 #include "../option_parser.h"
 
+#include "../utils/memory.h"
+
 using namespace std;
 
 namespace potentials {
@@ -11,15 +14,14 @@ PotentialMaxHeuristic::PotentialMaxHeuristic(
     const Options &opts,
     vector<unique_ptr<PotentialFunction>> &&functions)
     : Heuristic(opts),
-      functions(move(functions)) {
+      potentials(utils::make_unique_ptr<QuantizedPotentials>(functions)) {
+}
+
+PotentialMaxHeuristic::~PotentialMaxHeuristic() {
 }
 
 int PotentialMaxHeuristic::compute_heuristic(const GlobalState &global_state) {
     const State state = convert_global_state(global_state);
-    int value = 0;
-    for (auto &function : functions) {
-        value = max(value, function->get_value(state));
-    }
-    return value;
+    return max(0, potentials->compute_max_value(state));
 }
 }
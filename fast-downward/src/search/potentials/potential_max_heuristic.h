@@ -8,12 +8,14 @@
 
 namespace potentials {
 class PotentialFunction;
+class QuantizedPotentials;
 
 /*
-  Maximize over multiple potential functions.
+  Maximize over multiple potential functions. All functions are evaluated
+  at once with quantized potentials (see QuantizedPotentials).
 */
 class PotentialMaxHeuristic : public Heuristic {
-    std::vector<std::unique_ptr<PotentialFunction>> functions;
+    std::unique_ptr<QuantizedPotentials> potentials;
 
 protected:
     virtual int compute_heuristic(const GlobalState &global_state) override;
@@ -22,7 +24,8 @@ public:
     explicit PotentialMaxHeuristic(
         const options::Options &opts,
         std::vector<std::unique_ptr<PotentialFunction>> &&functions);
-    ~PotentialMaxHeuristic() = default;
+    // Define in .cc file to avoid include in header.
+    ~PotentialMaxHeuristic();
 };
 }
 
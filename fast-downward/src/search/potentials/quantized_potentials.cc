@@ -0,0 +1,131 @@
+#include "quantized_potentials.h"
+
+#include "potential_function.h"
+
+#include "../task_proxy.h"
+
+#include "../utils/system.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <limits>
+
+using namespace std;
+
+namespace potentials {
+// Number of 32-bit columns in a 256-bit vector register.
+static const int COLUMNS_PER_VECTOR = 8;
+// Smallest scaling factor for which we use the quantized potentials.
+static const double MIN_SCALE = 256;
+
+QuantizedPotentials::QuantizedPotentials(
+    const vector<unique_ptr<PotentialFunction>> &functions)
+    : num_functions(functions.size()),
+      row_size((num_functions + COLUMNS_PER_VECTOR - 1) /
+               COLUMNS_PER_VECTOR * COLUMNS_PER_VECTOR) {
+    if (functions.empty())
+        return;
+    const PotentialFunction &first_function = *functions.front();
+    int num_variables = first_function.get_num_variables();
+    int num_facts = 0;
+    for (int var = 0; var < num_variables; ++var) {
+        fact_offsets.push_back(num_facts);
+        num_facts += first_function.get_domain_size(var);
+    }
+    weights.resize(static_cast<size_t>(num_facts) * row_size, 0);
+    sums.resize(row_size);
+
+    /*
+      Rounding down changes every potential by less than 1, so the sum of
+      rounded potentials differs from the scaled sum by less than the
+      number of variables.
+    */
+    const double max_sum = numeric_limits<int32_t>::max() - num_variables;
+    for (int i = 0; i < num_functions; ++i) {
+        const PotentialFunction &function = *functions[i];
+        assert(function.get_num_variables() == num_variables);
+        double max_abs_sum = 0.0;
+        for (int var = 0; var < num_variables; ++var) {
+            double max_abs_potential = 0.0;
+            for (int value = 0; value < function.get_domain_size(var); ++value) {
+                double potential = function.get_potential(var, value);
+                if (!isfinite(potential)) {
+                    cerr << "Potential of fact " << var << "=" << value
+                         << " is not finite: " << potential << endl;
+                    utils::exit_with(utils::ExitCode::SEARCH_CRITICAL_ERROR);
+                }
+                max_abs_potential = max(max_abs_potential, abs(potential));
+            }
+            max_abs_sum += max_abs_potential;
+        }
+        int exponent = max_abs_sum > 0 ?
+            static_cast<int>(floor(log2(max_sum / max_abs_sum))) : 30;
+        double scale = ldexp(1.0, min(exponent, 30));
+        while (max_abs_sum * scale > max_sum)
+            scale /= 2;
+        scales.push_back(scale);
+        if (scale < MIN_SCALE) {
+            // The weights of this function stay 0.
+            unquantized_function_ids.push_back(i);
+            for (int var = 0; var < num_variables; ++var) {
+                for (int value = 0; value < function.get_domain_size(var); ++value)
+                    unquantized_potentials.push_back(function.get_potential(var, value));
+            }
+            continue;
+        }
+
+        for (int var = 0; var < num_variables; ++var) {
+            for (int value = 0; value < function.get_domain_size(var); ++value) {
+                double potential = function.get_potential(var, value);
+                size_t row = fact_offsets[var] + value;
+                weights[row * row_size + i] =
+                    static_cast<int32_t>(floor(potential * scale));
+            }
+        }
+    }
+    cout << "Potential functions evaluated without quantization: "
+         << unquantized_function_ids.size() << "/" << num_functions << endl;
+}
+
+void QuantizedPotentials::compute_values(const State &state, vector<int> &values) {
+    if (num_functions == 0) {
+        values.clear();
+        return;
+    }
+    const vector<int> &state_values = state.get_values();
+    int num_variables = fact_offsets.size();
+    assert(static_cast<int>(state_values.size()) == num_variables);
+    fill(sums.begin(), sums.end(), 0);
+    int32_t *sums_data = sums.data();
+    for (int var = 0; var < num_variables; ++var) {
+        const int32_t *row = weights.data() +
+            static_cast<size_t>(fact_offsets[var] + state_values[var]) * row_size;
+        for (int i = 0; i < row_size; ++i)
+            sums_data[i] += row[i];
+    }
+
+    // Same tolerance as in PotentialFunction::get_value().
+    const double epsilon = 0.01;
+    values.resize(num_functions);
+    for (int i = 0; i < num_functions; ++i) {
+        values[i] = static_cast<int>(ceil(sums[i] / scales[i] - epsilon));
+    }
+    size_t num_facts = weights.size() / row_size;
+    for (size_t j = 0; j < unquantized_function_ids.size(); ++j) {
+        const double *potentials = unquantized_potentials.data() + j * num_facts;
+        double sum = 0.0;
+        for (int var = 0; var < num_variables; ++var)
+            sum += potentials[fact_offsets[var] + state_values[var]];
+        values[unquantized_function_ids[j]] = static_cast<int>(ceil(sum - epsilon));
+    }
+}
+
+int QuantizedPotentials::compute_max_value(const State &state) {
+    compute_values(state, function_values);
+    if (function_values.empty())
+        return 0;
+    return *max_element(function_values.begin(), function_values.end());
+}
+}
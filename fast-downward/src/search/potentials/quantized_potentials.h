@@ -0,0 +1,61 @@
+#ifndef POTENTIALS_QUANTIZED_POTENTIALS_H
+#define POTENTIALS_QUANTIZED_POTENTIALS_H
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class State;
+
+namespace potentials {
+class PotentialFunction;
+
+/*
+  Evaluates a set of potential functions at once.
+
+  The potentials are scaled by a power of two per function and rounded
+  down to 32-bit integers. Rounding down can only decrease the value of
+  a function, so admissible potential functions stay admissible. The
+  scaling factor is the largest power of two for which no sum of
+  potentials overflows, which makes the rounding error negligible for
+  most potentials computed by our LPs. If the scaling factor of a
+  function is below 2^8, e.g., because the LP bounded its
+  potentials only by a huge constant, rounding could noticeably weaken
+  the function. We evaluate such functions with their original double
+  potentials instead. All potentials must be finite, otherwise the
+  planner exits with an error.
+
+  The table has one row per fact holding the potentials of that fact for
+  all functions. Evaluating a state adds up one row per variable, which
+  compilers turn into vectorized integer additions.
+*/
+class QuantizedPotentials {
+    int num_functions;
+    // Number of columns per row, padded for vectorization.
+    int row_size;
+    // The row of fact (var, value) starts at row_size * (fact_offsets[var] + value).
+    std::vector<int> fact_offsets;
+    std::vector<std::int32_t> weights;
+    std::vector<double> scales;
+    std::vector<std::int32_t> sums;
+    std::vector<int> function_values;
+    // Indices of the functions evaluated with double potentials.
+    std::vector<int> unquantized_function_ids;
+    // The potential of fact f for the j-th of them is at j * num_facts + f.
+    std::vector<double> unquantized_potentials;
+
+public:
+    explicit QuantizedPotentials(
+        const std::vector<std::unique_ptr<PotentialFunction>> &functions);
+
+    int get_num_functions() const {
+        return num_functions;
+    }
+
+    // Compute the values of all functions for the given state.
+    void compute_values(const State &state, std::vector<int> &values);
+    int compute_max_value(const State &state);
+};
+}
+
+#endif
@@ -46,13 +46,15 @@ void StubbornSets::initialize(const shared_ptr<AbstractTask> &task) {
     task_properties::verify_no_conditional_effects(task_proxy);
 
     num_operators = task_proxy.get_operators().size();
+    num_operator_blocks = BitsetMath::compute_num_blocks(num_operators);
     num_unpruned_successors_generated = 0;
     num_pruned_successors_generated = 0;
     sorted_goals = utils::sorted<FactPair>(
         task_properties::get_fact_pairs(task_proxy.get_goals()));
 
     compute_sorted_operators(task_proxy);
-    compute_achievers(task_proxy);
+    compute_operator_sets(task_proxy);
+    stubborn.assign(num_operator_blocks, BitsetMath::zeros);
 }
 
 // Relies on op_preconds and op_effects being sorted by variable.
@@ -85,27 +87,97 @@ void StubbornSets::compute_sorted_operators(const TaskProxy &task_proxy) {
         });
 }
 
-void StubbornSets::compute_achievers(const TaskProxy &task_proxy) {
-    achievers = utils::map_vector<vector<vector<int>>>(
-        task_proxy.get_variables(), [](const VariableProxy &var) {
-            return vector<vector<int>>(var.get_domain_size());
-        });
+// Relies on ops being added in increasing order.
+static void add_to_operator_set(OperatorSet &ops, int op_no) {
+    int block_index = BitsetMath::block_index(op_no);
+    if (ops.empty() || ops.back().first != block_index)
+        ops.emplace_back(block_index, BitsetMath::zeros);
+    ops.back().second |= BitsetMath::bit_mask(op_no);
+}
+
+void StubbornSets::compute_operator_sets(const TaskProxy &task_proxy) {
+    VariablesProxy variables = task_proxy.get_variables();
+    int num_variables = variables.size();
+    writers.resize(num_variables);
+    precondition_ops_on_var.resize(num_variables);
+    for (VariableProxy var : variables) {
+        int domain_size = var.get_domain_size();
+        achievers.emplace_back(domain_size);
+        precondition_ops.emplace_back(domain_size);
+    }
+
+    for (int op_no = 0; op_no < num_operators; ++op_no) {
+        for (const FactPair &eff : sorted_op_effects[op_no]) {
+            add_to_operator_set(achievers[eff.var][eff.value], op_no);
+            add_to_operator_set(writers[eff.var], op_no);
+        }
+        for (const FactPair &pre : sorted_op_preconditions[op_no]) {
+            add_to_operator_set(precondition_ops[pre.var][pre.value], op_no);
+            add_to_operator_set(precondition_ops_on_var[pre.var], op_no);
+        }
+    }
+}
 
-    for (const OperatorProxy op : task_proxy.get_operators()) {
-        for (const EffectProxy effect : op.get_effects()) {
-            FactPair fact = effect.get_fact().get_pair();
-            achievers[fact.var][fact.value].push_back(op.get_id());
+OperatorSet StubbornSets::make_operator_set(
+    const vector<BitsetMath::Block> &ops) {
+    OperatorSet result;
+    for (size_t i = 0; i < ops.size(); ++i) {
+        if (ops[i] != BitsetMath::zeros)
+            result.emplace_back(i, ops[i]);
+    }
+    result.shrink_to_fit();
+    return result;
+}
+
+void StubbornSets::add_conflicting_operators(
+    const vector<FactPair> &facts,
+    const vector<OperatorSet> &by_var,
+    const vector<vector<OperatorSet>> &by_fact,
+    vector<BitsetMath::Block> &ops) const {
+    /*
+      Every operator has at most one condition on each variable, so the
+      operators with a conflicting condition on var are those with a
+      condition on var minus those with the condition (var, value).
+      Both sets are ordered by block index.
+    */
+    for (const FactPair &fact : facts) {
+        const OperatorSet &on_var = by_var[fact.var];
+        const OperatorSet &on_fact = by_fact[fact.var][fact.value];
+        auto fact_it = on_fact.begin();
+        for (const auto &block : on_var) {
+            BitsetMath::Block conflicting = block.second;
+            if (fact_it != on_fact.end() && fact_it->first == block.first) {
+                conflicting &= ~fact_it->second;
+                ++fact_it;
+            }
+            ops[block.first] |= conflicting;
         }
     }
 }
 
 bool StubbornSets::mark_as_stubborn(int op_no) {
-    if (!stubborn[op_no]) {
-        stubborn[op_no] = true;
-        stubborn_queue.push_back(op_no);
-        return true;
+    int block_index = BitsetMath::block_index(op_no);
+    return mark_block_as_stubborn(
+        block_index, BitsetMath::bit_mask(op_no)) != BitsetMath::zeros;
+}
+
+BitsetMath::Block StubbornSets::mark_block_as_stubborn(
+    int block_index, BitsetMath::Block ops) {
+    BitsetMath::Block new_ops = ops & ~stubborn[block_index];
+    stubborn[block_index] |= new_ops;
+    BitsetMath::Block remaining = new_ops;
+    while (remaining != BitsetMath::zeros) {
+        int bit_index = BitsetMath::lowest_bit_index(remaining);
+        stubborn_queue.push_back(block_index * BitsetMath::bits_per_block + bit_index);
+        remaining &= remaining - 1;
+    }
+    return new_ops;
+}
+
+void StubbornSets::mark_as_stubborn(const OperatorSet &ops) {
+    for (const auto &block : ops) {
+        mark_block_as_stubborn(block.first, block.second);
     }
-    return false;
 }
 
 void StubbornSets::prune_operators(
@@ -131,7 +203,7 @@ void StubbornSets::prune_operators(
     ++num_pruning_calls;
 
     // Clear stubborn set from previous call.
-    stubborn.assign(num_operators, false);
+    fill(stubborn.begin(), stubborn.end(), BitsetMath::zeros);
     assert(stubborn_queue.empty());
 
     initialize_stubborn_set(state);
@@ -147,7 +219,8 @@ void StubbornSets::prune_operators(
     vector<OperatorID> remaining_op_ids;
     remaining_op_ids.reserve(op_ids.size());
     for (OperatorID op_id : op_ids) {
-        if (stubborn[op_id.get_index()]) {
+        int op_no = op_id.get_index();
+        if (stubborn[BitsetMath::block_index(op_no)] & BitsetMath::bit_mask(op_no)) {
             remaining_op_ids.emplace_back(op_id);
         }
     }
@@ -2,6 +2,7 @@
 #define PRUNING_STUBBORN_SETS_H
 
 #include "../abstract_task.h"
+#include "../per_state_bitset.h"
 #include "../pruning_method.h"
 
 namespace options {
@@ -12,6 +13,15 @@ namespace stubborn_sets {
 inline FactPair find_unsatisfied_condition(
     const std::vector<FactPair> &conditions, const State &state);
 
+/*
+  Set of operators, stored as the non-zero blocks of a bitset over all
+  operators, ordered by block index. The sets used by stubborn set
+  methods (achievers of a fact, operators interfering with an operator)
+  usually contain few operators with nearby indices, because operators
+  grounded from the same schema are numbered consecutively.
+*/
+using OperatorSet = std::vector<std::pair<int, BitsetMath::Block>>;
+
 class StubbornSets : public PruningMethod {
     const double min_required_pruning_ratio;
     const int num_expansions_before_checking_pruning_ratio;
@@ -21,9 +31,9 @@ class StubbornSets : public PruningMethod {
     long num_unpruned_successors_generated;
     long num_pruned_successors_generated;
 
-    /* stubborn[op_no] is true iff the operator with operator index
-       op_no is contained in the stubborn set */
-    std::vector<bool> stubborn;
+    /* Bitset over all operators: the bit of the operator with operator
+       index op_no is set iff the operator is contained in the stubborn set */
+    std::vector<BitsetMath::Block> stubborn;
 
     /*
       stubborn_queue contains the operator indices of operators that
@@ -34,7 +44,7 @@ class StubbornSets : public PruningMethod {
     std::vector<int> stubborn_queue;
 
     void compute_sorted_operators(const TaskProxy &task_proxy);
-    void compute_achievers(const TaskProxy &task_proxy);
+    void compute_operator_sets(const TaskProxy &task_proxy);
 
 protected:
     /*
@@ -42,17 +52,40 @@ protected:
       access through the task interface during the search.
     */
     int num_operators;
+    int num_operator_blocks;
     std::vector<std::vector<FactPair>> sorted_op_preconditions;
     std::vector<std::vector<FactPair>> sorted_op_effects;
     std::vector<FactPair> sorted_goals;
 
-    /* achievers[var][value] contains all operator indices of
-       operators that achieve the fact (var, value). */
-    std::vector<std::vector<std::vector<int>>> achievers;
+    /* achievers[var][value] contains all operators that achieve the
+       fact (var, value), and writers[var] all operators with an effect
+       on var. Analogously, precondition_ops[var][value] and
+       precondition_ops_on_var[var] contain the operators with a
+       precondition on (var, value) and on var. */
+    std::vector<std::vector<OperatorSet>> achievers;
+    std::vector<OperatorSet> writers;
+    std::vector<std::vector<OperatorSet>> precondition_ops;
+    std::vector<OperatorSet> precondition_ops_on_var;
 
     bool can_disable(int op1_no, int op2_no) const;
     bool can_conflict(int op1_no, int op2_no) const;
 
+    /*
+      Add to the bitset ops all operators that have a condition on one of
+      the variables of the given facts whose value differs from that of
+      the fact. The operator sets by_var and by_fact must be writers and
+      achievers or precondition_ops_on_var and precondition_ops. For
+      example, with the effects of op1 and the preconditions of all
+      operators, this adds all operators op2 with can_disable(op1, op2).
+    */
+    void add_conflicting_operators(
+        const std::vector<FactPair> &facts,
+        const std::vector<OperatorSet> &by_var,
+        const std::vector<std::vector<OperatorSet>> &by_fact,
+        std::vector<BitsetMath::Block> &ops) const;
+    static OperatorSet make_operator_set(
+        const std::vector<BitsetMath::Block> &ops);
+
     /*
       Return the first unsatified goal pair,
       or FactPair::no_fact if there is none.
@@ -88,6 +121,14 @@ protected:
     // Returns true iff the operators was enqueued.
     // TODO: rename to enqueue_stubborn_operator?
     bool mark_as_stubborn(int op_no);
+    /*
+      Mark the operators in the given block of the operator bitset as
+      stubborn and enqueue those that are new in increasing order.
+      Returns the new operators.
+    */
+    BitsetMath::Block mark_block_as_stubborn(
+        int block_index, BitsetMath::Block ops);
+    void mark_as_stubborn(const OperatorSet &ops);
     virtual void initialize_stubborn_set(const State &state) = 0;
     virtual void handle_stubborn_operator(const State &state, int op_no) = 0;
 public:
@@ -10,6 +10,7 @@
 #include <unordered_map>
 
 using namespace std;
+using stubborn_sets::OperatorSet;
 
 namespace stubborn_sets_ec {
 // DTGs are stored as one adjacency list per value.
@@ -117,7 +118,7 @@ void StubbornSetsEC::initialize(const shared_ptr<AbstractTask> &task) {
         variables, [](const VariableProxy &var) {
             return vector<bool>(var.get_domain_size(), false);
         });
-    active_ops.assign(num_operators, false);
+    active_ops.assign(num_operator_blocks, BitsetMath::zeros);
     compute_operator_preconditions(task_proxy);
     build_reachability_map(task_proxy);
 
@@ -159,7 +160,7 @@ void StubbornSetsEC::build_reachability_map(const TaskProxy &task_proxy) {
 }
 
 void StubbornSetsEC::compute_active_operators(const State &state) {
-    active_ops.assign(active_ops.size(), false);
+    fill(active_ops.begin(), active_ops.end(), BitsetMath::zeros);
 
     for (int op_no = 0; op_no < num_operators; ++op_no) {
         bool all_preconditions_are_active = true;
@@ -176,38 +177,39 @@ void StubbornSetsEC::compute_active_operators(const State &state) {
         }
 
         if (all_preconditions_are_active) {
-            active_ops[op_no] = true;
+            active_ops[BitsetMath::block_index(op_no)] |= BitsetMath::bit_mask(op_no);
         }
     }
 }
 
-const vector<int> &StubbornSetsEC::get_conflicting_and_disabling(int op1_no) {
-    vector<int> &result = conflicting_and_disabling[op1_no];
+const OperatorSet &StubbornSetsEC::get_conflicting_and_disabling(int op1_no) {
+    OperatorSet &result = conflicting_and_disabling[op1_no];
     if (!conflicting_and_disabling_computed[op1_no]) {
-        for (int op2_no = 0; op2_no < num_operators; ++op2_no) {
-            if (op1_no != op2_no) {
-                bool conflict = can_conflict(op1_no, op2_no);
-                bool disable = can_disable(op2_no, op1_no);
-                if (conflict || disable) {
-                    result.push_back(op2_no);
-                }
-            }
-        }
-        result.shrink_to_fit();
+        // Collect all op2 with can_conflict(op1, op2) or can_disable(op2, op1).
+        related_ops.assign(num_operator_blocks, BitsetMath::zeros);
+        add_conflicting_operators(
+            sorted_op_effects[op1_no], writers, achievers, related_ops);
+        add_conflicting_operators(
+            sorted_op_preconditions[op1_no], writers, achievers, related_ops);
+        related_ops[BitsetMath::block_index(op1_no)] &=
+            ~BitsetMath::bit_mask(op1_no);
+        result = make_operator_set(related_ops);
         conflicting_and_disabling_computed[op1_no] = true;
     }
     return result;
 }
 
-const vector<int> &StubbornSetsEC::get_disabled(int op1_no) {
-    vector<int> &result = disabled[op1_no];
+const OperatorSet &StubbornSetsEC::get_disabled(int op1_no) {
+    OperatorSet &result = disabled[op1_no];
     if (!disabled_computed[op1_no]) {
-        for (int op2_no = 0; op2_no < num_operators; ++op2_no) {
-            if (op2_no != op1_no && can_disable(op1_no, op2_no)) {
-                result.push_back(op2_no);
-            }
-        }
-        result.shrink_to_fit();
+        // Collect all op2 with can_disable(op1, op2).
+        related_ops.assign(num_operator_blocks, BitsetMath::zeros);
+        add_conflicting_operators(
+            sorted_op_effects[op1_no], precondition_ops_on_var,
+            precondition_ops, related_ops);
+        related_ops[BitsetMath::block_index(op1_no)] &=
+            ~BitsetMath::bit_mask(op1_no);
+        result = make_operator_set(related_ops);
         disabled_computed[op1_no] = true;
     }
     return result;
@@ -217,36 +219,49 @@ bool StubbornSetsEC::is_applicable(int op_no, const State &state) const {
     return find_unsatisfied_precondition(op_no, state) == FactPair::no_fact;
 }
 
-// TODO: find a better name.
-void StubbornSetsEC::mark_as_stubborn_and_remember_written_vars(
-    int op_no, const State &state) {
-    if (mark_as_stubborn(op_no)) {
+void StubbornSetsEC::remember_written_vars(
+    int block_index, BitsetMath::Block new_ops, const State &state) {
+    while (new_ops != BitsetMath::zeros) {
+        int op_no = block_index * BitsetMath::bits_per_block +
+            BitsetMath::lowest_bit_index(new_ops);
         if (is_applicable(op_no, state)) {
             for (const FactPair &effect : sorted_op_effects[op_no])
                 written_vars[effect.var] = true;
         }
+        new_ops &= new_ops - 1;
+    }
+}
+
+void StubbornSetsEC::mark_active_as_stubborn_and_remember_written_vars(
+    const OperatorSet &ops, const State &state) {
+    for (const auto &block : ops) {
+        BitsetMath::Block new_ops = mark_block_as_stubborn(
+            block.first, block.second & active_ops[block.first]);
+        remember_written_vars(block.first, new_ops, state);
     }
 }
 
+// TODO: find a better name.
+void StubbornSetsEC::mark_as_stubborn_and_remember_written_vars(
+    int op_no, const State &state) {
+    int block_index = BitsetMath::block_index(op_no);
+    BitsetMath::Block new_ops = mark_block_as_stubborn(
+        block_index, BitsetMath::bit_mask(op_no));
+    remember_written_vars(block_index, new_ops, state);
+}
+
 /* TODO: think about a better name, which distinguishes this method
    better from the corresponding method for simple stubborn sets */
 void StubbornSetsEC::add_nes_for_fact(const FactPair &fact, const State &state) {
-    for (int achiever : achievers[fact.var][fact.value]) {
-        if (active_ops[achiever]) {
-            mark_as_stubborn_and_remember_written_vars(achiever, state);
-        }
-    }
-
+    mark_active_as_stubborn_and_remember_written_vars(
+        achievers[fact.var][fact.value], state);
     nes_computed[fact.var][fact.value] = true;
 }
 
 void StubbornSetsEC::add_conflicting_and_disabling(int op_no,
                                                    const State &state) {
-    for (int conflict : get_conflicting_and_disabling(op_no)) {
-        if (active_ops[conflict]) {
-            mark_as_stubborn_and_remember_written_vars(conflict, state);
-        }
-    }
+    mark_active_as_stubborn_and_remember_written_vars(
+        get_conflicting_and_disabling(op_no), state);
 }
 
 // Relies on op_effects and op_preconditions being sorted by variable.
@@ -295,8 +310,13 @@ void StubbornSetsEC::handle_stubborn_operator(const State &state, int op_no) {
         add_conflicting_and_disabling(op_no, state);     // active operators used
         //Rule S4'
         vector<int> disabled_vars;
-        for (int disabled_op_no : get_disabled(op_no)) {
-            if (active_ops[disabled_op_no]) {
+        for (const auto &block : get_disabled(op_no)) {
+            BitsetMath::Block active_disabled_ops =
+                block.second & active_ops[block.first];
+            while (active_disabled_ops != BitsetMath::zeros) {
+                int disabled_op_no = block.first * BitsetMath::bits_per_block +
+                    BitsetMath::lowest_bit_index(active_disabled_ops);
+                active_disabled_ops &= active_disabled_ops - 1;
                 get_disabled_vars(op_no, disabled_op_no, disabled_vars);
                 if (!disabled_vars.empty()) {     // == can_disable(op1_no, op2_no)
                     bool v_applicable_op_found = false;
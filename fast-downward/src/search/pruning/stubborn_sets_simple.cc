@@ -7,6 +7,7 @@
 
 
 using namespace std;
+using stubborn_sets::OperatorSet;
 
 namespace stubborn_sets_simple {
 StubbornSetsSimple::StubbornSetsSimple(const options::Options &opts)
@@ -20,20 +21,28 @@ void StubbornSetsSimple::initialize(const shared_ptr<AbstractTask> &task) {
     cout << "pruning method: stubborn sets simple" << endl;
 }
 
-const vector<int> &StubbornSetsSimple::get_interfering_operators(int op1_no) {
+const OperatorSet &StubbornSetsSimple::get_interfering_operators(int op1_no) {
     /*
-       TODO: as interference is symmetric, we only need to compute the
-       relation for operators (o1, o2) with (o1 < o2) and add a lookup
-       method that looks up (i, j) if i < j and (j, i) otherwise.
+       Two operators op1 and op2 interfere iff can_disable(op1, op2),
+       can_conflict(op1, op2) or can_disable(op2, op1). We collect the
+       operators satisfying each of the conditions from the operator sets
+       of the variables that op1 mentions.
+
+       TODO: as interference is symmetric, we only need to store the
+       relation for operators (o1, o2) with (o1 < o2).
     */
-    vector<int> &interfere_op1 = interference_relation[op1_no];
+    OperatorSet &interfere_op1 = interference_relation[op1_no];
     if (!interference_relation_computed[op1_no]) {
-        for (int op2_no = 0; op2_no < num_operators; ++op2_no) {
-            if (op1_no != op2_no && interfere(op1_no, op2_no)) {
-                interfere_op1.push_back(op2_no);
-            }
-        }
-        interfere_op1.shrink_to_fit();
+        interfering_ops.assign(num_operator_blocks, BitsetMath::zeros);
+        const vector<FactPair> &preconditions = sorted_op_preconditions[op1_no];
+        const vector<FactPair> &effects = sorted_op_effects[op1_no];
+        add_conflicting_operators(
+            effects, precondition_ops_on_var, precondition_ops, interfering_ops);
+        add_conflicting_operators(effects, writers, achievers, interfering_ops);
+        add_conflicting_operators(preconditions, writers, achievers, interfering_ops);
+        interfering_ops[BitsetMath::block_index(op1_no)] &=
+            ~BitsetMath::bit_mask(op1_no);
+        interfere_op1 = make_operator_set(interfering_ops);
         interference_relation_computed[op1_no] = true;
     }
     return interfere_op1;
@@ -41,16 +50,12 @@ const vector<int> &StubbornSetsSimple::get_interfering_operators(int op1_no) {
 
 // Add all operators that achieve the fact (var, value) to stubborn set.
 void StubbornSetsSimple::add_necessary_enabling_set(const FactPair &fact) {
-    for (int op_no : achievers[fact.var][fact.value]) {
-        mark_as_stubborn(op_no);
-    }
+    mark_as_stubborn(achievers[fact.var][fact.value]);
 }
 
 // Add all operators that interfere with op.
 void StubbornSetsSimple::add_interfering(int op_no) {
-    for (int interferer_no : get_interfering_operators(op_no)) {
-        mark_as_stubborn(interferer_no);
-    }
+    mark_as_stubborn(get_interfering_operators(op_no));
 }
 
 void StubbornSetsSimple::initialize_stubborn_set(const State &state) {
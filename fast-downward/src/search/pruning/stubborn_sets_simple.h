@@ -7,20 +7,16 @@ namespace stubborn_sets_simple {
 /* Implementation of simple instantiation of strong stubborn sets.
    Disjunctive action landmarks are computed trivially.*/
 class StubbornSetsSimple : public stubborn_sets::StubbornSets {
-    /* interference_relation[op1_no] contains all operator indices
-       of operators that interfere with op1. */
-    std::vector<std::vector<int>> interference_relation;
+    /* interference_relation[op1_no] contains all operators that
+       interfere with op1. It is computed on demand. */
+    std::vector<stubborn_sets::OperatorSet> interference_relation;
     std::vector<bool> interference_relation_computed;
+    std::vector<BitsetMath::Block> interfering_ops;
 
     void add_necessary_enabling_set(const FactPair &fact);
     void add_interfering(int op_no);
 
-    inline bool interfere(int op1_no, int op2_no) {
-        return can_disable(op1_no, op2_no) ||
-               can_conflict(op1_no, op2_no) ||
-               can_disable(op2_no, op1_no);
-    }
-    const std::vector<int> &get_interfering_operators(int op1_no);
+    const stubborn_sets::OperatorSet &get_interfering_operators(int op1_no);
 protected:
     virtual void initialize_stubborn_set(const State &state) override;
     virtual void handle_stubborn_operator(const State &state,
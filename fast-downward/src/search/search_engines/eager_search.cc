@@ -7,6 +7,7 @@
 #include "../pruning_method.h"
 
 #include "../algorithms/ordered_set.h"
+#include "../structural_symmetries/structural_symmetries.h"
 #include "../task_utils/successor_generator.h"
 
 #include "../utils/logging.h"
@@ -28,7 +29,9 @@ EagerSearch::EagerSearch(const Options &opts)
       f_evaluator(opts.get<shared_ptr<Evaluator>>("f_eval", nullptr)),
       preferred_operator_evaluators(opts.get_list<shared_ptr<Evaluator>>("preferred")),
       lazy_evaluator(opts.get<shared_ptr<Evaluator>>("lazy_evaluator", nullptr)),
-      pruning_method(opts.get<shared_ptr<PruningMethod>>("pruning")) {
+      pruning_method(opts.get<shared_ptr<PruningMethod>>("pruning")),
+      symmetries(opts.get<shared_ptr<structural_symmetries::StructuralSymmetries>>(
+                     "symmetries", nullptr)) {
     if (lazy_evaluator && !lazy_evaluator->does_cache_estimates()) {
         cerr << "lazy_evaluator must cache its estimates" << endl;
         utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
@@ -72,7 +75,23 @@ void EagerSearch::initialize() {
 
     path_dependent_evaluators.assign(evals.begin(), evals.end());
 
-    const GlobalState &initial_state = state_registry.get_initial_state();
+    if (symmetries) {
+        /*
+          Path-dependent evaluators would be notified of transitions to the
+          representatives of successor states, which are not transitions of
+          the task.
+        */
+        if (!path_dependent_evaluators.empty()) {
+            cerr << "Orbit search does not support path-dependent evaluators."
+                 << endl;
+            utils::exit_with(utils::ExitCode::SEARCH_UNSUPPORTED);
+        }
+        symmetries->initialize(task);
+        if (!symmetries->has_symmetries())
+            symmetries = nullptr;
+    }
+
+    GlobalState initial_state = get_initial_state();
     for (Evaluator *evaluator : path_dependent_evaluators) {
         evaluator->notify_initial_state(initial_state);
     }
@@ -173,8 +192,11 @@ SearchStatus EagerSearch::step() {
     }
 
     GlobalState s = node->get_state();
-    if (check_goal_and_set_plan(s))
+    if (check_goal_and_set_plan(s)) {
+        if (symmetries)
+            set_plan(symmetries->reconstruct_plan(get_plan()));
         return SOLVED;
+    }
 
     vector<OperatorID> applicable_ops;
     successor_generator.generate_applicable_ops(s, applicable_ops);
@@ -199,7 +221,7 @@ SearchStatus EagerSearch::step() {
         if ((node->get_real_g() + op.get_cost()) >= bound)
             continue;
 
-        GlobalState succ_state = state_registry.get_successor_state(s, op);
+        GlobalState succ_state = get_successor_state(s, op);
         statistics.inc_generated();
         bool is_preferred = preferred_operators.contains(op_id);
 
@@ -286,6 +308,31 @@ SearchStatus EagerSearch::step() {
     return IN_PROGRESS;
 }
 
+/*
+  With symmetries, we register the representative of a state instead of
+  the state itself. Goal states are mapped to goal states.
+*/
+GlobalState EagerSearch::get_initial_state() {
+    if (!symmetries)
+        return state_registry.get_initial_state();
+    vector<int> values = task_proxy.get_initial_state().get_values();
+    symmetries->canonicalize(values);
+    return state_registry.register_state(values);
+}
+
+GlobalState EagerSearch::get_successor_state(
+    const GlobalState &state, const OperatorProxy &op) {
+    if (!symmetries)
+        return state_registry.get_successor_state(state, op);
+    vector<int> values = state.unpack().get_values();
+    for (EffectProxy effect : op.get_effects()) {
+        FactPair fact = effect.get_fact().get_pair();
+        values[fact.var] = fact.value;
+    }
+    symmetries->canonicalize(values);
+    return state_registry.register_state(values);
+}
+
 void EagerSearch::reward_progress() {
     // Boost the "preferred operator" open lists somewhat whenever
     // one of the heuristics finds a state with a new best h value.
@@ -314,6 +361,12 @@ void EagerSearch::update_f_value_statistics(EvaluationContext &eval_context) {
 
 void add_options_to_parser(OptionParser &parser) {
     SearchEngine::add_pruning_option(parser);
+    parser.add_option<shared_ptr<structural_symmetries::StructuralSymmetries>>(
+        "symmetries",
+        "Structural symmetries for orbit search: only one representative "
+        "of each set of symmetric states is registered and expanded. "
+        "Not supported with path-dependent evaluators.",
+        OptionParser::NONE);
     SearchEngine::add_options_to_parser(parser);
 }
 }
@@ -15,6 +15,10 @@ class OptionParser;
 class Options;
 }
 
+namespace structural_symmetries {
+class StructuralSymmetries;
+}
+
 namespace eager_search {
 class EagerSearch : public SearchEngine {
     const bool reopen_closed_nodes;
@@ -27,7 +31,10 @@ class EagerSearch : public SearchEngine {
     std::shared_ptr<Evaluator> lazy_evaluator;
 
     std::shared_ptr<PruningMethod> pruning_method;
+    std::shared_ptr<structural_symmetries::StructuralSymmetries> symmetries;
 
+    GlobalState get_initial_state();
+    GlobalState get_successor_state(const GlobalState &state, const OperatorProxy &op);
     void start_f_value_statistics(EvaluationContext &eval_context);
     void update_f_value_statistics(EvaluationContext &eval_context);
     void reward_progress();
@@ -14,6 +14,8 @@ class StateID {
     template<typename>
     friend class PerStateArray;
     friend class PerStateBitset;
+    template<typename>
+    friend class OpenListEntryIDs;
 
     int value;
     explicit StateID(int value_)
@@ -82,6 +82,22 @@ GlobalState StateRegistry::get_successor_state(const GlobalState &predecessor, c
     return lookup_state(id);
 }
 
+GlobalState StateRegistry::register_state(const vector<int> &values) {
+    assert(static_cast<int>(values.size()) == num_variables);
+    PackedStateBin *buffer = new PackedStateBin[get_bins_per_state()];
+    // Avoid garbage values in half-full bins.
+    fill_n(buffer, get_bins_per_state(), 0);
+    for (int var = 0; var < num_variables; ++var) {
+        state_packer.set(buffer, var, values[var]);
+    }
+    axiom_evaluator.evaluate(buffer, state_packer);
+    state_data_pool.push_back(buffer);
+    // buffer is copied by push_back
+    delete[] buffer;
+    StateID id = insert_id_or_pop_state();
+    return lookup_state(id);
+}
+
 int StateRegistry::get_bins_per_state() const {
     return state_packer.get_num_bins();
 }
@@ -200,6 +200,13 @@ public:
     */
     GlobalState get_successor_state(const GlobalState &predecessor, const OperatorProxy &op);
 
+    /*
+      Returns the state with the given variable values and registers it if
+      this was not done before. Like get_successor_state, this includes
+      duplicate checking.
+    */
+    GlobalState register_state(const std::vector<int> &values);
+
     /*
       Returns the number of states registered so far.
     */
@@ -0,0 +1,538 @@
+#include "graph_automorphisms.h"
+
+#include "../utils/countdown_timer.h"
+#include "../utils/hash.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <numeric>
+
+using namespace std;
+
+namespace structural_symmetries {
+int ColoredGraph::add_vertex(int color) {
+    colors.push_back(color);
+    successors.emplace_back();
+    predecessors.emplace_back();
+    return colors.size() - 1;
+}
+
+void ColoredGraph::add_arc(int from, int to) {
+    successors[from].push_back(to);
+    predecessors[to].push_back(from);
+}
+
+void ColoredGraph::finalize() {
+    auto sort_unique = [](vector<int> &vertices) {
+            sort(vertices.begin(), vertices.end());
+            vertices.erase(unique(vertices.begin(), vertices.end()), vertices.end());
+        };
+    for (vector<int> &vertices : successors)
+        sort_unique(vertices);
+    for (vector<int> &vertices : predecessors)
+        sort_unique(vertices);
+}
+
+bool ColoredGraph::is_automorphism(const vector<int> &permutation) const {
+    int num_vertices = get_num_vertices();
+    vector<int> mapped_successors;
+    for (int vertex = 0; vertex < num_vertices; ++vertex) {
+        int image = permutation[vertex];
+        if (colors[image] != colors[vertex] ||
+            successors[image].size() != successors[vertex].size())
+            return false;
+        mapped_successors.clear();
+        for (int succ : successors[vertex])
+            mapped_successors.push_back(permutation[succ]);
+        sort(mapped_successors.begin(), mapped_successors.end());
+        if (mapped_successors != successors[image])
+            return false;
+    }
+    return true;
+}
+
+
+/*
+  Ordered partition of the vertices. The cells are consecutive ranges of
+  positions in the element array and are identified by their first
+  position. Cells are only ever split, so the first position of a cell
+  stays the first position of a cell.
+
+  Every split is recorded on a trail together with the vertices of the
+  split cell in their old order, so that the search can undo splits
+  instead of copying the partition. The order matters because the
+  search tries the vertices of a cell in this order.
+*/
+struct OrderedPartition {
+    vector<int> elements;
+    vector<int> positions;
+    vector<int> cell_starts;
+    // Cell size at the first position of every cell and 0 elsewhere.
+    vector<int> cell_sizes;
+    int num_cells;
+    // Start and size of every split cell in the order of the splits.
+    vector<pair<int, int>> split_cells;
+    // Vertices of the split cells before the splits.
+    vector<int> split_elements;
+
+    explicit OrderedPartition(const ColoredGraph &graph)
+        : elements(graph.get_num_vertices()),
+          positions(graph.get_num_vertices()),
+          cell_starts(graph.get_num_vertices()),
+          cell_sizes(graph.get_num_vertices(), 0),
+          num_cells(0) {
+        iota(elements.begin(), elements.end(), 0);
+        stable_sort(elements.begin(), elements.end(), [&](int v1, int v2) {
+                        return graph.get_color(v1) < graph.get_color(v2);
+                    });
+        int num_vertices = elements.size();
+        int start = 0;
+        for (int pos = 0; pos < num_vertices; ++pos) {
+            int vertex = elements[pos];
+            if (graph.get_color(vertex) != graph.get_color(elements[start])) {
+                start = pos;
+            }
+            if (start == pos)
+                ++num_cells;
+            positions[vertex] = pos;
+            cell_starts[vertex] = start;
+            ++cell_sizes[start];
+        }
+    }
+
+    int get_num_vertices() const {
+        return elements.size();
+    }
+
+    bool is_discrete() const {
+        return num_cells == get_num_vertices();
+    }
+
+    int get_first_non_singleton_cell() const {
+        int num_vertices = get_num_vertices();
+        for (int start = 0; start < num_vertices; start += cell_sizes[start]) {
+            if (cell_sizes[start] > 1)
+                return start;
+        }
+        return -1;
+    }
+
+    void swap_positions(int pos1, int pos2) {
+        swap(elements[pos1], elements[pos2]);
+        positions[elements[pos1]] = pos1;
+        positions[elements[pos2]] = pos2;
+    }
+
+    int get_num_splits() const {
+        return split_cells.size();
+    }
+
+    // Merge cells again until only the given number of splits is left.
+    void backtrack(int num_splits) {
+        while (get_num_splits() > num_splits) {
+            int start = split_cells.back().first;
+            int size = split_cells.back().second;
+            split_cells.pop_back();
+            int end = start + size;
+            for (int piece_start = start + cell_sizes[start]; piece_start < end;) {
+                int piece_size = cell_sizes[piece_start];
+                cell_sizes[piece_start] = 0;
+                piece_start += piece_size;
+                --num_cells;
+            }
+            cell_sizes[start] = size;
+            copy(split_elements.end() - size, split_elements.end(),
+                 elements.begin() + start);
+            split_elements.resize(split_elements.size() - size);
+            for (int pos = start; pos < end; ++pos) {
+                int vertex = elements[pos];
+                positions[vertex] = pos;
+                cell_starts[vertex] = start;
+            }
+        }
+    }
+
+    void record_split(int start, int size) {
+        split_cells.emplace_back(start, size);
+        split_elements.insert(split_elements.end(), elements.begin() + start,
+                              elements.begin() + start + size);
+    }
+
+    /*
+      Move the vertex into a new singleton cell at the end of its cell and
+      return the start of the new cell.
+    */
+    int individualize(int vertex) {
+        int start = cell_starts[vertex];
+        int size = cell_sizes[start];
+        assert(size > 1);
+        int new_start = start + size - 1;
+        record_split(start, size);
+        swap_positions(positions[vertex], new_start);
+        cell_sizes[start] = size - 1;
+        cell_sizes[new_start] = 1;
+        cell_starts[vertex] = new_start;
+        ++num_cells;
+        return new_start;
+    }
+};
+
+
+/*
+  Refines an ordered partition until it is equitable, i.e., until all
+  vertices in a cell have the same number of successors and the same
+  number of predecessors in every cell. Cells are split by these
+  numbers in increasing order, so refining the image of a partition
+  under an automorphism yields the image of the refined partition.
+  Following Hopcroft, the largest piece of a split cell is not used as
+  a splitter unless the cell was waiting to be used itself.
+*/
+class Refiner {
+    const ColoredGraph &graph;
+    vector<int> counts;
+    vector<int> touched_vertices;
+    vector<bool> is_touched_cell;
+    vector<int> touched_cells;
+    vector<bool> in_queue;
+    vector<int> queue;
+    vector<int> piece_starts;
+    utils::HashState trace;
+
+    void enqueue(int start) {
+        if (!in_queue[start]) {
+            in_queue[start] = true;
+            queue.push_back(start);
+        }
+    }
+
+    void split_cell(OrderedPartition &partition, int start,
+                    const int *touched_begin, const int *touched_end);
+    void split_by_neighbors(OrderedPartition &partition, int begin, int end,
+                            bool use_successors);
+public:
+    explicit Refiner(const ColoredGraph &graph)
+        : graph(graph),
+          counts(graph.get_num_vertices(), 0),
+          is_touched_cell(graph.get_num_vertices(), false),
+          in_queue(graph.get_num_vertices(), false) {
+    }
+
+    /*
+      Refine the partition with the given cells as initial splitters and
+      return a hash of the sequence of splits, which is an invariant of
+      the refinement.
+    */
+    uint64_t refine(OrderedPartition &partition, const vector<int> &splitters);
+};
+
+void Refiner::split_cell(OrderedPartition &partition, int start,
+                         const int *touched_begin, const int *touched_end) {
+    // The touched vertices of the cell are sorted by increasing count.
+    int size = partition.cell_sizes[start];
+    int num_touched = touched_end - touched_begin;
+    bool all_touched = (num_touched == size);
+    if (size == 1 ||
+        (all_touched && counts[*touched_begin] == counts[*(touched_end - 1)]))
+        return;
+    partition.record_split(start, size);
+
+    // Move the touched vertices to the end of the cell in their order.
+    int target = start + size;
+    for (const int *it = touched_end; it != touched_begin;) {
+        --it;
+        --target;
+        partition.swap_positions(partition.positions[*it], target);
+    }
+
+    piece_starts.clear();
+    piece_starts.push_back(start);
+    int first_touched_pos = start + size - num_touched;
+    if (!all_touched)
+        piece_starts.push_back(first_touched_pos);
+    for (int pos = first_touched_pos + 1; pos < start + size; ++pos) {
+        if (counts[partition.elements[pos]] != counts[partition.elements[pos - 1]])
+            piece_starts.push_back(pos);
+    }
+    piece_starts.push_back(start + size);
+
+    bool was_in_queue = in_queue[start];
+    int num_pieces = piece_starts.size() - 1;
+    int largest_piece = 0;
+    utils::feed(trace, start);
+    for (int i = 0; i < num_pieces; ++i) {
+        int piece_start = piece_starts[i];
+        int piece_size = piece_starts[i + 1] - piece_start;
+        utils::feed(trace, piece_size);
+        utils::feed(trace, counts[partition.elements[piece_start]]);
+        partition.cell_sizes[piece_start] = piece_size;
+        if (i > 0) {
+            for (int pos = piece_start; pos < piece_starts[i + 1]; ++pos)
+                partition.cell_starts[partition.elements[pos]] = piece_start;
+        }
+        int largest_size = piece_starts[largest_piece + 1] - piece_starts[largest_piece];
+        if (piece_size > largest_size)
+            largest_piece = i;
+    }
+    partition.num_cells += num_pieces - 1;
+
+    for (int i = 0; i < num_pieces; ++i) {
+        if (was_in_queue || i != largest_piece)
+            enqueue(piece_starts[i]);
+    }
+}
+
+void Refiner::split_by_neighbors(
+    OrderedPartition &partition, int begin, int end, bool use_successors) {
+    for (int pos = begin; pos < end; ++pos) {
+        int vertex = partition.elements[pos];
+        const vector<int> &neighbors = use_successors ?
+            graph.get_successors(vertex) : graph.get_predecessors(vertex);
+        for (int neighbor : neighbors) {
+            if (counts[neighbor]++ == 0)
+                touched_vertices.push_back(neighbor);
+        }
+    }
+    if (touched_vertices.empty())
+        return;
+
+    sort(touched_vertices.begin(), touched_vertices.end(), [&](int v1, int v2) {
+             int cell1 = partition.cell_starts[v1];
+             int cell2 = partition.cell_starts[v2];
+             return cell1 < cell2 || (cell1 == cell2 && counts[v1] < counts[v2]);
+         });
+    for (int vertex : touched_vertices) {
+        int cell = partition.cell_starts[vertex];
+        if (!is_touched_cell[cell]) {
+            is_touched_cell[cell] = true;
+            touched_cells.push_back(cell);
+        }
+    }
+
+    // Touched cells are ordered by their start like the touched vertices.
+    const int *touched_begin = touched_vertices.data();
+    for (int cell : touched_cells) {
+        const int *touched_end = touched_begin;
+        const int *touched_vertices_end =
+            touched_vertices.data() + touched_vertices.size();
+        while (touched_end != touched_vertices_end &&
+               partition.cell_starts[*touched_end] == cell)
+            ++touched_end;
+        split_cell(partition, cell, touched_begin, touched_end);
+        touched_begin = touched_end;
+        is_touched_cell[cell] = false;
+    }
+
+    for (int vertex : touched_vertices)
+        counts[vertex] = 0;
+    touched_vertices.clear();
+    touched_cells.clear();
+}
+
+uint64_t Refiner::refine(OrderedPartition &partition, const vector<int> &splitters) {
+    trace = utils::HashState();
+    for (int start : splitters)
+        enqueue(start);
+    for (size_t next = 0; next < queue.size(); ++next) {
+        int start = queue[next];
+        in_queue[start] = false;
+        if (partition.is_discrete())
+            continue;
+        int end = start + partition.cell_sizes[start];
+        split_by_neighbors(partition, start, end, true);
+        split_by_neighbors(partition, start, end, false);
+    }
+    queue.clear();
+    utils::feed(trace, partition.num_cells);
+    return trace.get_hash64();
+}
+
+
+static uint64_t extend_trace(uint64_t trace, int cell, uint64_t refinement_trace) {
+    utils::HashState hash_state;
+    utils::feed(hash_state, trace);
+    utils::feed(hash_state, cell);
+    utils::feed(hash_state, refinement_trace);
+    return hash_state.get_hash64();
+}
+
+class AutomorphismSearch {
+    const ColoredGraph &graph;
+    Refiner refiner;
+    utils::CountdownTimer timer;
+    bool is_aborted;
+
+    /*
+      The leftmost path of the search tree always individualizes the first
+      vertex of the first non-singleton cell. For every level, we store
+      the number of splits of the partition, the individualized cell and
+      vertex, and the trace of the refinements up to the level. The
+      partition of the first leaf is backtracked to explore the other
+      branches.
+    */
+    OrderedPartition partition;
+    vector<int> first_path_num_splits;
+    vector<int> first_path_cells;
+    vector<int> first_path_vertices;
+    vector<uint64_t> first_path_traces;
+    vector<int> first_leaf;
+
+    vector<vector<int>> generators;
+    // Union-find forest of the orbits of the generators.
+    vector<int> orbit_parents;
+
+    int get_leaf_depth() const {
+        return first_path_cells.size();
+    }
+
+    int find_orbit(int vertex);
+    void add_generator(vector<int> &&generator);
+    void compute_first_path();
+    bool search_automorphism(int depth, uint64_t trace);
+public:
+    AutomorphismSearch(const ColoredGraph &graph, double max_time);
+
+    vector<vector<int>> compute_generators(bool &is_complete);
+};
+
+AutomorphismSearch::AutomorphismSearch(const ColoredGraph &graph, double max_time)
+    : graph(graph),
+      refiner(graph),
+      timer(max_time),
+      is_aborted(false),
+      partition(graph),
+      orbit_parents(graph.get_num_vertices()) {
+    iota(orbit_parents.begin(), orbit_parents.end(), 0);
+}
+
+int AutomorphismSearch::find_orbit(int vertex) {
+    while (orbit_parents[vertex] != vertex) {
+        orbit_parents[vertex] = orbit_parents[orbit_parents[vertex]];
+        vertex = orbit_parents[vertex];
+    }
+    return vertex;
+}
+
+void AutomorphismSearch::add_generator(vector<int> &&generator) {
+    int num_vertices = graph.get_num_vertices();
+    for (int vertex = 0; vertex < num_vertices; ++vertex) {
+        int orbit1 = find_orbit(vertex);
+        int orbit2 = find_orbit(generator[vertex]);
+        if (orbit1 != orbit2)
+            orbit_parents[max(orbit1, orbit2)] = min(orbit1, orbit2);
+    }
+    generators.push_back(move(generator));
+}
+
+void AutomorphismSearch::compute_first_path() {
+    vector<int> splitters;
+    for (int start = 0; start < partition.get_num_vertices();
+         start += partition.cell_sizes[start]) {
+        splitters.push_back(start);
+    }
+    uint64_t trace = refiner.refine(partition, splitters);
+    first_path_traces.push_back(trace);
+    while (!partition.is_discrete()) {
+        int cell = partition.get_first_non_singleton_cell();
+        int vertex = partition.elements[cell];
+        first_path_num_splits.push_back(partition.get_num_splits());
+        first_path_cells.push_back(cell);
+        first_path_vertices.push_back(vertex);
+        int singleton = partition.individualize(vertex);
+        trace = extend_trace(trace, cell, refiner.refine(partition, {singleton}));
+        first_path_traces.push_back(trace);
+    }
+    first_leaf = partition.elements;
+}
+
+/*
+  Search the subtree below the current partition for a leaf that induces
+  an automorphism together with the first leaf. Only nodes with the same
+  refinement trace as the node of the first path at the same depth can
+  lead to such a leaf. The partition is restored before returning.
+*/
+bool AutomorphismSearch::search_automorphism(int depth, uint64_t trace) {
+    if (timer.is_expired()) {
+        is_aborted = true;
+        return false;
+    }
+    if (trace != first_path_traces[depth])
+        return false;
+    if (partition.is_discrete()) {
+        if (depth != get_leaf_depth())
+            return false;
+        int num_vertices = graph.get_num_vertices();
+        vector<int> generator(num_vertices);
+        for (int pos = 0; pos < num_vertices; ++pos)
+            generator[first_leaf[pos]] = partition.elements[pos];
+        if (!graph.is_automorphism(generator))
+            return false;
+        add_generator(move(generator));
+        return true;
+    }
+    if (depth >= get_leaf_depth())
+        return false;
+
+    int cell = first_path_cells[depth];
+    int size = partition.cell_sizes[cell];
+    vector<int> cell_vertices(partition.elements.begin() + cell,
+                              partition.elements.begin() + cell + size);
+    int num_splits = partition.get_num_splits();
+    for (int vertex : cell_vertices) {
+        int singleton = partition.individualize(vertex);
+        uint64_t child_trace = extend_trace(
+            trace, cell, refiner.refine(partition, {singleton}));
+        bool found = search_automorphism(depth + 1, child_trace);
+        partition.backtrack(num_splits);
+        if (found)
+            return true;
+        if (is_aborted)
+            return false;
+    }
+    return false;
+}
+
+vector<vector<int>> AutomorphismSearch::compute_generators(bool &is_complete) {
+    compute_first_path();
+
+    /*
+      Generators found at level i or deeper fix the vertices individualized
+      above level i. Going up from the leaf, we can therefore skip all
+      vertices in the orbit of the first path vertex and all vertices in
+      the orbit of a vertex for which no automorphism exists.
+    */
+    for (int level = get_leaf_depth() - 1; level >= 0 && !is_aborted; --level) {
+        int num_splits = first_path_num_splits[level];
+        partition.backtrack(num_splits);
+        int cell = first_path_cells[level];
+        int first_vertex = first_path_vertices[level];
+        vector<int> cell_vertices(
+            partition.elements.begin() + cell,
+            partition.elements.begin() + cell + partition.cell_sizes[cell]);
+        vector<int> failed_vertices;
+        for (int vertex : cell_vertices) {
+            int orbit = find_orbit(vertex);
+            if (orbit == find_orbit(first_vertex) ||
+                any_of(failed_vertices.begin(), failed_vertices.end(),
+                       [&](int failed) {return find_orbit(failed) == orbit;}))
+                continue;
+            int singleton = partition.individualize(vertex);
+            uint64_t trace = extend_trace(
+                first_path_traces[level], cell, refiner.refine(partition, {singleton}));
+            if (!search_automorphism(level + 1, trace))
+                failed_vertices.push_back(vertex);
+            partition.backtrack(num_splits);
+            if (is_aborted)
+                break;
+        }
+    }
+    is_complete = !is_aborted;
+    return move(generators);
+}
+
+vector<vector<int>> compute_automorphism_generators(
+    const ColoredGraph &graph, double max_time, bool &is_complete) {
+    AutomorphismSearch search(graph, max_time);
+    return search.compute_generators(is_complete);
+}
+}
@@ -0,0 +1,60 @@
+#ifndef STRUCTURAL_SYMMETRIES_GRAPH_AUTOMORPHISMS_H
+#define STRUCTURAL_SYMMETRIES_GRAPH_AUTOMORPHISMS_H
+
+#include <vector>
+
+namespace structural_symmetries {
+/*
+  Directed graph with colored vertices. An automorphism is a permutation
+  of the vertices that maps every vertex to a vertex of the same color
+  and every arc (u, v) to an arc.
+*/
+class ColoredGraph {
+    std::vector<int> colors;
+    std::vector<std::vector<int>> successors;
+    std::vector<std::vector<int>> predecessors;
+public:
+    // Add a vertex and return its ID. IDs are assigned consecutively.
+    int add_vertex(int color);
+    void add_arc(int from, int to);
+
+    int get_num_vertices() const {
+        return colors.size();
+    }
+
+    int get_color(int vertex) const {
+        return colors[vertex];
+    }
+
+    const std::vector<int> &get_successors(int vertex) const {
+        return successors[vertex];
+    }
+
+    const std::vector<int> &get_predecessors(int vertex) const {
+        return predecessors[vertex];
+    }
+
+    // Remove parallel arcs. Must be called before searching automorphisms.
+    void finalize();
+
+    bool is_automorphism(const std::vector<int> &permutation) const;
+};
+
+/*
+  Compute generators of the automorphism group of the graph with the
+  individualization-refinement method: the search tree branches on the
+  vertex that is separated from its cell and refines the resulting
+  ordered partition until it is equitable. Automorphisms are found by
+  comparing leaves of the tree with the leftmost leaf, and branches are
+  pruned with the orbits of the automorphisms found so far.
+
+  Each generator maps vertex v to generator[v]. If the search runs
+  longer than max_time seconds, it stops and returns the generators
+  found until then, which generate a subgroup of the automorphism group.
+  The flag is_complete tells whether the search finished.
+*/
+std::vector<std::vector<int>> compute_automorphism_generators(
+    const ColoredGraph &graph, double max_time, bool &is_complete);
+}
+
+#endif
@@ -0,0 +1,268 @@
+#include "structural_symmetries.h"
+
+#include "graph_automorphisms.h"
+
+#include "../option_parser.h"
+#include "../plugin.h"
+#include "../task_proxy.h"
+
+#include "../task_utils/task_properties.h"
+#include "../utils/markup.h"
+#include "../utils/timer.h"
+
+#include <algorithm>
+#include <cassert>
+#include <numeric>
+
+using namespace std;
+
+namespace structural_symmetries {
+static const int VARIABLE_COLOR = 0;
+static const int FACT_COLOR = 1;
+static const int GOAL_FACT_COLOR = 2;
+static const int FIRST_OPERATOR_COLOR = 3;
+
+StructuralSymmetries::StructuralSymmetries(const Options &opts)
+    : max_time(opts.get<double>("max_time")) {
+}
+
+void StructuralSymmetries::initialize(const shared_ptr<AbstractTask> &task_) {
+    task = task_;
+    TaskProxy task_proxy(*task);
+    task_properties::verify_no_axioms(task_proxy);
+    task_properties::verify_no_conditional_effects(task_proxy);
+
+    fact_offsets.clear();
+    int num_facts = 0;
+    for (VariableProxy var : task_proxy.get_variables()) {
+        fact_offsets.push_back(num_facts);
+        num_facts += var.get_domain_size();
+    }
+    permuted_values.resize(fact_offsets.size());
+
+    utils::Timer timer;
+    compute_generators();
+    cout << "Number of symmetry generators: " << generators.size() << endl;
+    cout << "Time for computing symmetries: " << timer << endl;
+}
+
+void StructuralSymmetries::compute_generators() {
+    TaskProxy task_proxy(*task);
+    VariablesProxy variables = task_proxy.get_variables();
+    OperatorsProxy operators = task_proxy.get_operators();
+    int num_variables = variables.size();
+    int num_facts = fact_offsets.empty() ? 0 :
+        fact_offsets.back() + variables[num_variables - 1].get_domain_size();
+    int num_operators = operators.size();
+
+    vector<bool> is_goal_fact(num_facts, false);
+    for (FactProxy goal : task_proxy.get_goals()) {
+        FactPair fact = goal.get_pair();
+        is_goal_fact[fact_offsets[fact.var] + fact.value] = true;
+    }
+    vector<int> costs;
+    for (OperatorProxy op : operators)
+        costs.push_back(op.get_cost());
+    sort(costs.begin(), costs.end());
+    costs.erase(unique(costs.begin(), costs.end()), costs.end());
+
+    // Vertices are the variables, then the facts, then the operators.
+    int first_fact_vertex = num_variables;
+    int first_operator_vertex = first_fact_vertex + num_facts;
+    ColoredGraph graph;
+    for (int var = 0; var < num_variables; ++var)
+        graph.add_vertex(VARIABLE_COLOR);
+    for (int fact = 0; fact < num_facts; ++fact)
+        graph.add_vertex(is_goal_fact[fact] ? GOAL_FACT_COLOR : FACT_COLOR);
+    for (OperatorProxy op : operators) {
+        int cost_index = lower_bound(costs.begin(), costs.end(), op.get_cost()) - costs.begin();
+        graph.add_vertex(FIRST_OPERATOR_COLOR + cost_index);
+    }
+    for (VariableProxy var : variables) {
+        for (int value = 0; value < var.get_domain_size(); ++value) {
+            graph.add_arc(var.get_id(),
+                          first_fact_vertex + fact_offsets[var.get_id()] + value);
+        }
+    }
+    for (OperatorProxy op : operators) {
+        int op_vertex = first_operator_vertex + op.get_id();
+        for (FactProxy pre : op.get_preconditions()) {
+            FactPair fact = pre.get_pair();
+            graph.add_arc(first_fact_vertex + fact_offsets[fact.var] + fact.value,
+                          op_vertex);
+        }
+        for (EffectProxy effect : op.get_effects()) {
+            FactPair fact = effect.get_fact().get_pair();
+            graph.add_arc(op_vertex,
+                          first_fact_vertex + fact_offsets[fact.var] + fact.value);
+        }
+    }
+    graph.finalize();
+
+    bool is_complete;
+    vector<vector<int>> automorphisms =
+        compute_automorphism_generators(graph, max_time, is_complete);
+    if (!is_complete) {
+        cout << "Symmetry computation reached the time limit, "
+             << "using the symmetries found so far." << endl;
+    }
+
+    generators.clear();
+    for (const vector<int> &automorphism : automorphisms) {
+        Permutation permutation;
+        permutation.var_images.assign(automorphism.begin(),
+                                      automorphism.begin() + num_variables);
+        permutation.value_images.resize(num_facts);
+        for (int var = 0; var < num_variables; ++var) {
+            int var_image = permutation.var_images[var];
+            bool is_moved = (var_image != var);
+            int domain_size = variables[var].get_domain_size();
+            for (int value = 0; value < domain_size; ++value) {
+                int fact = fact_offsets[var] + value;
+                int fact_image = automorphism[first_fact_vertex + fact] - first_fact_vertex;
+                int value_image = fact_image - fact_offsets[var_image];
+                assert(value_image >= 0 &&
+                       value_image < variables[var_image].get_domain_size());
+                permutation.value_images[fact] = value_image;
+                if (value_image != value)
+                    is_moved = true;
+            }
+            if (is_moved)
+                permutation.moved_vars.push_back(var);
+        }
+        // Symmetries that only permute operators do not affect states.
+        if (permutation.moved_vars.empty())
+            continue;
+        permutation.operator_images.resize(num_operators);
+        for (int op_no = 0; op_no < num_operators; ++op_no) {
+            permutation.operator_images[op_no] =
+                automorphism[first_operator_vertex + op_no] - first_operator_vertex;
+        }
+        generators.push_back(move(permutation));
+    }
+}
+
+void StructuralSymmetries::canonicalize(vector<int> &values, vector<int> *trace) {
+    /*
+      Apply generators as long as one of them leads to a lexicographically
+      smaller state. Only the moved variables of a generator change, so we
+      only need to compare and copy those.
+    */
+    permuted_values = values;
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (size_t i = 0; i < generators.size(); ++i) {
+            const Permutation &generator = generators[i];
+            for (int var : generator.moved_vars) {
+                permuted_values[generator.var_images[var]] =
+                    generator.value_images[fact_offsets[var] + values[var]];
+            }
+            bool is_smaller = false;
+            for (int var : generator.moved_vars) {
+                if (permuted_values[var] != values[var]) {
+                    is_smaller = permuted_values[var] < values[var];
+                    break;
+                }
+            }
+            if (is_smaller) {
+                for (int var : generator.moved_vars)
+                    values[var] = permuted_values[var];
+                if (trace)
+                    trace->push_back(i);
+                changed = true;
+            } else {
+                for (int var : generator.moved_vars)
+                    permuted_values[var] = values[var];
+            }
+        }
+    }
+}
+
+void StructuralSymmetries::apply_trace(
+    const vector<int> &trace, vector<int> &operator_images) const {
+    for (int generator_index : trace) {
+        const vector<int> &images = generators[generator_index].operator_images;
+        for (int &image : operator_images)
+            image = images[image];
+    }
+}
+
+Plan StructuralSymmetries::reconstruct_plan(const Plan &plan) {
+    /*
+      Let tau be the composition of all permutations applied during
+      canonicalization so far. The representative reached by the plan
+      prefix is the image under tau of the state that the reconstructed
+      prefix reaches, so the next operator of the task is the preimage of
+      the next operator of the plan under tau.
+    */
+    TaskProxy task_proxy(*task);
+    OperatorsProxy operators = task_proxy.get_operators();
+    vector<int> operator_images(operators.size());
+    iota(operator_images.begin(), operator_images.end(), 0);
+
+    State state = task_proxy.get_initial_state();
+    vector<int> values = state.get_values();
+    vector<int> trace;
+    canonicalize(values, &trace);
+    apply_trace(trace, operator_images);
+
+    Plan result;
+    result.reserve(plan.size());
+    for (OperatorID op_id : plan) {
+        int op_no = find(operator_images.begin(), operator_images.end(),
+                         op_id.get_index()) - operator_images.begin();
+        OperatorProxy op = operators[op_no];
+        assert(task_properties::is_applicable(op, state));
+        state = state.get_successor(op);
+        result.emplace_back(op_no);
+
+        for (EffectProxy effect : operators[op_id].get_effects()) {
+            FactPair fact = effect.get_fact().get_pair();
+            values[fact.var] = fact.value;
+        }
+        trace.clear();
+        canonicalize(values, &trace);
+        apply_trace(trace, operator_images);
+    }
+    assert(task_properties::is_goal_state(task_proxy, state));
+    return result;
+}
+
+static shared_ptr<StructuralSymmetries> _parse(OptionParser &parser) {
+    parser.document_synopsis(
+        "Structural symmetries",
+        "Symmetries of the task computed as automorphisms of its problem "
+        "description graph. Eager search uses them for orbit search, i.e., "
+        "it only registers one representative of every set of symmetric "
+        "states. For details, see" + utils::format_conference_reference(
+            {"Nir Pochter", "Aviv Zohar", "Jeffrey S. Rosenschein"},
+            "Exploiting Problem Symmetries in State-Based Planners",
+            "https://www.aaai.org/ocs/index.php/AAAI/AAAI11/paper/view/3732",
+            "Proceedings of the Twenty-Fifth AAAI Conference on Artificial "
+            "Intelligence (AAAI 2011)",
+            "1004-1009",
+            "AAAI Press",
+            "2011"));
+    parser.document_language_support("axioms", "not supported");
+    parser.document_language_support("conditional effects", "not supported");
+    parser.add_option<double>(
+        "max_time",
+        "maximum time in seconds for computing the symmetries. If the time "
+        "limit is reached, the symmetries found until then are used.",
+        "10.0",
+        Bounds("0.0", "infinity"));
+
+    Options opts = parser.parse();
+    if (parser.dry_run())
+        return nullptr;
+    return make_shared<StructuralSymmetries>(opts);
+}
+
+static Plugin<StructuralSymmetries> _plugin("structural_symmetries", _parse);
+
+static PluginTypePlugin<StructuralSymmetries> _type_plugin(
+    "StructuralSymmetries",
+    "Symmetries of the task that search engines can use to prune "
+    "symmetric states.");
+}
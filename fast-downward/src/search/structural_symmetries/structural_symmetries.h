@@ -0,0 +1,88 @@
+#ifndef STRUCTURAL_SYMMETRIES_STRUCTURAL_SYMMETRIES_H
+#define STRUCTURAL_SYMMETRIES_STRUCTURAL_SYMMETRIES_H
+
+#include "../plan_manager.h"
+
+#include <memory>
+#include <vector>
+
+class AbstractTask;
+
+namespace options {
+class Options;
+}
+
+namespace structural_symmetries {
+/*
+  Symmetry of a task: permutation of its variables, facts and operators
+  that maps operators to operators with the same cost, preconditions and
+  effects, and the goal to itself. The image of a state s is the state
+  that assigns value_images[fact] to var_images[var] for every fact
+  (var, value) of s.
+*/
+struct Permutation {
+    std::vector<int> var_images;
+    // Indexed by fact ID, see StructuralSymmetries::fact_offsets.
+    std::vector<int> value_images;
+    std::vector<int> operator_images;
+    // Sorted variables whose values can change when applying the permutation.
+    std::vector<int> moved_vars;
+};
+
+/*
+  Structural symmetries of a task, computed as the automorphisms of its
+  problem description graph (Pochter, Zohar and Rosenschein, AAAI 2011;
+  Shleyfman et al., AAAI 2015). The graph has a vertex for every
+  variable, fact and operator, and arcs from variables to their facts,
+  from preconditions to operators and from operators to effects. Goal
+  facts and operators with different costs have different colors, so
+  the symmetries preserve plans and their costs.
+
+  The symmetries are used for orbit search: a search that only
+  registers one representative of each set of symmetric states. The
+  representative is the lexicographically smallest state that a greedy
+  descent along the generators of the symmetry group reaches. This
+  does not always find the same representative for symmetric states,
+  but it is fast, and the search stays complete and optimal either
+  way. Plans found in the space of representatives are mapped back to
+  plans of the task with reconstruct_plan().
+*/
+class StructuralSymmetries {
+    const double max_time;
+
+    std::shared_ptr<AbstractTask> task;
+    // The facts of variable var have the IDs fact_offsets[var] + value.
+    std::vector<int> fact_offsets;
+    std::vector<Permutation> generators;
+    // Scratch space for canonicalize().
+    std::vector<int> permuted_values;
+
+    void compute_generators();
+    void apply_trace(const std::vector<int> &trace,
+                     std::vector<int> &operator_images) const;
+public:
+    explicit StructuralSymmetries(const options::Options &opts);
+
+    void initialize(const std::shared_ptr<AbstractTask> &task);
+
+    bool has_symmetries() const {
+        return !generators.empty();
+    }
+
+    /*
+      Replace the values of a state by those of its representative. If
+      trace is given, the indices of the generators that were applied
+      are appended to it in order.
+    */
+    void canonicalize(std::vector<int> &values, std::vector<int> *trace = nullptr);
+
+    /*
+      Map a plan found by orbit search, in which every operator is
+      applicable in the representative of the state reached by the
+      previous operators, to a plan for the task.
+    */
+    Plan reconstruct_plan(const Plan &plan);
+};
+}
+
+#endif
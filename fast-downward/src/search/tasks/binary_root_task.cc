@@ -0,0 +1,619 @@
+#include "binary_root_task.h"
+
+#include "../axioms.h"
+#include "../task_proxy.h"
+
+#include "../utils/memory.h"
+#include "../utils/system.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+
+#if OPERATING_SYSTEM != WINDOWS
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+using utils::ExitCode;
+
+namespace tasks {
+static const int BYTE_ORDER_MARK = 0x01020304;
+
+static_assert(sizeof(FactPair) == 2 * sizeof(int),
+              "Binary task files store facts as pairs of ints.");
+
+static void exit_with_format_error(const string &msg) {
+    cerr << "Invalid binary task file: " << msg << endl;
+    utils::exit_with(ExitCode::SEARCH_INPUT_ERROR);
+}
+
+/*
+  Contents of a binary task file, either mapped into memory or copied into
+  a buffer.
+*/
+class TaskFileContents {
+    const char *data;
+    size_t size;
+    vector<char> buffer;
+    void *mapping;
+
+    bool try_to_map_standard_input();
+public:
+    explicit TaskFileContents(istream &in);
+    ~TaskFileContents();
+
+    TaskFileContents(const TaskFileContents &) = delete;
+    TaskFileContents &operator=(const TaskFileContents &) = delete;
+
+    const char *get_data() const {
+        return data;
+    }
+
+    size_t get_size() const {
+        return size;
+    }
+
+    bool is_mapped() const {
+        return mapping != nullptr;
+    }
+};
+
+TaskFileContents::TaskFileContents(istream &in)
+    : data(nullptr),
+      size(0),
+      mapping(nullptr) {
+    if (&in == &cin && try_to_map_standard_input())
+        return;
+    buffer.assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+    data = buffer.data();
+    size = buffer.size();
+}
+
+TaskFileContents::~TaskFileContents() {
+#if OPERATING_SYSTEM != WINDOWS
+    if (mapping)
+        munmap(mapping, size);
+#endif
+}
+
+bool TaskFileContents::try_to_map_standard_input() {
+#if OPERATING_SYSTEM == WINDOWS
+    return false;
+#else
+    /*
+      The standard input stream has already buffered the beginning of the
+      file to detect its format, which moved the file offset. We map the
+      whole file regardless and rely on the header checks to detect input
+      that does not start at the beginning of the file.
+    */
+    struct stat file_status;
+    if (fstat(STDIN_FILENO, &file_status) == -1 ||
+        !S_ISREG(file_status.st_mode) || file_status.st_size == 0) {
+        return false;
+    }
+    size_t file_size = file_status.st_size;
+    void *address = mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE,
+                         STDIN_FILENO, 0);
+    if (address == MAP_FAILED)
+        return false;
+    mapping = address;
+    data = static_cast<const char *>(address);
+    size = file_size;
+    return true;
+#endif
+}
+
+
+class BinaryRootTask : public AbstractTask {
+    unique_ptr<TaskFileContents> contents;
+    BinaryTaskHeader header;
+
+    const int *domain_sizes;
+    const int *axiom_layers;
+    const int *fact_offsets;
+    const int *default_axiom_values;
+    const FactPair *goals;
+    const int *costs;
+    const int *precondition_offsets;
+    const FactPair *preconditions;
+    const int *effect_offsets;
+    const FactPair *effects;
+    const int *effect_condition_offsets;
+    const FactPair *effect_conditions;
+    const int *mutex_offsets;
+    const FactPair *mutexes;
+    const int *name_offsets;
+    const char *names;
+
+    vector<int> initial_state_values;
+
+    void read_header();
+    void set_arrays();
+    void validate() const;
+    void validate_fact(const FactPair &fact) const;
+    void validate_offsets(const int *offsets, int count, int end) const;
+
+    int get_operator_or_axiom_index(int index, bool is_axiom) const {
+        assert(index >= 0 &&
+               index < (is_axiom ? header.num_axioms : header.num_operators));
+        return is_axiom ? header.num_operators + index : index;
+    }
+
+    int get_effect_index(int op_index, int eff_index, bool is_axiom) const {
+        int index = get_operator_or_axiom_index(op_index, is_axiom);
+        assert(eff_index >= 0 &&
+               eff_index < effect_offsets[index + 1] - effect_offsets[index]);
+        return effect_offsets[index] + eff_index;
+    }
+
+    string get_name(int name_index) const {
+        return string(names + name_offsets[name_index],
+                      names + name_offsets[name_index + 1]);
+    }
+
+public:
+    explicit BinaryRootTask(unique_ptr<TaskFileContents> contents);
+
+    virtual int get_num_variables() const override;
+    virtual string get_variable_name(int var) const override;
+    virtual int get_variable_domain_size(int var) const override;
+    virtual int get_variable_axiom_layer(int var) const override;
+    virtual int get_variable_default_axiom_value(int var) const override;
+    virtual string get_fact_name(const FactPair &fact) const override;
+    virtual bool are_facts_mutex(
+        const FactPair &fact1, const FactPair &fact2) const override;
+
+    virtual int get_operator_cost(int index, bool is_axiom) const override;
+    virtual string get_operator_name(
+        int index, bool is_axiom) const override;
+    virtual int get_num_operators() const override;
+    virtual int get_num_operator_preconditions(
+        int index, bool is_axiom) const override;
+    virtual FactPair get_operator_precondition(
+        int op_index, int fact_index, bool is_axiom) const override;
+    virtual int get_num_operator_effects(
+        int op_index, bool is_axiom) const override;
+    virtual int get_num_operator_effect_conditions(
+        int op_index, int eff_index, bool is_axiom) const override;
+    virtual FactPair get_operator_effect_condition(
+        int op_index, int eff_index, int cond_index, bool is_axiom) const override;
+    virtual FactPair get_operator_effect(
+        int op_index, int eff_index, bool is_axiom) const override;
+    virtual int convert_operator_index(
+        int index, const AbstractTask *ancestor_task) const override;
+
+    virtual int get_num_axioms() const override;
+
+    virtual int get_num_goals() const override;
+    virtual FactPair get_goal_fact(int index) const override;
+
+    virtual vector<int> get_initial_state_values() const override;
+    virtual void convert_state_values(
+        vector<int> &values,
+        const AbstractTask *ancestor_task) const override;
+};
+
+BinaryRootTask::BinaryRootTask(unique_ptr<TaskFileContents> contents_)
+    : contents(move(contents_)) {
+    read_header();
+    set_arrays();
+    validate();
+
+    initial_state_values.assign(
+        default_axiom_values, default_axiom_values + header.num_variables);
+    /*
+      HACK: We use a TaskProxy to access g_axiom_evaluators here which assumes
+      that this task is completely constructed.
+    */
+    AxiomEvaluator &axiom_evaluator = g_axiom_evaluators[TaskProxy(*this)];
+    axiom_evaluator.evaluate(initial_state_values);
+}
+
+void BinaryRootTask::read_header() {
+    if (contents->get_size() < sizeof(BinaryTaskHeader))
+        exit_with_format_error("file is too short.");
+    memcpy(&header, contents->get_data(), sizeof(BinaryTaskHeader));
+    if (memcmp(header.magic, BINARY_TASK_MAGIC, sizeof(BINARY_TASK_MAGIC)) != 0)
+        exit_with_format_error("wrong magic bytes.");
+    if (header.version != BINARY_TASK_VERSION) {
+        exit_with_format_error(
+            "expected version " + to_string(BINARY_TASK_VERSION) +
+            ", got " + to_string(header.version) + ".");
+    }
+    if (header.byte_order_mark != BYTE_ORDER_MARK)
+        exit_with_format_error("file was written with a different byte order.");
+
+    const int counts[] = {
+        header.num_variables, header.num_facts, header.num_goals,
+        header.num_operators, header.num_axioms, header.num_preconditions,
+        header.num_effects, header.num_effect_conditions, header.num_mutexes,
+        header.num_name_bytes};
+    for (int count : counts) {
+        if (count < 0)
+            exit_with_format_error("negative size in header.");
+    }
+
+    int64_t num_variables = header.num_variables;
+    int64_t num_operators_and_axioms =
+        static_cast<int64_t>(header.num_operators) + header.num_axioms;
+    int64_t num_ints =
+        4 * num_variables + 1 +
+        2 * static_cast<int64_t>(header.num_goals) +
+        num_operators_and_axioms +
+        2 * (num_operators_and_axioms + 1) +
+        2 * static_cast<int64_t>(header.num_preconditions) +
+        2 * static_cast<int64_t>(header.num_effects) +
+        static_cast<int64_t>(header.num_effects) + 1 +
+        2 * static_cast<int64_t>(header.num_effect_conditions) +
+        static_cast<int64_t>(header.num_facts) + 1 +
+        2 * static_cast<int64_t>(header.num_mutexes) +
+        num_variables + header.num_facts + header.num_operators + 1;
+    uint64_t expected_size = sizeof(BinaryTaskHeader) +
+        num_ints * sizeof(int) + header.num_name_bytes;
+    if (contents->get_size() != expected_size) {
+        exit_with_format_error(
+            "expected " + to_string(expected_size) + " bytes, got " +
+            to_string(contents->get_size()) + ".");
+    }
+}
+
+void BinaryRootTask::set_arrays() {
+    const int *pos = reinterpret_cast<const int *>(
+        contents->get_data() + sizeof(BinaryTaskHeader));
+    auto take_ints = [&pos](int count) {
+            const int *result = pos;
+            pos += count;
+            return result;
+        };
+    auto take_facts = [&pos](int count) {
+            const FactPair *result = reinterpret_cast<const FactPair *>(pos);
+            pos += 2 * count;
+            return result;
+        };
+    int num_operators_and_axioms = header.num_operators + header.num_axioms;
+    domain_sizes = take_ints(header.num_variables);
+    axiom_layers = take_ints(header.num_variables);
+    fact_offsets = take_ints(header.num_variables + 1);
+    default_axiom_values = take_ints(header.num_variables);
+    goals = take_facts(header.num_goals);
+    costs = take_ints(num_operators_and_axioms);
+    precondition_offsets = take_ints(num_operators_and_axioms + 1);
+    preconditions = take_facts(header.num_preconditions);
+    effect_offsets = take_ints(num_operators_and_axioms + 1);
+    effects = take_facts(header.num_effects);
+    effect_condition_offsets = take_ints(header.num_effects + 1);
+    effect_conditions = take_facts(header.num_effect_conditions);
+    mutex_offsets = take_ints(header.num_facts + 1);
+    mutexes = take_facts(header.num_mutexes);
+    name_offsets = take_ints(
+        header.num_variables + header.num_facts + header.num_operators + 1);
+    names = reinterpret_cast<const char *>(pos);
+}
+
+void BinaryRootTask::validate_fact(const FactPair &fact) const {
+    if (fact.var < 0 || fact.var >= header.num_variables) {
+        cerr << "Invalid variable id: " << fact.var << endl;
+        utils::exit_with(ExitCode::SEARCH_INPUT_ERROR);
+    }
+    if (fact.value < 0 || fact.value >= domain_sizes[fact.var]) {
+        cerr << "Invalid value for variable " << fact.var << ": " << fact.value << endl;
+        utils::exit_with(ExitCode::SEARCH_INPUT_ERROR);
+    }
+}
+
+void BinaryRootTask::validate_offsets(
+    const int *offsets, int count, int end) const {
+    if (offsets[0] != 0 || offsets[count] != end)
+        exit_with_format_error("offsets do not cover their array.");
+    for (int i = 0; i < count; ++i) {
+        if (offsets[i] > offsets[i + 1])
+            exit_with_format_error("offsets are not sorted.");
+    }
+}
+
+void BinaryRootTask::validate() const {
+    /*
+      We check all offsets and facts, so that the accessors cannot read
+      outside of the file. Names are not checked because they are only
+      read when needed.
+
+      Axiom layers index per-layer data in the axiom evaluator. A task
+      has at most one layer per variable, so valid layers lie in
+      [-1, num_variables - 1], where -1 marks non-derived variables.
+    */
+    int max_layer = header.num_variables - 1;
+    for (int var = 0; var < header.num_variables; ++var) {
+        if (domain_sizes[var] <= 0 ||
+            fact_offsets[var + 1] - fact_offsets[var] != domain_sizes[var]) {
+            exit_with_format_error("inconsistent domain sizes.");
+        }
+        if (axiom_layers[var] < -1 || axiom_layers[var] > max_layer) {
+            exit_with_format_error(
+                "invalid axiom layer " + to_string(axiom_layers[var]) +
+                " for variable " + to_string(var) + ".");
+        }
+        // Checks that the default value lies in the variable's domain.
+        validate_fact(FactPair(var, default_axiom_values[var]));
+    }
+    validate_offsets(fact_offsets, header.num_variables, header.num_facts);
+    if (header.num_goals == 0) {
+        cerr << "Task has no goal condition!" << endl;
+        utils::exit_with(ExitCode::SEARCH_INPUT_ERROR);
+    }
+    for (int i = 0; i < header.num_goals; ++i)
+        validate_fact(goals[i]);
+
+    int num_operators_and_axioms = header.num_operators + header.num_axioms;
+    for (int i = 0; i < num_operators_and_axioms; ++i) {
+        if (costs[i] < 0)
+            exit_with_format_error("negative operator cost.");
+    }
+    validate_offsets(precondition_offsets, num_operators_and_axioms,
+                     header.num_preconditions);
+    for (int i = 0; i < header.num_preconditions; ++i)
+        validate_fact(preconditions[i]);
+    validate_offsets(effect_offsets, num_operators_and_axioms,
+                     header.num_effects);
+    for (int i = 0; i < header.num_effects; ++i)
+        validate_fact(effects[i]);
+    validate_offsets(effect_condition_offsets, header.num_effects,
+                     header.num_effect_conditions);
+    for (int i = 0; i < header.num_effect_conditions; ++i)
+        validate_fact(effect_conditions[i]);
+    validate_offsets(mutex_offsets, header.num_facts, header.num_mutexes);
+    for (int i = 0; i < header.num_mutexes; ++i)
+        validate_fact(mutexes[i]);
+    validate_offsets(
+        name_offsets,
+        header.num_variables + header.num_facts + header.num_operators,
+        header.num_name_bytes);
+}
+
+int BinaryRootTask::get_num_variables() const {
+    return header.num_variables;
+}
+
+string BinaryRootTask::get_variable_name(int var) const {
+    assert(var >= 0 && var < header.num_variables);
+    return get_name(var);
+}
+
+int BinaryRootTask::get_variable_domain_size(int var) const {
+    assert(var >= 0 && var < header.num_variables);
+    return domain_sizes[var];
+}
+
+int BinaryRootTask::get_variable_axiom_layer(int var) const {
+    assert(var >= 0 && var < header.num_variables);
+    return axiom_layers[var];
+}
+
+int BinaryRootTask::get_variable_default_axiom_value(int var) const {
+    assert(var >= 0 && var < header.num_variables);
+    return default_axiom_values[var];
+}
+
+string BinaryRootTask::get_fact_name(const FactPair &fact) const {
+    assert(fact.value >= 0 && fact.value < get_variable_domain_size(fact.var));
+    return get_name(header.num_variables + fact_offsets[fact.var] + fact.value);
+}
+
+bool BinaryRootTask::are_facts_mutex(
+    const FactPair &fact1, const FactPair &fact2) const {
+    if (fact1.var == fact2.var) {
+        // Same variable: mutex iff different value.
+        return fact1.value != fact2.value;
+    }
+    int fact_id = fact_offsets[fact1.var] + fact1.value;
+    return binary_search(mutexes + mutex_offsets[fact_id],
+                         mutexes + mutex_offsets[fact_id + 1], fact2);
+}
+
+int BinaryRootTask::get_operator_cost(int index, bool is_axiom) const {
+    return costs[get_operator_or_axiom_index(index, is_axiom)];
+}
+
+string BinaryRootTask::get_operator_name(int index, bool is_axiom) const {
+    // Axioms have no names in the translator output either.
+    if (is_axiom)
+        return "<axiom>";
+    assert(index >= 0 && index < header.num_operators);
+    return get_name(header.num_variables + header.num_facts + index);
+}
+
+int BinaryRootTask::get_num_operators() const {
+    return header.num_operators;
+}
+
+int BinaryRootTask::get_num_operator_preconditions(int index, bool is_axiom) const {
+    int op = get_operator_or_axiom_index(index, is_axiom);
+    return precondition_offsets[op + 1] - precondition_offsets[op];
+}
+
+FactPair BinaryRootTask::get_operator_precondition(
+    int op_index, int fact_index, bool is_axiom) const {
+    assert(fact_index >= 0 &&
+           fact_index < get_num_operator_preconditions(op_index, is_axiom));
+    int op = get_operator_or_axiom_index(op_index, is_axiom);
+    return preconditions[precondition_offsets[op] + fact_index];
+}
+
+int BinaryRootTask::get_num_operator_effects(int op_index, bool is_axiom) const {
+    int op = get_operator_or_axiom_index(op_index, is_axiom);
+    return effect_offsets[op + 1] - effect_offsets[op];
+}
+
+int BinaryRootTask::get_num_operator_effect_conditions(
+    int op_index, int eff_index, bool is_axiom) const {
+    int effect = get_effect_index(op_index, eff_index, is_axiom);
+    return effect_condition_offsets[effect + 1] - effect_condition_offsets[effect];
+}
+
+FactPair BinaryRootTask::get_operator_effect_condition(
+    int op_index, int eff_index, int cond_index, bool is_axiom) const {
+    int effect = get_effect_index(op_index, eff_index, is_axiom);
+    assert(cond_index >= 0 && cond_index <
+           effect_condition_offsets[effect + 1] - effect_condition_offsets[effect]);
+    return effect_conditions[effect_condition_offsets[effect] + cond_index];
+}
+
+FactPair BinaryRootTask::get_operator_effect(
+    int op_index, int eff_index, bool is_axiom) const {
+    return effects[get_effect_index(op_index, eff_index, is_axiom)];
+}
+
+int BinaryRootTask::convert_operator_index(
+    int index, const AbstractTask *ancestor_task) const {
+    if (this != ancestor_task) {
+        ABORT("Invalid operator ID conversion");
+    }
+    return index;
+}
+
+int BinaryRootTask::get_num_axioms() const {
+    return header.num_axioms;
+}
+
+int BinaryRootTask::get_num_goals() const {
+    return header.num_goals;
+}
+
+FactPair BinaryRootTask::get_goal_fact(int index) const {
+    assert(index >= 0 && index < header.num_goals);
+    return goals[index];
+}
+
+vector<int> BinaryRootTask::get_initial_state_values() const {
+    return initial_state_values;
+}
+
+void BinaryRootTask::convert_state_values(
+    vector<int> &, const AbstractTask *ancestor_task) const {
+    if (this != ancestor_task) {
+        ABORT("Invalid state conversion");
+    }
+}
+
+
+template<typename T>
+static void write_array(ostream &out, const vector<T> &values) {
+    out.write(reinterpret_cast<const char *>(values.data()),
+              values.size() * sizeof(T));
+}
+
+void write_binary_task(
+    const AbstractTask &task,
+    const vector<int> &mutex_offsets,
+    const vector<FactPair> &mutex_facts,
+    ostream &out) {
+    int num_variables = task.get_num_variables();
+    int num_operators = task.get_num_operators();
+    int num_axioms = task.get_num_axioms();
+
+    vector<int> domain_sizes;
+    vector<int> axiom_layers;
+    vector<int> fact_offsets = {0};
+    vector<int> default_axiom_values;
+    vector<int> name_offsets = {0};
+    string names;
+    auto add_name = [&](const string &name) {
+            names += name;
+            name_offsets.push_back(names.size());
+        };
+    for (int var = 0; var < num_variables; ++var) {
+        domain_sizes.push_back(task.get_variable_domain_size(var));
+        axiom_layers.push_back(task.get_variable_axiom_layer(var));
+        fact_offsets.push_back(fact_offsets.back() + domain_sizes.back());
+        default_axiom_values.push_back(task.get_variable_default_axiom_value(var));
+        add_name(task.get_variable_name(var));
+    }
+    for (int var = 0; var < num_variables; ++var) {
+        for (int value = 0; value < domain_sizes[var]; ++value)
+            add_name(task.get_fact_name(FactPair(var, value)));
+    }
+    for (int op = 0; op < num_operators; ++op)
+        add_name(task.get_operator_name(op, false));
+
+    vector<FactPair> goals;
+    for (int i = 0; i < task.get_num_goals(); ++i)
+        goals.push_back(task.get_goal_fact(i));
+
+    vector<int> costs;
+    vector<int> precondition_offsets = {0};
+    vector<FactPair> preconditions;
+    vector<int> effect_offsets = {0};
+    vector<FactPair> effects;
+    vector<int> effect_condition_offsets = {0};
+    vector<FactPair> effect_conditions;
+    for (int index = 0; index < num_operators + num_axioms; ++index) {
+        bool is_axiom = (index >= num_operators);
+        int op = is_axiom ? index - num_operators : index;
+        costs.push_back(task.get_operator_cost(op, is_axiom));
+        int num_preconditions = task.get_num_operator_preconditions(op, is_axiom);
+        for (int i = 0; i < num_preconditions; ++i)
+            preconditions.push_back(task.get_operator_precondition(op, i, is_axiom));
+        precondition_offsets.push_back(preconditions.size());
+        int num_effects = task.get_num_operator_effects(op, is_axiom);
+        for (int eff = 0; eff < num_effects; ++eff) {
+            effects.push_back(task.get_operator_effect(op, eff, is_axiom));
+            int num_conditions =
+                task.get_num_operator_effect_conditions(op, eff, is_axiom);
+            for (int i = 0; i < num_conditions; ++i) {
+                effect_conditions.push_back(
+                    task.get_operator_effect_condition(op, eff, i, is_axiom));
+            }
+            effect_condition_offsets.push_back(effect_conditions.size());
+        }
+        effect_offsets.push_back(effects.size());
+    }
+
+    assert(static_cast<int>(mutex_offsets.size()) == fact_offsets.back() + 1);
+    assert(mutex_offsets.back() == static_cast<int>(mutex_facts.size()));
+
+    BinaryTaskHeader header;
+    memcpy(header.magic, BINARY_TASK_MAGIC, sizeof(BINARY_TASK_MAGIC));
+    header.version = BINARY_TASK_VERSION;
+    header.byte_order_mark = BYTE_ORDER_MARK;
+    header.num_variables = num_variables;
+    header.num_facts = fact_offsets.back();
+    header.num_goals = goals.size();
+    header.num_operators = num_operators;
+    header.num_axioms = num_axioms;
+    header.num_preconditions = preconditions.size();
+    header.num_effects = effects.size();
+    header.num_effect_conditions = effect_conditions.size();
+    header.num_mutexes = mutex_facts.size();
+    header.num_name_bytes = names.size();
+
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    write_array(out, domain_sizes);
+    write_array(out, axiom_layers);
+    write_array(out, fact_offsets);
+    write_array(out, default_axiom_values);
+    write_array(out, goals);
+    write_array(out, costs);
+    write_array(out, precondition_offsets);
+    write_array(out, preconditions);
+    write_array(out, effect_offsets);
+    write_array(out, effects);
+    write_array(out, effect_condition_offsets);
+    write_array(out, effect_conditions);
+    write_array(out, mutex_offsets);
+    write_array(out, mutex_facts);
+    write_array(out, name_offsets);
+    out.write(names.data(), names.size());
+}
+
+shared_ptr<AbstractTask> read_binary_task(istream &in) {
+    unique_ptr<TaskFileContents> contents =
+        utils::make_unique_ptr<TaskFileContents>(in);
+    if (contents->is_mapped())
+        cout << "Mapped binary task file into memory." << endl;
+    return make_shared<BinaryRootTask>(move(contents));
+}
+}
@@ -0,0 +1,91 @@
+#ifndef TASKS_BINARY_ROOT_TASK_H
+#define TASKS_BINARY_ROOT_TASK_H
+
+#include "../abstract_task.h"
+
+#include <iostream>
+#include <memory>
+#include <vector>
+
+namespace tasks {
+/*
+  Binary task files contain the same information as the translator output,
+  but in a layout that the planner can use directly after mapping the file
+  into memory, without parsing it. Names of variables, facts and operators
+  are only read (and thus paged in) when they are requested, e.g., when a
+  plan is written.
+
+  The file starts with the 8 bytes of BINARY_TASK_MAGIC, followed by
+  32-bit integers in native byte order: the format version, a byte order
+  mark (0x01020304), and the sizes listed in BinaryTaskHeader. After the
+  header come these arrays of 32-bit integers, where facts are stored as
+  pairs (var, value) and operators and axioms share one index space in
+  which axiom i has index num_operators + i:
+
+    domain sizes, axiom layers            [num_variables] each
+    first fact index of every variable    [num_variables + 1]
+    initial state before evaluating axioms [num_variables]
+    goal facts                            [num_goals]
+    operator costs                        [num_operators + num_axioms]
+    first precondition of every operator  [num_operators + num_axioms + 1]
+    preconditions                         [num_preconditions]
+    first effect of every operator        [num_operators + num_axioms + 1]
+    effect facts                          [num_effects]
+    first condition of every effect       [num_effects + 1]
+    effect conditions                     [num_effect_conditions]
+    first mutex of every fact             [num_facts + 1]
+    facts mutex with each fact, sorted    [num_mutexes]
+    first byte of every name              [num_variables + num_facts
+                                           + num_operators + 1]
+
+  The file ends with the names (variables, then facts, then operators) as
+  consecutive characters without separators. Axioms have no names, as
+  in the translator output, and are all called "<axiom>".
+
+  Binary task files are written by the translator if it is called with
+  --binary-task, or created from translator output with
+    downward --write-binary-task FILENAME < output.sas
+  and are read from standard input like translator output.
+  src/translate/sas_tasks.py must write the same layout.
+*/
+const char BINARY_TASK_MAGIC[8] = {'\x7f', 'F', 'D', 'T', 'A', 'S', 'K', '\n'};
+const int BINARY_TASK_VERSION = 1;
+
+struct BinaryTaskHeader {
+    char magic[8];
+    int version;
+    int byte_order_mark;
+    int num_variables;
+    int num_facts;
+    int num_goals;
+    int num_operators;
+    int num_axioms;
+    int num_preconditions;
+    int num_effects;
+    int num_effect_conditions;
+    int num_mutexes;
+    int num_name_bytes;
+};
+
+/*
+  Write the task in binary format. Since tasks can only answer mutex
+  queries for pairs of facts, the mutexes are passed separately in the
+  format of the file: the facts of other variables that are mutex with
+  the i-th fact, sorted and without duplicates, are mutex_facts[j] for
+  mutex_offsets[i] <= j < mutex_offsets[i + 1].
+*/
+extern void write_binary_task(
+    const AbstractTask &task,
+    const std::vector<int> &mutex_offsets,
+    const std::vector<FactPair> &mutex_facts,
+    std::ostream &out);
+
+/*
+  Read a task in binary format. If "in" is std::cin and standard input is
+  a regular file, the file is mapped into memory. Otherwise, the stream
+  is read into a buffer.
+*/
+extern std::shared_ptr<AbstractTask> read_binary_task(std::istream &in);
+}
+
+#endif
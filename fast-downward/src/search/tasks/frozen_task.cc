@@ -0,0 +1,97 @@
+#include "frozen_task.h"
+
+#include "../option_parser.h"
+#include "../plugin.h"
+
+using namespace std;
+
+namespace tasks {
+FrozenTask::FrozenTask(const shared_ptr<AbstractTask> &parent)
+    : DelegatingTask(parent),
+      num_operators(parent->get_num_operators()) {
+    int num_variables = parent->get_num_variables();
+    domain_sizes.reserve(num_variables);
+    axiom_layers.reserve(num_variables);
+    default_axiom_values.reserve(num_variables);
+    for (int var = 0; var < num_variables; ++var) {
+        domain_sizes.push_back(parent->get_variable_domain_size(var));
+        axiom_layers.push_back(parent->get_variable_axiom_layer(var));
+        default_axiom_values.push_back(parent->get_variable_default_axiom_value(var));
+    }
+
+    int num_goals = parent->get_num_goals();
+    goals.reserve(num_goals);
+    for (int i = 0; i < num_goals; ++i)
+        goals.push_back(parent->get_goal_fact(i));
+    initial_state_values = parent->get_initial_state_values();
+
+    int num_axioms = parent->get_num_axioms();
+    int num_operators_and_axioms = num_operators + num_axioms;
+    costs.reserve(num_operators_and_axioms);
+    precondition_offsets.reserve(num_operators_and_axioms + 1);
+    effect_offsets.reserve(num_operators_and_axioms + 1);
+    precondition_offsets.push_back(0);
+    effect_offsets.push_back(0);
+    effect_condition_offsets.push_back(0);
+    for (int index = 0; index < num_operators_and_axioms; ++index) {
+        bool is_axiom = (index >= num_operators);
+        int op = is_axiom ? index - num_operators : index;
+        costs.push_back(parent->get_operator_cost(op, is_axiom));
+        int num_preconditions = parent->get_num_operator_preconditions(op, is_axiom);
+        for (int i = 0; i < num_preconditions; ++i)
+            preconditions.push_back(parent->get_operator_precondition(op, i, is_axiom));
+        precondition_offsets.push_back(preconditions.size());
+        int num_effects = parent->get_num_operator_effects(op, is_axiom);
+        for (int eff = 0; eff < num_effects; ++eff) {
+            effects.push_back(parent->get_operator_effect(op, eff, is_axiom));
+            int num_conditions =
+                parent->get_num_operator_effect_conditions(op, eff, is_axiom);
+            for (int i = 0; i < num_conditions; ++i) {
+                effect_conditions.push_back(
+                    parent->get_operator_effect_condition(op, eff, i, is_axiom));
+            }
+            effect_condition_offsets.push_back(effect_conditions.size());
+        }
+        effect_offsets.push_back(effects.size());
+    }
+    preconditions.shrink_to_fit();
+    effects.shrink_to_fit();
+    effect_condition_offsets.shrink_to_fit();
+    effect_conditions.shrink_to_fit();
+}
+
+shared_ptr<AbstractTask> get_frozen_task(const shared_ptr<AbstractTask> &task) {
+    if (dynamic_cast<DelegatingTask *>(task.get()) &&
+        !dynamic_cast<FrozenTask *>(task.get())) {
+        return make_shared<FrozenTask>(task);
+    }
+    return task;
+}
+
+shared_ptr<FrozenTask> freeze_task(const shared_ptr<AbstractTask> &task) {
+    shared_ptr<FrozenTask> frozen_task = dynamic_pointer_cast<FrozenTask>(task);
+    if (!frozen_task)
+        frozen_task = make_shared<FrozenTask>(task);
+    return frozen_task;
+}
+
+
+static shared_ptr<AbstractTask> _parse(OptionParser &parser) {
+    parser.document_synopsis(
+        "Frozen task",
+        "Copy of a transformed task in flat arrays. Use this around "
+        "task transformations to speed up heuristics that access the "
+        "operators of their task many times. Names and mutexes are still "
+        "computed by the transformed task.");
+    parser.add_option<shared_ptr<AbstractTask>>(
+        "transform",
+        "task transformation to freeze",
+        "no_transform()");
+    Options opts = parser.parse();
+    if (parser.dry_run())
+        return nullptr;
+    return get_frozen_task(opts.get<shared_ptr<AbstractTask>>("transform"));
+}
+
+static Plugin<AbstractTask> _plugin("frozen", _parse);
+}
@@ -0,0 +1,198 @@
+#ifndef TASKS_FROZEN_TASK_H
+#define TASKS_FROZEN_TASK_H
+
+#include "delegating_task.h"
+
+#include <cassert>
+#include <memory>
+#include <vector>
+
+namespace tasks {
+// Contiguous range of facts stored in a FrozenTask.
+class FactPairRange {
+    const FactPair *first;
+    const FactPair *last;
+public:
+    FactPairRange(const FactPair *first, const FactPair *last)
+        : first(first), last(last) {
+    }
+
+    const FactPair *begin() const {
+        return first;
+    }
+
+    const FactPair *end() const {
+        return last;
+    }
+
+    int size() const {
+        return last - first;
+    }
+
+    const FactPair &operator[](int index) const {
+        assert(index >= 0 && index < size());
+        return first[index];
+    }
+};
+
+/*
+  Copy of the variables, operators, axioms, goals and initial state of a
+  task in flat arrays. Task transformations compute these values on every
+  call, often through a chain of DelegatingTasks, so code that accesses
+  the operators of a transformed task many times, like the construction
+  of abstraction heuristics, should use the frozen task instead.
+
+  Access through TaskProxy costs a single virtual call. Code that knows
+  that it works on a FrozenTask, like the CEGAR refinement loop, can use
+  the range accessors below, and since the class is final, its other
+  accessors are not virtual either when called on a FrozenTask. Names
+  and mutexes are still requested from the parent task, and the frozen
+  task has the same operator IDs and states as its parent.
+*/
+class FrozenTask final : public DelegatingTask {
+    std::vector<int> domain_sizes;
+    std::vector<int> axiom_layers;
+    std::vector<int> default_axiom_values;
+    std::vector<FactPair> goals;
+    std::vector<int> initial_state_values;
+    int num_operators;
+    /*
+      Operators and axioms share one index space in which axiom i has
+      index num_operators + i. The preconditions of the operator with
+      index i are preconditions[precondition_offsets[i]], ...,
+      preconditions[precondition_offsets[i + 1] - 1], and analogously for
+      effects and effect conditions.
+    */
+    std::vector<int> costs;
+    std::vector<int> precondition_offsets;
+    std::vector<FactPair> preconditions;
+    std::vector<int> effect_offsets;
+    std::vector<FactPair> effects;
+    std::vector<int> effect_condition_offsets;
+    std::vector<FactPair> effect_conditions;
+
+    int get_index(int index, bool is_axiom) const {
+        assert(index >= 0 &&
+               index < (is_axiom ? get_num_axioms() : num_operators));
+        return is_axiom ? num_operators + index : index;
+    }
+
+    int get_effect_index(int op_index, int eff_index, bool is_axiom) const {
+        int index = get_index(op_index, is_axiom);
+        assert(eff_index >= 0 &&
+               eff_index < effect_offsets[index + 1] - effect_offsets[index]);
+        return effect_offsets[index] + eff_index;
+    }
+
+public:
+    explicit FrozenTask(const std::shared_ptr<AbstractTask> &parent);
+
+    FactPairRange get_preconditions(int op_index, bool is_axiom) const {
+        int index = get_index(op_index, is_axiom);
+        return FactPairRange(preconditions.data() + precondition_offsets[index],
+                             preconditions.data() + precondition_offsets[index + 1]);
+    }
+
+    FactPairRange get_effect_facts(int op_index, bool is_axiom) const {
+        int index = get_index(op_index, is_axiom);
+        return FactPairRange(effects.data() + effect_offsets[index],
+                             effects.data() + effect_offsets[index + 1]);
+    }
+
+    FactPairRange get_effect_conditions(
+        int op_index, int eff_index, bool is_axiom) const {
+        int effect = get_effect_index(op_index, eff_index, is_axiom);
+        return FactPairRange(
+            effect_conditions.data() + effect_condition_offsets[effect],
+            effect_conditions.data() + effect_condition_offsets[effect + 1]);
+    }
+
+    virtual int get_num_variables() const override {
+        return domain_sizes.size();
+    }
+
+    virtual int get_variable_domain_size(int var) const override {
+        return domain_sizes[var];
+    }
+
+    virtual int get_variable_axiom_layer(int var) const override {
+        return axiom_layers[var];
+    }
+
+    virtual int get_variable_default_axiom_value(int var) const override {
+        return default_axiom_values[var];
+    }
+
+    virtual int get_operator_cost(int index, bool is_axiom) const override {
+        return costs[get_index(index, is_axiom)];
+    }
+
+    virtual int get_num_operators() const override {
+        return num_operators;
+    }
+
+    virtual int get_num_operator_preconditions(
+        int index, bool is_axiom) const override {
+        return get_preconditions(index, is_axiom).size();
+    }
+
+    virtual FactPair get_operator_precondition(
+        int op_index, int fact_index, bool is_axiom) const override {
+        return get_preconditions(op_index, is_axiom)[fact_index];
+    }
+
+    virtual int get_num_operator_effects(
+        int op_index, bool is_axiom) const override {
+        return get_effect_facts(op_index, is_axiom).size();
+    }
+
+    virtual int get_num_operator_effect_conditions(
+        int op_index, int eff_index, bool is_axiom) const override {
+        return get_effect_conditions(op_index, eff_index, is_axiom).size();
+    }
+
+    virtual FactPair get_operator_effect_condition(
+        int op_index, int eff_index, int cond_index, bool is_axiom) const override {
+        return get_effect_conditions(op_index, eff_index, is_axiom)[cond_index];
+    }
+
+    virtual FactPair get_operator_effect(
+        int op_index, int eff_index, bool is_axiom) const override {
+        return effects[get_effect_index(op_index, eff_index, is_axiom)];
+    }
+
+    virtual int get_num_axioms() const override {
+        return costs.size() - num_operators;
+    }
+
+    virtual int get_num_goals() const override {
+        return goals.size();
+    }
+
+    virtual FactPair get_goal_fact(int index) const override {
+        return goals[index];
+    }
+
+    virtual std::vector<int> get_initial_state_values() const override {
+        return initial_state_values;
+    }
+};
+
+/*
+  Return a frozen copy of the task if it is a task transformation. The
+  root task and frozen tasks already store their data explicitly and are
+  returned unchanged.
+*/
+extern std::shared_ptr<AbstractTask> get_frozen_task(
+    const std::shared_ptr<AbstractTask> &task);
+
+/*
+  Return the task if it is a frozen task and a frozen copy of it
+  otherwise, also for the root task. Use this instead of
+  get_frozen_task() to access the task through FrozenTask.
+*/
+extern std::shared_ptr<FrozenTask> freeze_task(
+    const std::shared_ptr<AbstractTask> &task);
+}
+
+#endif
@@ -1,5 +1,7 @@
 #include "root_task.h"
 
+#include "binary_root_task.h"
+
 #include "../option_parser.h"
 #include "../plugin.h"
 #include "../state_registry.h"
@@ -10,7 +12,6 @@
 #include <algorithm>
 #include <cassert>
 #include <memory>
-#include <set>
 #include <unordered_set>
 #include <vector>
 
@@ -20,6 +21,8 @@ using utils::ExitCode;
 
 namespace tasks {
 static const int PRE_FILE_VERSION = 3;
+// Use a mutex matrix for tasks with at most 2^23 pairs of facts (1 MiB).
+static const long long MAX_MUTEX_MATRIX_BITS = 1LL << 23;
 shared_ptr<AbstractTask> g_root_task = nullptr;
 
 struct ExplicitVariable {
@@ -55,8 +58,21 @@ struct ExplicitOperator {
 
 class RootTask : public AbstractTask {
     vector<ExplicitVariable> variables;
-    // TODO: think about using hash sets here.
-    vector<vector<set<FactPair>>> mutexes;
+    // Fact (var, value) has the ID fact_offsets[var] + value.
+    vector<int> fact_offsets;
+    /*
+      The facts of other variables that are mutex with the fact with ID f
+      are stored in sorted order in mutex_facts, from position
+      mutex_offsets[f] to mutex_offsets[f + 1] - 1.
+    */
+    vector<int> mutex_offsets;
+    vector<FactPair> mutex_facts;
+    /*
+      For tasks with few facts, we also store the mutexes as a matrix in
+      which the bit at position f1 * num_facts + f2 tells if the facts with
+      IDs f1 and f2 are mutex. Otherwise, this is empty.
+    */
+    vector<bool> mutex_matrix;
     vector<ExplicitOperator> operators;
     vector<ExplicitOperator> axioms;
     vector<int> initial_state_values;
@@ -65,10 +81,13 @@ class RootTask : public AbstractTask {
     const ExplicitVariable &get_variable(int var) const;
     const ExplicitEffect &get_effect(int op_id, int effect_id, bool is_axiom) const;
     const ExplicitOperator &get_operator_or_axiom(int index, bool is_axiom) const;
+    void set_mutexes(const vector<vector<FactPair>> &mutex_groups);
 
 public:
     explicit RootTask(istream &in);
 
+    void write_binary(ostream &out) const;
+
     virtual int get_num_variables() const override;
     virtual string get_variable_name(int var) const override;
     virtual int get_variable_domain_size(int var) const override;
@@ -251,26 +270,14 @@ vector<ExplicitVariable> read_variables(istream &in) {
     return variables;
 }
 
-vector<vector<set<FactPair>>> read_mutexes(istream &in, const vector<ExplicitVariable> &variables) {
-    vector<vector<set<FactPair>>> inconsistent_facts(variables.size());
-    for (size_t i = 0; i < variables.size(); ++i)
-        inconsistent_facts[i].resize(variables[i].domain_size);
-
+vector<vector<FactPair>> read_mutexes(istream &in, const vector<ExplicitVariable> &variables) {
     int num_mutex_groups;
     in >> num_mutex_groups;
-
-    /*
-      NOTE: Mutex groups can overlap, in which case the same mutex
-      should not be represented multiple times. The current
-      representation takes care of that automatically by using sets.
-      If we ever change this representation, this is something to be
-      aware of.
-    */
-    for (int i = 0; i < num_mutex_groups; ++i) {
+    vector<vector<FactPair>> mutex_groups(num_mutex_groups);
+    for (vector<FactPair> &invariant_group : mutex_groups) {
         check_magic(in, "begin_mutex_group");
         int num_facts;
         in >> num_facts;
-        vector<FactPair> invariant_group;
         invariant_group.reserve(num_facts);
         for (int j = 0; j < num_facts; ++j) {
             int var;
@@ -279,25 +286,9 @@ vector<vector<set<FactPair>>> read_mutexes(istream &in, const vector<ExplicitVar
             invariant_group.emplace_back(var, value);
         }
         check_magic(in, "end_mutex_group");
-        for (const FactPair &fact1 : invariant_group) {
-            for (const FactPair &fact2 : invariant_group) {
-                if (fact1.var != fact2.var) {
-                    /* The "different variable" test makes sure we
-                       don't mark a fact as mutex with itself
-                       (important for correctness) and don't include
-                       redundant mutexes (important to conserve
-                       memory). Note that the translator (at least
-                       with default settings) removes mutex groups
-                       that contain *only* redundant mutexes, but it
-                       can of course generate mutex groups which lead
-                       to *some* redundant mutexes, where some but not
-                       all facts talk about the same variable. */
-                    inconsistent_facts[fact1.var][fact1.value].insert(fact2);
-                }
-            }
-        }
+        check_facts(invariant_group, variables);
     }
-    return inconsistent_facts;
+    return mutex_groups;
 }
 
 vector<FactPair> read_goal(istream &in) {
@@ -331,7 +322,7 @@ RootTask::RootTask(istream &in) {
     variables = read_variables(in);
     int num_variables = variables.size();
 
-    mutexes = read_mutexes(in, variables);
+    set_mutexes(read_mutexes(in, variables));
 
     initial_state_values.resize(num_variables);
     check_magic(in, "begin_state");
@@ -359,6 +350,92 @@ RootTask::RootTask(istream &in) {
     axiom_evaluator.evaluate(initial_state_values);
 }
 
+void RootTask::write_binary(ostream &out) const {
+    write_binary_task(*this, mutex_offsets, mutex_facts, out);
+}
+
+void RootTask::set_mutexes(const vector<vector<FactPair>> &mutex_groups) {
+    int num_variables = variables.size();
+    fact_offsets.resize(num_variables);
+    int num_facts = 0;
+    for (int var = 0; var < num_variables; ++var) {
+        fact_offsets[var] = num_facts;
+        num_facts += variables[var].domain_size;
+    }
+
+    /*
+      First count the number of mutexes per fact to reserve the ranges in
+      mutex_facts, then fill the ranges, and finally sort them and remove
+      duplicates.
+
+      We only store mutexes between facts of different variables. This
+      makes sure we don't mark a fact as mutex with itself (important for
+      correctness) and don't include redundant mutexes (important to
+      conserve memory). Note that the translator (at least with default
+      settings) removes mutex groups that contain *only* redundant
+      mutexes, but it can of course generate mutex groups which lead to
+      *some* redundant mutexes, where some but not all facts talk about
+      the same variable.
+
+      Mutex groups can overlap, in which case the same mutex occurs in
+      several groups. Removing duplicates takes care of that.
+    */
+    vector<int> num_mutexes(num_facts + 1, 0);
+    for (const vector<FactPair> &group : mutex_groups) {
+        for (const FactPair &fact1 : group) {
+            int &count = num_mutexes[fact_offsets[fact1.var] + fact1.value];
+            for (const FactPair &fact2 : group) {
+                if (fact1.var != fact2.var)
+                    ++count;
+            }
+        }
+    }
+    vector<int> next_positions(num_facts + 1, 0);
+    for (int fact = 0; fact < num_facts; ++fact)
+        next_positions[fact + 1] = next_positions[fact] + num_mutexes[fact];
+    vector<int> range_starts = next_positions;
+    mutex_facts.assign(next_positions[num_facts], FactPair::no_fact);
+    for (const vector<FactPair> &group : mutex_groups) {
+        for (const FactPair &fact1 : group) {
+            int &pos = next_positions[fact_offsets[fact1.var] + fact1.value];
+            for (const FactPair &fact2 : group) {
+                if (fact1.var != fact2.var)
+                    mutex_facts[pos++] = fact2;
+            }
+        }
+    }
+
+    mutex_offsets.assign(num_facts + 1, 0);
+    int num_unique_mutexes = 0;
+    for (int fact = 0; fact < num_facts; ++fact) {
+        auto begin = mutex_facts.begin() + range_starts[fact];
+        auto end = mutex_facts.begin() + range_starts[fact + 1];
+        sort(begin, end);
+        end = unique(begin, end);
+        /*
+          Shift the range to the end of the previous one. The ranges can
+          overlap, so we copy element by element from front to back.
+        */
+        for (auto it = begin; it != end; ++it)
+            mutex_facts[num_unique_mutexes++] = *it;
+        mutex_offsets[fact + 1] = num_unique_mutexes;
+    }
+    mutex_facts.erase(mutex_facts.begin() + num_unique_mutexes, mutex_facts.end());
+    mutex_facts.shrink_to_fit();
+
+    mutex_matrix.clear();
+    if (static_cast<long long>(num_facts) * num_facts <= MAX_MUTEX_MATRIX_BITS) {
+        mutex_matrix.resize(num_facts * num_facts, false);
+        for (int fact1 = 0; fact1 < num_facts; ++fact1) {
+            for (int i = mutex_offsets[fact1]; i < mutex_offsets[fact1 + 1]; ++i) {
+                const FactPair &fact2 = mutex_facts[i];
+                int fact2_id = fact_offsets[fact2.var] + fact2.value;
+                mutex_matrix[fact1 * num_facts + fact2_id] = true;
+            }
+        }
+    }
+}
+
 const ExplicitVariable &RootTask::get_variable(int var) const {
     assert(utils::in_bounds(var, variables));
     return variables[var];
@@ -412,9 +489,16 @@ bool RootTask::are_facts_mutex(const FactPair &fact1, const FactPair &fact2) con
         // Same variable: mutex iff different value.
         return fact1.value != fact2.value;
     }
-    assert(utils::in_bounds(fact1.var, mutexes));
-    assert(utils::in_bounds(fact1.value, mutexes[fact1.var]));
-    return bool(mutexes[fact1.var][fact1.value].count(fact2));
+    assert(utils::in_bounds(fact1.value, get_variable(fact1.var).fact_names));
+    assert(utils::in_bounds(fact2.value, get_variable(fact2.var).fact_names));
+    int fact1_id = fact_offsets[fact1.var] + fact1.value;
+    if (!mutex_matrix.empty()) {
+        int num_facts = mutex_offsets.size() - 1;
+        return mutex_matrix[fact1_id * num_facts + fact_offsets[fact2.var] + fact2.value];
+    }
+    return binary_search(mutex_facts.begin() + mutex_offsets[fact1_id],
+                         mutex_facts.begin() + mutex_offsets[fact1_id + 1],
+                         fact2);
 }
 
 int RootTask::get_operator_cost(int index, bool is_axiom) const {
@@ -495,7 +579,14 @@ void RootTask::convert_state_values(
 
 void read_root_task(istream &in) {
     assert(!g_root_task);
-    g_root_task = make_shared<RootTask>(in);
+    if (in.peek() == BINARY_TASK_MAGIC[0])
+        g_root_task = read_binary_task(in);
+    else
+        g_root_task = make_shared<RootTask>(in);
+}
+
+void write_binary_root_task(istream &in, ostream &out) {
+    RootTask(in).write_binary(out);
 }
 
 static shared_ptr<AbstractTask> _parse(OptionParser &parser) {
@@ -5,6 +5,12 @@
 
 namespace tasks {
 extern std::shared_ptr<AbstractTask> g_root_task;
+/*
+  Read the task from translator output or from a binary task file (see
+  binary_root_task.h), detected by the first byte of the input.
+*/
 extern void read_root_task(std::istream &in);
+// Convert translator output to a binary task file.
+extern void write_binary_root_task(std::istream &in, std::ostream &out);
 }
 #endif
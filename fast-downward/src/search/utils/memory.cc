@@ -1,19 +1,37 @@
 #include "memory.h"
 
+#include "language.h"
+
+#include <atomic>
 #include <cassert>
 #include <iostream>
 
 using namespace std;
 
 namespace utils {
-static char *extra_memory_padding = nullptr;
+static atomic<char *> extra_memory_padding(nullptr);
 
 // Save standard out-of-memory handler.
 static void (*standard_out_of_memory_handler)() = nullptr;
 
+/*
+  Several threads may run out of memory at the same time. Only the
+  first of them actually releases the padding.
+*/
+static bool release_extra_memory_padding_if_reserved() {
+    char *padding = extra_memory_padding.exchange(nullptr);
+    if (!padding)
+        return false;
+    delete[] padding;
+    assert(standard_out_of_memory_handler);
+    set_new_handler(standard_out_of_memory_handler);
+    return true;
+}
+
 void continuing_out_of_memory_handler() {
-    release_extra_memory_padding();
-    cout << "Failed to allocate memory. Released extra memory padding." << endl;
+    if (release_extra_memory_padding_if_reserved()) {
+        cout << "Failed to allocate memory. Released extra memory padding." << endl;
+    }
 }
 
 void reserve_extra_memory_padding(int memory_in_mb) {
@@ -23,14 +41,12 @@ void reserve_extra_memory_padding(int memory_in_mb) {
 }
 
 void release_extra_memory_padding() {
-    assert(extra_memory_padding);
-    delete[] extra_memory_padding;
-    extra_memory_padding = nullptr;
-    assert(standard_out_of_memory_handler);
-    set_new_handler(standard_out_of_memory_handler);
+    bool released = release_extra_memory_padding_if_reserved();
+    assert(released);
+    unused_variable(released);
 }
 
 bool extra_memory_padding_is_reserved() {
-    return extra_memory_padding;
+    return extra_memory_padding.load() != nullptr;
 }
 }
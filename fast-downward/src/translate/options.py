@@ -28,6 +28,10 @@ def parse_args():
     argparser.add_argument(
         "--sas-file", default="output.sas",
         help="path to the SAS output file (default: %(default)s)")
+    argparser.add_argument(
+        "--binary-task", action="store_true",
+        help="write the SAS output file in the binary task format, which "
+        "the search component maps into memory instead of parsing it")
     argparser.add_argument(
         "--invariant-generation-max-time", default=300, type=int,
         help="max time for invariant generation (default: %(default)ds)")
@@ -1,7 +1,13 @@
+from array import array
 from typing import List, Tuple
 
 SAS_FILE_VERSION = 3
 
+# See src/search/tasks/binary_root_task.h for the binary task format.
+BINARY_TASK_MAGIC = b"\x7fFDTASK\n"
+BINARY_TASK_VERSION = 1
+BINARY_TASK_BYTE_ORDER_MARK = 0x01020304
+
 DEBUG = False
 
 VarValPair = Tuple[int, int]
@@ -104,6 +110,95 @@ class SASTask:
         for axiom in self.axioms:
             axiom.output(stream)
 
+    def output_binary(self, stream):
+        """Write the task in the binary format of the search component.
+
+        The search component reads the file exactly as it reads the
+        text written by output(). In particular, axioms get their
+        effect variable's other value as an additional precondition,
+        operators cost 1 without metric, and the facts mutex with a
+        fact are those of other variables in a common mutex group."""
+        num_variables = len(self.variables.ranges)
+        fact_offsets = [0]
+        for rang in self.variables.ranges:
+            fact_offsets.append(fact_offsets[-1] + rang)
+        num_facts = fact_offsets[-1]
+
+        names = ["var%d" % var for var in range(num_variables)]
+        for values in self.variables.value_names:
+            names.extend(str(value) for value in values)
+        names.extend(op.name[1:-1] for op in self.operators)
+        name_bytes = [name.encode("utf-8") for name in names]
+        name_offsets = [0]
+        for name in name_bytes:
+            name_offsets.append(name_offsets[-1] + len(name))
+
+        costs = []
+        precondition_offsets = [0]
+        preconditions = []
+        effect_offsets = [0]
+        effects = []
+        effect_condition_offsets = [0]
+        effect_conditions = []
+        def add_operator(cost, prevail, pre_post):
+            costs.append(cost)
+            preconditions.extend(prevail)
+            for var, pre, post, cond in pre_post:
+                if pre != -1:
+                    preconditions.append((var, pre))
+                effects.append((var, post))
+                effect_conditions.extend(cond)
+                effect_condition_offsets.append(len(effect_conditions))
+            precondition_offsets.append(len(preconditions))
+            effect_offsets.append(len(effects))
+        for op in self.operators:
+            add_operator(op.cost if self.metric else 1, op.prevail,
+                         op.pre_post)
+        for axiom in self.axioms:
+            var, val = axiom.effect
+            add_operator(0, axiom.condition, [(var, 1 - val, val, [])])
+
+        mutexes = [set() for _ in range(num_facts)]
+        for group in self.mutexes:
+            for var1, val1 in group.facts:
+                for var2, val2 in group.facts:
+                    if var1 != var2:
+                        mutexes[fact_offsets[var1] + val1].add((var2, val2))
+        mutex_offsets = [0]
+        mutex_facts = []
+        for facts in mutexes:
+            mutex_facts.extend(sorted(facts))
+            mutex_offsets.append(len(mutex_facts))
+
+        def ints(values):
+            return array("i", values).tobytes()
+        def pairs(facts):
+            return array("i", [x for fact in facts for x in fact]).tobytes()
+
+        stream.write(BINARY_TASK_MAGIC)
+        stream.write(ints([
+            BINARY_TASK_VERSION, BINARY_TASK_BYTE_ORDER_MARK,
+            num_variables, num_facts, len(self.goal.pairs),
+            len(self.operators), len(self.axioms), len(preconditions),
+            len(effects), len(effect_conditions), len(mutex_facts),
+            name_offsets[-1]]))
+        stream.write(ints(self.variables.ranges))
+        stream.write(ints(self.variables.axiom_layers))
+        stream.write(ints(fact_offsets))
+        stream.write(ints(self.init.values))
+        stream.write(pairs(self.goal.pairs))
+        stream.write(ints(costs))
+        stream.write(ints(precondition_offsets))
+        stream.write(pairs(preconditions))
+        stream.write(ints(effect_offsets))
+        stream.write(pairs(effects))
+        stream.write(ints(effect_condition_offsets))
+        stream.write(pairs(effect_conditions))
+        stream.write(ints(mutex_offsets))
+        stream.write(pairs(mutex_facts))
+        stream.write(ints(name_offsets))
+        stream.write(b"".join(name_bytes))
+
     def get_encoding_size(self):
         task_size = 0
         task_size += self.variables.get_encoding_size()
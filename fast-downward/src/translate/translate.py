@@ -719,8 +719,12 @@ def main():
     dump_statistics(sas_task)
 
     with timers.timing("Writing output"):
-        with open(options.sas_file, "w") as output_file:
-            sas_task.output(output_file)
+        if options.binary_task:
+            with open(options.sas_file, "wb") as output_file:
+                sas_task.output_binary(output_file)
+        else:
+            with open(options.sas_file, "w") as output_file:
+                sas_task.output(output_file)
     print("Done! %s" % timer)
 
 